@@ -1115,3 +1115,10 @@ void FEBiphasicFSIDomain3D::Serialize(DumpStream& ar)
     FESolidDomain::Serialize(ar);
     ar & m_sseps & m_btrans;
 }
+
+//-----------------------------------------------------------------------------
+void FEBiphasicFSIDomain3D::SerializeState(DumpStream& ar)
+{
+    FESolidDomain::SerializeState(ar);
+    ar & m_sseps & m_btrans;
+}
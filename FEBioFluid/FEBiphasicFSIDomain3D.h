@@ -56,6 +56,9 @@ public:
     
     //! Serialization
     void Serialize(DumpStream& ar) override;
+
+    //! Serialize the shallow state (used by the solution snapshots)
+    void SerializeState(DumpStream& ar) override;
     
     // get the total dof
     const FEDofList& GetDOFList() const override;
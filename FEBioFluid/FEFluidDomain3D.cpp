@@ -36,6 +36,7 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioFluid.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEScratch.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -141,9 +142,11 @@ void FEFluidDomain3D::InternalForces(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // element force vector (from the scratch pool of this thread)
+        FEScratch< vector<double> > pfe;
+        FEScratch< vector<int> > plm;
+        vector<double>& fe = pfe;
+        vector<int>& lm = plm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -240,8 +243,10 @@ void FEFluidDomain3D::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
     int NE = (int)m_Elem.size();
     for (int i=0; i<NE; ++i)
     {
-        vector<double> fe;
-        vector<int> lm;
+        FEScratch< vector<double> > pfe;
+        FEScratch< vector<int> > plm;
+        vector<double>& fe = pfe;
+        vector<int>& lm = plm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -465,7 +470,9 @@ void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEScratch<FEElementMatrix> pke;
+        FEElementMatrix& ke = pke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
@@ -476,7 +483,8 @@ void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS)
         ElementStiffness(el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -497,7 +505,9 @@ void FEFluidDomain3D::MassMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-		FEElementMatrix ke(el);
+		FEScratch<FEElementMatrix> pke;
+		FEElementMatrix& ke = pke;
+		ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
@@ -508,7 +518,8 @@ void FEFluidDomain3D::MassMatrix(FELinearSystem& LS)
         ElementMassMatrix(el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -528,7 +539,9 @@ void FEFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 		FESolidElement& el = m_Elem[iel];
 
         // element stiffness matrix
-        FEElementMatrix ke(el);
+        FEScratch<FEElementMatrix> pke;
+        FEElementMatrix& ke = pke;
+        ke.SetNodes(el.m_node);
         
         // create the element's stiffness matrix
         int ndof = 4*el.Nodes();
@@ -539,7 +552,8 @@ void FEFluidDomain3D::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
         ElementBodyForceStiffness(bf, el, ke);
         
         // get the element's LM vector
-		vector<int> lm;
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -721,9 +735,11 @@ void FEFluidDomain3D::InertialForces(FEGlobalVector& R)
 #pragma omp parallel for shared(NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // element force vector (from the scratch pool of this thread)
+        FEScratch< vector<double> > pfe;
+        FEScratch< vector<int> > plm;
+        vector<double>& fe = pfe;
+        vector<int>& lm = plm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -57,20 +57,35 @@ void FEFluidResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<d
     {
         // assemble the element residual into the global residual
         int ndof = (int)fe.size();
-        for (i=0; i<ndof; ++i)
+        double* pR = PartialVector();
+        if (pR)
         {
-            
-            I = elm[i];
-            
-            if ( I >= 0){
-#pragma omp atomic
-                R[I] += fe[i];
+            // buffered assembly: add to the partial vectors of this thread
+            double* pFr = pR + R.size();
+            for (i=0; i<ndof; ++i)
+            {
+                I = elm[i];
+                if (I >= 0) pR[I] += fe[i];
+                else if (-I-2 >= 0) pFr[-I-2] -= fe[i];
             }
-            // TODO: Find another way to store reaction forces
-            
-            else if (-I-2 >= 0){
+        }
+        else
+        {
+            for (i=0; i<ndof; ++i)
+            {
+                
+                I = elm[i];
+                
+                if ( I >= 0){
+#pragma omp atomic
+                    R[I] += fe[i];
+                }
+                // TODO: Find another way to store reaction forces
+                
+                else if (-I-2 >= 0){
 #pragma omp atomic
-                m_Fr[-I-2] -= fe[i];
+                    m_Fr[-I-2] -= fe[i];
+                }
             }
         }
         
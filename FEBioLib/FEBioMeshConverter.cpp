@@ -0,0 +1,79 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBioMeshConverter.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioXML/FEBioImport.h>
+#include <FECore/log.h>
+
+//-----------------------------------------------------------------------------
+FEBioMeshConverter::FEBioMeshConverter(FEModel* fem) : FECoreTask(fem) {}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshConverter::Init(const char* szfile)
+{
+	FEBioModel* fem = dynamic_cast<FEBioModel*>(GetFEModel());
+	if (fem == nullptr) return false;
+
+	if (szfile && szfile[0])
+	{
+		m_meshFile = szfile;
+	}
+	else
+	{
+		// replace the extension of the input file
+		m_meshFile = fem->GetInputFileName();
+		size_t n = m_meshFile.rfind('.');
+		size_t m = m_meshFile.find_last_of("/\\");
+		if ((n != std::string::npos) && ((m == std::string::npos) || (n > m))) m_meshFile.erase(n);
+		m_meshFile += ".febm";
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshConverter::Run()
+{
+	FEBioModel* fem = dynamic_cast<FEBioModel*>(GetFEModel());
+	if (fem == nullptr) return false;
+
+	FEBioImport fim;
+	if (fim.ConvertMesh(*fem, fem->GetInputFileName().c_str(), m_meshFile.c_str()) == false)
+	{
+		char szerr[256];
+		fim.GetErrorMessage(szerr);
+		feLogErrorEx(fem, szerr);
+		return false;
+	}
+
+	feLogEx(fem, "Mesh written to %s\n", m_meshFile.c_str());
+
+	return true;
+}
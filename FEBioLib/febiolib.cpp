@@ -48,6 +48,7 @@ SOFTWARE.*/
 #include "plugin.h"
 #include "FEBioStdSolver.h"
 #include "FEBioRestart.h"
+#include "FEBioMeshConverter.h"
 
 namespace febio {
 
@@ -65,6 +66,7 @@ void InitLibrary()
 	REGISTER_FECORE_CLASS(FEBioRestart  , "restart");
 	REGISTER_FECORE_CLASS(FEBioRCISolver, "rci_solve");
 	REGISTER_FECORE_CLASS(FEBioTestSuiteTask, "test");
+	REGISTER_FECORE_CLASS(FEBioMeshConverter, "convert_mesh");
 
 	FECore::InitModule();
 	FEAMR::InitModule();
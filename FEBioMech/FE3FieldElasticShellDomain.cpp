@@ -609,3 +609,10 @@ void FE3FieldElasticShellDomain::Serialize(DumpStream &ar)
     FEElasticShellDomain::Serialize(ar);
 	ar & m_Data;
 }
+
+//-----------------------------------------------------------------------------
+void FE3FieldElasticShellDomain::SerializeState(DumpStream& ar)
+{
+    FEElasticShellDomain::SerializeState(ar);
+    ar & m_Data;
+}
@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include "FEUncoupledMaterial.h"
 #include <FECore/FEModel.h>
 #include "FECore/log.h"
+#include <FECore/FEScratch.h>
 
 //-----------------------------------------------------------------------------
 BEGIN_FECORE_CLASS(FE3FieldElasticSolidDomain, FEElasticSolidDomain)
@@ -143,7 +144,9 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEScratch<FEElementMatrix> pke;
+		FEElementMatrix& ke = pke;
+		ke.SetNodes(el.m_node);
 
 		// create the element's stiffness matrix
 		int ndof = 3*el.Nodes();
@@ -167,7 +170,8 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 				ke[j][i] = ke[i][j];
 
 		// get the element's LM vector
-		vector<int> lm;
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -659,3 +663,10 @@ void FE3FieldElasticSolidDomain::Serialize(DumpStream &ar)
 	FEElasticSolidDomain::Serialize(ar);
 	ar & m_Data;
 }
+
+//-----------------------------------------------------------------------------
+void FE3FieldElasticSolidDomain::SerializeState(DumpStream& ar)
+{
+	FEElasticSolidDomain::SerializeState(ar);
+	ar & m_Data;
+}
@@ -67,6 +67,9 @@ public:
 
 	//! serialize data to archive
 	void Serialize(DumpStream& ar) override;
+
+	//! serialize the shallow domain data (excluding material points)
+	void SerializeState(DumpStream& ar) override;
     
 public: // overridden from FEElasticDomain
 
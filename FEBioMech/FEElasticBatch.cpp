@@ -0,0 +1,120 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEElasticBatch.h"
+#include "FEElasticMaterialPoint.h"
+#include <math.h>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+void FEElasticBatch::Gather(FEMaterialPoint** mp, int npts)
+{
+	assert(npts <= MAX_POINTS);
+	m_n = npts;
+
+	// copy the deformation gradients into packed arrays
+	double F[9][MAX_POINTS];
+	for (int i = 0; i < npts; ++i)
+	{
+		FEElasticMaterialPoint& pt = *mp[i]->ExtractData<FEElasticMaterialPoint>();
+		const mat3d& Fi = pt.m_F;
+		F[0][i] = Fi[0][0]; F[1][i] = Fi[0][1]; F[2][i] = Fi[0][2];
+		F[3][i] = Fi[1][0]; F[4][i] = Fi[1][1]; F[5][i] = Fi[1][2];
+		F[6][i] = Fi[2][0]; F[7][i] = Fi[2][1]; F[8][i] = Fi[2][2];
+		m_J[i] = pt.m_J;
+	}
+
+	// b = F*Ft
+#pragma omp simd
+	for (int i = 0; i < npts; ++i)
+	{
+		m_b[XX][i] = F[0][i]*F[0][i] + F[1][i]*F[1][i] + F[2][i]*F[2][i];
+		m_b[YY][i] = F[3][i]*F[3][i] + F[4][i]*F[4][i] + F[5][i]*F[5][i];
+		m_b[ZZ][i] = F[6][i]*F[6][i] + F[7][i]*F[7][i] + F[8][i]*F[8][i];
+		m_b[XY][i] = F[0][i]*F[3][i] + F[1][i]*F[4][i] + F[2][i]*F[5][i];
+		m_b[YZ][i] = F[3][i]*F[6][i] + F[4][i]*F[7][i] + F[5][i]*F[8][i];
+		m_b[XZ][i] = F[0][i]*F[6][i] + F[1][i]*F[7][i] + F[2][i]*F[8][i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticBatch::GatherDev(FEMaterialPoint** mp, int npts)
+{
+	Gather(mp, npts);
+
+	// b~ = J^(-2/3)*b
+	for (int i = 0; i < npts; ++i)
+	{
+		double Jm23 = pow(m_J[i], -2.0 / 3.0);
+		for (int k = 0; k < 6; ++k) m_b[k][i] *= Jm23;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticBatch::EvalParam(FEParamDouble& p, FEMaterialPoint** mp, double* v) const
+{
+	if (p.isConst())
+	{
+		double c = p.constValue();
+		for (int i = 0; i < m_n; ++i) v[i] = c;
+	}
+	else
+	{
+		for (int i = 0; i < m_n; ++i) v[i] = p(*mp[i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticBatch::Square(double b2[6][MAX_POINTS]) const
+{
+	const double (*b)[MAX_POINTS] = m_b;
+#pragma omp simd
+	for (int i = 0; i < m_n; ++i)
+	{
+		b2[XX][i] = b[XX][i]*b[XX][i] + b[XY][i]*b[XY][i] + b[XZ][i]*b[XZ][i];
+		b2[YY][i] = b[XY][i]*b[XY][i] + b[YY][i]*b[YY][i] + b[YZ][i]*b[YZ][i];
+		b2[ZZ][i] = b[XZ][i]*b[XZ][i] + b[YZ][i]*b[YZ][i] + b[ZZ][i]*b[ZZ][i];
+		b2[XY][i] = b[XX][i]*b[XY][i] + b[XY][i]*b[YY][i] + b[XZ][i]*b[YZ][i];
+		b2[YZ][i] = b[XY][i]*b[XZ][i] + b[YY][i]*b[YZ][i] + b[YZ][i]*b[ZZ][i];
+		b2[XZ][i] = b[XX][i]*b[XZ][i] + b[XY][i]*b[YZ][i] + b[XZ][i]*b[ZZ][i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticBatch::Det(double* I3) const
+{
+	const double (*b)[MAX_POINTS] = m_b;
+#pragma omp simd
+	for (int i = 0; i < m_n; ++i)
+	{
+		I3[i] = b[XX][i]*(b[YY][i]*b[ZZ][i] - b[YZ][i]*b[YZ][i])
+			  + b[XY][i]*(b[YZ][i]*b[XZ][i] - b[XY][i]*b[ZZ][i])
+			  + b[XZ][i]*(b[XY][i]*b[YZ][i] - b[YY][i]*b[XZ][i]);
+	}
+}
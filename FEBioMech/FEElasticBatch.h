@@ -0,0 +1,72 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/FEModelParam.h>
+#include <FECore/FEElement.h>
+#include "febiomech_api.h"
+
+class FEMaterialPoint;
+
+//-----------------------------------------------------------------------------
+//! Packed kinematics of a batch of elastic material points. 
+//! The batched stress and tangent functions of the elastic materials gather the 
+//! data of their points in these arrays first, so that the per-point arithmetic
+//! runs over contiguous arrays that the compiler can vectorize.
+class FEBIOMECH_API FEElasticBatch
+{
+public:
+	enum { MAX_POINTS = FEElement::MAX_INTPOINTS };
+
+	// component indices of the packed symmetric tensors
+	enum { XX, YY, ZZ, XY, YZ, XZ };
+
+public:
+	//! gather the jacobian and left Cauchy-Green tensor of npts points (npts <= MAX_POINTS)
+	void Gather(FEMaterialPoint** mp, int npts);
+
+	//! same as Gather, but stores the deviatoric left Cauchy-Green tensor
+	void GatherDev(FEMaterialPoint** mp, int npts);
+
+	//! evaluate a material parameter at all points of the batch
+	void EvalParam(FEParamDouble& p, FEMaterialPoint** mp, double* v) const;
+
+	//! calculate the square of the packed left Cauchy-Green tensors
+	void Square(double b2[6][MAX_POINTS]) const;
+
+	//! calculate the determinant of the packed left Cauchy-Green tensors
+	void Det(double* I3) const;
+
+	//! returns the left Cauchy-Green tensor of point i
+	mat3ds LeftCauchyGreen(int i) const { return mat3ds(m_b[XX][i], m_b[YY][i], m_b[ZZ][i], m_b[XY][i], m_b[YZ][i], m_b[XZ][i]); }
+
+public:
+	int		m_n;					//!< number of points in batch
+	double	m_J[MAX_POINTS];		//!< determinant of deformation gradient
+	double	m_b[6][MAX_POINTS];		//!< (deviatoric) left Cauchy-Green tensor
+};
@@ -0,0 +1,60 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/FEIntegrationPointArray.h>
+#include "FEElasticMaterialPoint.h"
+#include "febiomech_api.h"
+
+//-----------------------------------------------------------------------------
+//! Table of the elastic material point data of a domain.
+//! The store keeps a direct pointer to the FEElasticMaterialPoint of each integration
+//! point, laid out contiguously per element, so that the hot loops don't need to search
+//! the material point data list. The FEElasticMaterialPoint remains the owner of the data,
+//! so the store must be rebuilt whenever the domain's material points are reallocated.
+class FEBIOMECH_API FEElasticPointStore
+{
+public:
+	FEElasticPointStore();
+
+	//! build the store for the domain
+	void Create(FEMeshPartition& dom);
+
+	//! clear all data
+	void Clear();
+
+	//! returns true if the store was created
+	bool IsEmpty() const { return (m_pt.Size() == 0); }
+
+public:
+	//! elastic point data of integration point n of element iel
+	FEElasticMaterialPoint* Point(int iel, int n) { return m_pt(iel, n); }
+
+private:
+	FEIntegrationPointArray<FEElasticMaterialPoint*>	m_pt;	//!< elastic point data
+};
@@ -454,31 +454,31 @@ void FEElasticShellDomain::ElementBodyForceStiffness(FEBodyForce& BF, FEShellEle
 
 void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
+	// get the cached scatter maps (if any)
+	FEScatterMap* scatter = LS.GetScatterMaps(this, Elements());
+
     // repeat over all shell elements
-    int NS = (int)m_Elem.size();
-#pragma omp parallel for shared (NS)
-    for (int iel=0; iel<NS; ++iel)
-    {
+	AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
-		if (el.isActive())
-		{
-			// create the element's stiffness matrix
-			FEElementMatrix ke(el);
-			int ndof = 6 * el.Nodes();
-			ke.resize(ndof, ndof);
 
-			// calculate the element stiffness matrix
-			ElementStiffness(iel, ke);
+		// create the element's stiffness matrix
+		FEElementMatrix ke(el);
+		int ndof = 6 * el.Nodes();
+		ke.resize(ndof, ndof);
+		if (scatter) ke.SetScatterMap(scatter + iel);
 
-			// get the element's LM vector
-			vector<int> lm;
-			UnpackLM(el, lm);
-			ke.SetIndices(lm);
+		// calculate the element stiffness matrix
+		ElementStiffness(iel, ke);
 
-			// assemble element matrix in global stiffness matrix
-			LS.Assemble(ke);
-		}
-    }
+		// get the element's LM vector
+		vector<int> lm;
+		UnpackLM(el, lm);
+		ke.SetIndices(lm);
+
+		// assemble element matrix in global stiffness matrix
+		LS.Assemble(ke);
+	});
 }
 
 //-----------------------------------------------------------------------------
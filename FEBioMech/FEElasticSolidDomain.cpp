@@ -37,7 +37,9 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioMech.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEScratch.h>
 #include "FEResidualVector.h"
+#include "FESolidElementKernels.h"
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -53,6 +55,10 @@ FEElasticSolidDomain::FEElasticSolidDomain(FEModel* pfem) : FESolidDomain(pfem),
 	m_secant_stress = false;
 	m_secant_tangent = false;
 
+	m_kernelType = FE_ELEM_INVALID_TYPE;
+	m_upperKe = false;
+	m_scatter = nullptr;
+
 	// TODO: Can this be done in Init, since  there is no error checking
 	if (pfem)
 	{
@@ -117,6 +123,57 @@ void FEElasticSolidDomain::Activate()
 			}
 		}
 	}
+
+	// build the table of elastic point data
+	m_store.Create(*this);
+
+	// pick the element kernels
+	SelectElementKernels();
+}
+
+//-----------------------------------------------------------------------------
+//! The specialized kernels are used when all elements of the domain are of the same
+//! type and that type has kernels. Otherwise, the generic element functions are used.
+void FEElasticSolidDomain::SelectElementKernels()
+{
+	m_kernelType = FE_ELEM_INVALID_TYPE;
+	const int NE = Elements();
+	if (NE == 0) return;
+
+	const int ntype = m_Elem[0].Type();
+	if (FESolidElementHasKernel(ntype) == false) return;
+	for (int i = 1; i < NE; ++i)
+	{
+		if (m_Elem[i].Type() != ntype) return;
+	}
+	m_kernelType = ntype;
+}
+
+//-----------------------------------------------------------------------------
+// Calls the specialized kernel f (and returns) when element el has one. The element
+// type is checked again, in case the elements changed after the kernels were selected.
+#define CALL_ELEMENT_KERNEL(f, el, ...) \
+	if ((el).Type() == m_kernelType) { \
+		switch (m_kernelType) { \
+		case FE_HEX8G8  : f<FE_HEX8G8  >(el, __VA_ARGS__); return; \
+		case FE_HEX8G1  : f<FE_HEX8G1  >(el, __VA_ARGS__); return; \
+		case FE_TET4G1  : f<FE_TET4G1  >(el, __VA_ARGS__); return; \
+		case FE_TET4G4  : f<FE_TET4G4  >(el, __VA_ARGS__); return; \
+		case FE_TET10G4 : f<FE_TET10G4 >(el, __VA_ARGS__); return; \
+		case FE_TET10G8 : f<FE_TET10G8 >(el, __VA_ARGS__); return; \
+		case FE_HEX20G8 : f<FE_HEX20G8 >(el, __VA_ARGS__); return; \
+		case FE_HEX20G27: f<FE_HEX20G27>(el, __VA_ARGS__); return; \
+		default: break; \
+		} \
+	}
+
+//-----------------------------------------------------------------------------
+//! The point store caches pointers to the material point data, so it is rebuilt
+//! whenever the material points are (re)allocated.
+void FEElasticSolidDomain::CreateMaterialPointData()
+{
+	FESolidDomain::CreateMaterialPointData();
+	m_store.Create(*this);
 }
 
 //-----------------------------------------------------------------------------
@@ -132,6 +189,9 @@ void FEElasticSolidDomain::Serialize(DumpStream& ar)
 	ar & m_alpham;
 	ar & m_beta;
 	ar & m_update_dynamic;
+
+	// the material point data was reallocated, so rebuild the point store
+	if (ar.IsLoading()) m_store.Create(*this);
 }
 
 //-----------------------------------------------------------------------------
@@ -152,7 +212,7 @@ void FEElasticSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 			for (int j = 0; j < n; ++j)
 			{
 				FEMaterialPoint& mp = *el.GetMaterialPoint(j);
-				FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+				FEElasticMaterialPoint& pt = ElasticPoint(el, j);
 				pt.m_Wp = pt.m_Wt;
 
 				mp.Update(timeInfo);
@@ -164,32 +224,30 @@ void FEElasticSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 {
-	int NE = Elements();
-	#pragma omp parallel for shared (NE)
-	for (int i=0; i<NE; ++i)
-	{
+	AssembleElements(R, [&](int i) {
+
 		// get the element
 		FESolidElement& el = m_Elem[i];
 
-		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+		// element force vector (from the scratch pool of this thread)
+		FEScratch< vector<double> > pfe;
+		FEScratch< vector<int> > plm;
+		vector<double>& fe = pfe;
+		vector<int>& lm = plm;
 
-			// get the element force vector and initialize it to zero
-			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+		// get the element force vector and initialize it to zero
+		int ndof = 3 * el.Nodes();
+		fe.assign(ndof, 0);
 
-			// calculate internal force vector
-			ElementInternalForce(el, fe);
+		// calculate internal force vector
+		ElementInternalForce(el, fe);
 
-			// get the element's LM vector
-			UnpackLM(el, lm);
+		// get the element's LM vector
+		UnpackLM(el, lm);
 
-			// assemble element 'fe'-vector into global R vector
-			R.Assemble(el.m_node, lm, fe);
-		}
-	}
+		// assemble element 'fe'-vector into global R vector
+		R.Assemble(el.m_node, lm, fe);
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -197,6 +255,8 @@ void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 
 void FEElasticSolidDomain::ElementInternalForce(FESolidElement& el, vector<double>& fe)
 {
+	CALL_ELEMENT_KERNEL(ElementInternalForceKernel, el, fe);
+
 	// jacobian matrix, inverse jacobian matrix and determinants
 	double Ji[3][3];
 
@@ -208,8 +268,7 @@ void FEElasticSolidDomain::ElementInternalForce(FESolidElement& el, vector<doubl
 	// repeat for all integration points
 	for (int n=0; n<nint; ++n)
 	{
-		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		FEElasticMaterialPoint& pt = ElasticPoint(el, n);
 
 		// calculate the jacobian
 		double detJt = (m_update_dynamic ? invjact(el, Ji, n, m_alphaf) : invjact(el, Ji, n));
@@ -284,6 +343,8 @@ void FEElasticSolidDomain::BodyForce(FEGlobalVector& R, FEBodyForce& BF)
 //! calculates element's geometrical stiffness component for integration point n
 void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matrix &ke)
 {
+	CALL_ELEMENT_KERNEL(ElementGeometricalStiffnessKernel, el, ke);
+
 	// spatial derivatives of shape functions
 	vec3d G[FEElement::MAX_NODES];
 
@@ -299,14 +360,13 @@ void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matri
 		double w = ShapeGradient(el, n, G, m_alphaf)*gw[n]*m_alphaf;
 
 		// get the material point data
-		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		FEElasticMaterialPoint& pt = ElasticPoint(el, n);
 
 		// element's Cauchy-stress tensor at gauss point n
 		mat3ds& s = pt.m_s;
 
 		for (int i = 0; i<neln; ++i)
-			for (int j = 0; j<neln; ++j)
+			for (int j = (m_upperKe ? i : 0); j<neln; ++j)
 			{
 				double kab = (G[i]*(s * G[j]))*w;
 
@@ -322,6 +382,8 @@ void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matri
 
 void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &ke)
 {
+	CALL_ELEMENT_KERNEL(ElementMaterialStiffnessKernel, el, ke);
+
 	// Get the current element's data
 	const int nint = el.GaussPoints();
 	const int neln = el.Nodes();
@@ -344,31 +406,43 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	// weights at gauss points
 	const double *gw = el.GaussWeights();
 
+	// evaluate the tangents of all integration points at once
+	// NOTE: deformation gradient and determinant have already been evaluated in the stress routine
+	bool batch = ((m_secant_tangent == false) && (m_pMat->UseSecantTangent() == false));
+	tens4ds Cb[FEElement::MAX_INTPOINTS];
+	if (batch)
+	{
+		FEMaterialPoint* mp[FEElement::MAX_INTPOINTS];
+		for (int n = 0; n < nint; ++n) mp[n] = el.GetMaterialPoint(n);
+		m_pMat->BatchTangent(mp, nint, Cb);
+	}
+
 	// calculate element stiffness matrix
 	for (int n=0; n<nint; ++n)
 	{
 		// calculate jacobian and shape function gradients
 		detJt = ShapeGradient(el, n, G, m_alphaf)*gw[n]*m_alphaf;
 
-		// setup the material point
-		// NOTE: deformation gradient and determinant have already been evaluated in the stress routine
-		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-
 		// get the 'D' matrix
-//		tens4ds C = m_pMat->Tangent(mp);
-        tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
-		C.extract(D);
+		if (batch) Cb[n].extract(D);
+		else
+		{
+			FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+			tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
+			C.extract(D);
+		}
 
-		// we only calculate the upper triangular part
-		// since ke is symmetric. The other part is
-		// determined below using this symmetry.
+		// for symmetric matrices we only calculate the upper triangular
+		// part of the node-pair blocks. The other part is determined
+		// in StiffnessMatrix using this symmetry.
 		for (int i=0, i3=0; i<neln; ++i, i3 += 3)
 		{
 			Gxi = G[i].x;
 			Gyi = G[i].y;
 			Gzi = G[i].z;
 
-			for (int j=0, j3 = 0; j<neln; ++j, j3 += 3)
+			const int j0 = (m_upperKe ? i : 0);
+			for (int j=j0, j3 = 3*j0; j<neln; ++j, j3 += 3)
 			{
 				Gxj = G[j].x;
 				Gyj = G[j].y;
@@ -415,48 +489,205 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Internal force kernel for elements of type ET. Same as ElementInternalForce, but
+//! the nodal coordinates are gathered once and all loops have compile-time bounds.
+template <FE_Element_Type ET> void FEElasticSolidDomain::ElementInternalForceKernel(FESolidElement& el, vector<double>& fe)
+{
+	const int NEN  = FESolidKernelTraits<ET>::Nodes;
+	const int NINT = FESolidKernelTraits<ET>::GaussPoints;
+
+	// nodal coordinates
+	vec3d rt[NEN];
+	if (m_update_dynamic) GetCurrentNodalCoordinates(el, rt, m_alphaf);
+	else GetCurrentNodalCoordinates(el, rt);
+
+	const double* gw = el.GaussWeights();
+	double* f = &fe[0];
+
+	vec3d G[NEN];
+	for (int n = 0; n < NINT; ++n)
+	{
+		double detJt = FESolidShapeGradient<ET>(el, n, rt, G)*gw[n];
+
+		// get the stress vector for this integration point
+		const mat3ds& s = ElasticPoint(el, n).m_s;
+
+		// the '-' sign is so that the internal forces get subtracted
+		// from the global residual vector
+		for (int i = 0; i < NEN; ++i)
+		{
+			f[3*i  ] -= (G[i].x*s.xx() + G[i].y*s.xy() + G[i].z*s.xz())*detJt;
+			f[3*i+1] -= (G[i].y*s.yy() + G[i].x*s.xy() + G[i].z*s.yz())*detJt;
+			f[3*i+2] -= (G[i].z*s.zz() + G[i].y*s.yz() + G[i].x*s.xz())*detJt;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Geometrical stiffness kernel for elements of type ET.
+template <FE_Element_Type ET> void FEElasticSolidDomain::ElementGeometricalStiffnessKernel(FESolidElement& el, matrix& ke)
+{
+	const int NEN  = FESolidKernelTraits<ET>::Nodes;
+	const int NINT = FESolidKernelTraits<ET>::GaussPoints;
+
+	// nodal coordinates
+	vec3d rt[NEN];
+	GetCurrentNodalCoordinates(el, rt, m_alphaf);
+
+	const double* gw = el.GaussWeights();
+
+	vec3d G[NEN], sG[NEN];
+	for (int n = 0; n < NINT; ++n)
+	{
+		double w = FESolidShapeGradient<ET>(el, n, rt, G)*gw[n]*m_alphaf;
+
+		// element's Cauchy-stress tensor at gauss point n
+		const mat3ds& s = ElasticPoint(el, n).m_s;
+		for (int j = 0; j < NEN; ++j) sG[j] = s*G[j];
+
+		for (int i = 0; i < NEN; ++i)
+		{
+			double* ki0 = ke[3*i  ];
+			double* ki1 = ke[3*i+1];
+			double* ki2 = ke[3*i+2];
+			for (int j = (m_upperKe ? i : 0); j < NEN; ++j)
+			{
+				double kab = (G[i]*sG[j])*w;
+				ki0[3*j  ] += kab;
+				ki1[3*j+1] += kab;
+				ki2[3*j+2] += kab;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Material stiffness kernel for elements of type ET. The D*B products of the 
+//! nodes are evaluated once per integration point instead of once per node pair.
+template <FE_Element_Type ET> void FEElasticSolidDomain::ElementMaterialStiffnessKernel(FESolidElement& el, matrix& ke)
+{
+	const int NEN  = FESolidKernelTraits<ET>::Nodes;
+	const int NINT = FESolidKernelTraits<ET>::GaussPoints;
+
+	// nodal coordinates
+	vec3d rt[NEN];
+	GetCurrentNodalCoordinates(el, rt, m_alphaf);
+
+	const double* gw = el.GaussWeights();
+
+	// evaluate the tangents of all integration points at once
+	bool batch = ((m_secant_tangent == false) && (m_pMat->UseSecantTangent() == false));
+	tens4ds Cb[NINT];
+	if (batch)
+	{
+		FEMaterialPoint* mp[NINT];
+		for (int n = 0; n < NINT; ++n) mp[n] = el.GetMaterialPoint(n);
+		m_pMat->BatchTangent(mp, NINT, Cb);
+	}
+
+	vec3d G[NEN];
+	double D[6][6] = { 0 };
+	double DBL[NEN][6][3];
+	for (int n = 0; n < NINT; ++n)
+	{
+		double detJt = FESolidShapeGradient<ET>(el, n, rt, G)*gw[n]*m_alphaf;
+
+		// get the 'D' matrix
+		if (batch) Cb[n].extract(D);
+		else
+		{
+			FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+			tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
+			C.extract(D);
+		}
+
+		// calculate the D*BL matrices of all nodes
+		for (int j = 0; j < NEN; ++j)
+		{
+			const double Gxj = G[j].x, Gyj = G[j].y, Gzj = G[j].z;
+			for (int k = 0; k < 6; ++k)
+			{
+				DBL[j][k][0] = (D[k][0]*Gxj + D[k][3]*Gyj + D[k][5]*Gzj);
+				DBL[j][k][1] = (D[k][1]*Gyj + D[k][3]*Gxj + D[k][4]*Gzj);
+				DBL[j][k][2] = (D[k][2]*Gzj + D[k][4]*Gyj + D[k][5]*Gxj);
+			}
+		}
+
+		for (int i = 0; i < NEN; ++i)
+		{
+			const double Gxi = G[i].x, Gyi = G[i].y, Gzi = G[i].z;
+			double* ki0 = ke[3*i  ];
+			double* ki1 = ke[3*i+1];
+			double* ki2 = ke[3*i+2];
+			for (int j = (m_upperKe ? i : 0); j < NEN; ++j)
+			{
+				const double (*B)[3] = DBL[j];
+				for (int l = 0; l < 3; ++l)
+				{
+					ki0[3*j+l] += (Gxi*B[0][l] + Gyi*B[3][l] + Gzi*B[5][l])*detJt;
+					ki1[3*j+l] += (Gyi*B[1][l] + Gxi*B[3][l] + Gzi*B[4][l])*detJt;
+					ki2[3*j+l] += (Gzi*B[2][l] + Gyi*B[4][l] + Gxi*B[5][l])*detJt;
+				}
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 {
+	// get the cached scatter maps (if any)
+	// (This is stored in a member so that the element function only needs to 
+	// capture this and LS, which avoids a heap allocation by the std::function.)
+	m_scatter = LS.GetScatterMaps(this, Elements());
+
+	// For symmetric matrices, the element routines only calculate the upper triangle of 
+	// the node-pair blocks, and the lower triangle is copied from it before assembly.
+	m_upperKe = LS.IsSymmetric();
+
 	// repeat over all solid elements
-	int NE = Elements();
-	
-	#pragma omp parallel for shared (NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
-		FESolidElement& el = m_Elem[iel];
+	AssembleElements(LS, [&](int iel) {
 
-		if (el.isActive()) {
+		FESolidElement& el = m_Elem[iel];
 
-			// get the element's LM vector
-			vector<int> lm;
-			UnpackLM(el, lm);
+		// get the element's LM vector
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
+		UnpackLM(el, lm);
 
-			// element stiffness matrix
-			FEElementMatrix ke(el, lm);
+		// element stiffness matrix (from the scratch pool of this thread)
+		FEScratch<FEElementMatrix> pke;
+		FEElementMatrix& ke = pke;
+		ke.SetNodes(el.m_node);
+		ke.SetIndices(lm);
+		if (m_scatter) ke.SetScatterMap(m_scatter + iel);
 
-			// create the element's stiffness matrix
-			int ndof = 3 * el.Nodes();
-			ke.resize(ndof, ndof);
-			ke.zero();
+		// create the element's stiffness matrix
+		int ndof = 3 * el.Nodes();
+		ke.resize(ndof, ndof);
+		ke.zero();
 
-			// calculate geometrical stiffness
-			ElementGeometricalStiffness(el, ke);
+		// calculate geometrical stiffness
+		ElementGeometricalStiffness(el, ke);
 
-			// calculate material stiffness
-			ElementMaterialStiffness(el, ke);
+		// calculate material stiffness
+		ElementMaterialStiffness(el, ke);
 
-/*			// assign symmetic parts
-			// TODO: Can this be omitted by changing the Assemble routine so that it only
-			// grabs elements from the upper diagonal matrix?
+		// assign symmetic parts of the off-diagonal node-pair blocks
+		if (m_upperKe)
+		{
 			for (int i = 0; i < ndof; ++i)
-				for (int j = i + 1; j < ndof; ++j)
+				for (int j = 3*(i/3 + 1); j < ndof; ++j)
 					ke[j][i] = ke[i][j];
-*/
-			// assemble element matrix in global stiffness matrix
-			LS.Assemble(ke);
 		}
-	}
+
+		// assemble element matrix in global stiffness matrix
+		LS.Assemble(ke);
+	});
+
+	m_upperKe = false;
+	m_scatter = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -605,12 +836,15 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 		}
 	}
 
-	// loop over the integration points and calculate
-	// the stress at the integration point
+	// deformation gradients at current time
+	mat3d Fc[FEElement::MAX_INTPOINTS];
+	double Jc[FEElement::MAX_INTPOINTS];
+
+	// loop over the integration points and update the kinematics
 	for (int n=0; n<nint; ++n)
 	{
 		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		FEElasticMaterialPoint& pt = ElasticPoint(el, n);
 
 		// material point coordinates
 		mp.m_rt = el.Evaluate(r, n);
@@ -642,34 +876,52 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 
         // update specialized material points
         m_pMat->UpdateSpecializedMaterialPoints(mp, tp);
-        
-		// calculate the stress at this material point
-//		pt.m_s = m_pMat->Stress(mp);
-		pt.m_s = (m_secant_stress ? m_pMat->SecantStress(mp) : m_pMat->Stress(mp));
-        
-        // adjust stress for strain energy conservation
-		// (Apply only for mid-point rule)
-		if (m_alphaf == 0.5)
+
+		// keep the kinematics at current time for the energy correction below
+		if (m_alphaf == 0.5) { Fc[n] = Ft; Jc[n] = Jt; }
+	}
+
+	// calculate the stress at the material points
+	if (m_secant_stress)
+	{
+		for (int n = 0; n < nint; ++n) ElasticPoint(el, n).m_s = m_pMat->SecantStress(*el.GetMaterialPoint(n));
+	}
+	else
+	{
+		FEMaterialPoint* mp[FEElement::MAX_INTPOINTS];
+		mat3ds s[FEElement::MAX_INTPOINTS];
+		for (int n = 0; n < nint; ++n) mp[n] = el.GetMaterialPoint(n);
+		m_pMat->BatchStress(mp, nint, s);
+		for (int n = 0; n < nint; ++n) ElasticPoint(el, n).m_s = s[n];
+	}
+
+	// adjust stress for strain energy conservation
+	// (Apply only for mid-point rule)
+	if (m_alphaf == 0.5)
+	{
+		FEElasticMaterial* pme = dynamic_cast<FEElasticMaterial*>(m_pMat);
+		for (int n = 0; n < nint; ++n)
 		{
-			FEElasticMaterial* pme = dynamic_cast<FEElasticMaterial*>(m_pMat);
+			FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+			FEElasticMaterialPoint& pt = ElasticPoint(el, n);
 
 			// evaluate strain energy at current time
 			mat3d Ftmp = pt.m_F;
 			double Jtmp = pt.m_J;
-			pt.m_F = Ft;
-			pt.m_J = Jt;
+			pt.m_F = Fc[n];
+			pt.m_J = Jc[n];
 			pt.m_Wt = pme->StrainEnergyDensity(mp);
 			pt.m_F = Ftmp;
 			pt.m_J = Jtmp;
 
-            mat3ds D = pt.RateOfDeformation();
-            double D2 = D.dotdot(D);
+			mat3ds D = pt.RateOfDeformation();
+			double D2 = D.dotdot(D);
 			if (D2 > std::numeric_limits<double>::epsilon())
 			{
 				pt.m_s += D * (((pt.m_Wt - pt.m_Wp) / (dt * pt.m_J) - pt.m_s.dotdot(D)) / D2);
 			}
-        }
-    }
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -714,32 +966,30 @@ void FEElasticSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
 // Calculate inertial forces \todo Why is F no longer needed?
 void FEElasticSolidDomain::InertialForces(FEGlobalVector& R, vector<double>& F)
 {
-    int NE = Elements();
-#pragma omp parallel for shared(R, F)
-	for (int i=0; i<NE; ++i)
-    {
+	AssembleElements(R, [&](int i) {
+
 		// get the element
 		FESolidElement& el = m_Elem[i];
 
-		if (el.isActive()) {
-			// element force vector
-			vector<double> fe;
-			vector<int> lm;
+		// element force vector (from the scratch pool of this thread)
+		FEScratch< vector<double> > pfe;
+		FEScratch< vector<int> > plm;
+		vector<double>& fe = pfe;
+		vector<int>& lm = plm;
 
-			// get the element force vector and initialize it to zero
-			int ndof = 3 * el.Nodes();
-			fe.assign(ndof, 0);
+		// get the element force vector and initialize it to zero
+		int ndof = 3 * el.Nodes();
+		fe.assign(ndof, 0);
 
-			// calculate internal force vector
-			ElementInertialForce(el, fe);
+		// calculate internal force vector
+		ElementInertialForce(el, fe);
 
-			// get the element's LM vector
-			UnpackLM(el, lm);
+		// get the element's LM vector
+		UnpackLM(el, lm);
 
-			// assemble element 'fe'-vector into global R vector
-			R.Assemble(el.m_node, lm, fe);
-		}
-    }
+		// assemble element 'fe'-vector into global R vector
+		R.Assemble(el.m_node, lm, fe);
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -754,7 +1004,7 @@ void FEElasticSolidDomain::ElementInertialForce(FESolidElement& el, vector<doubl
     for (int n=0; n<nint; ++n)
     {
         FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-        FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+        FEElasticMaterialPoint& pt = ElasticPoint(el, n);
         double dens = m_pMat->Density(mp);
         double J0 = detJ0(el, n)*gw[n];
         
@@ -30,8 +30,11 @@ SOFTWARE.*/
 #include <FECore/FESolidDomain.h>
 #include "FEElasticDomain.h"
 #include "FESolidMaterial.h"
+#include "FEElasticPointStore.h"
 #include <FECore/FEDofList.h>
 
+struct FEScatterMap;
+
 //-----------------------------------------------------------------------------
 //! domain described by Lagrange-type 3D volumetric elements
 //!
@@ -59,6 +62,9 @@ public:
 	//! serialization
 	void Serialize(DumpStream& ar) override;
 
+	//! create the material point data (this also rebuilds the point store)
+	void CreateMaterialPointData() override;
+
 	// get the total dof list
 	const FEDofList& GetDOFList() const override;
 
@@ -115,6 +121,23 @@ public:
 
     //! Calculates the inertial force vector for solid elements
     void ElementInertialForce(FESolidElement& el, vector<double>& fe);
+
+protected:
+	//! get the elastic point data of integration point n of element el
+	FEElasticMaterialPoint& ElasticPoint(FESolidElement& el, int n)
+	{
+		if (m_store.IsEmpty()) return *el.GetMaterialPoint(n)->ExtractData<FEElasticMaterialPoint>();
+		return *m_store.Point(el.GetLocalID(), n);
+	}
+
+	//! select the element kernels for the element type of this domain
+	void SelectElementKernels();
+
+	// Element kernels specialized on the element type (see FESolidElementKernels.h).
+	// These are called by the functions above when the domain's elements have a specialized kernel.
+	template <FE_Element_Type ET> void ElementInternalForceKernel(FESolidElement& el, vector<double>& fe);
+	template <FE_Element_Type ET> void ElementGeometricalStiffnessKernel(FESolidElement& el, matrix& ke);
+	template <FE_Element_Type ET> void ElementMaterialStiffnessKernel(FESolidElement& el, matrix& ke);
     
 protected:
     double              m_alphaf;
@@ -125,6 +148,11 @@ protected:
 	bool	m_secant_stress;	//!< use secant approximation to stress
 	bool	m_secant_tangent;   //!< flag for using secant tangent
 
+	FEElasticPointStore	m_store;	//!< table of the elastic point data
+	int					m_kernelType;	//!< element type of the specialized kernels (FE_ELEM_INVALID_TYPE if there are none)
+	bool				m_upperKe;		//!< only calculate the upper triangle of node-pair blocks of element stiffness matrices
+	FEScatterMap*		m_scatter;		//!< cached scatter maps of the stiffness assembly (or null)
+
 protected:
 	FEDofList	m_dofU;		// displacement dofs
 	FEDofList	m_dofR;		// rigid rotation rofs
@@ -631,6 +631,7 @@ void FEFacet2FacetSliding::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FEFacetSlidingSurface& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
+		#pragma omp parallel for schedule(dynamic) private(sLM, mLM, LM, en, fe, detJ, w, Hs, Hm, r0)
 		for (int i=0; i<ss.Elements(); ++i)
 		{
 			FESurfaceElement& se = ss.Element(i);
@@ -754,8 +755,27 @@ void FEFacet2FacetSliding::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 						for (int k = 0; k < ndof; ++k) fe[k] *= tn * detJ[j] * w[j];
 
-						for (int k = 0; k < nseln; ++k) ss.m_Fn[se.m_lnode[k]] += vec3d(fe[3 * k], fe[3 * k + 1], fe[3 * k + 2]);
-						for (int k = 0; k < nmeln; ++k) ms.m_Fn[me.m_lnode[k]] += vec3d(fe[3 * nseln + 3 * k], fe[3 * nseln + 3 * k + 1], fe[3 * nseln + 3 * k + 2]);
+						// nodal forces are shared between neighboring facets
+						for (int k = 0; k < nseln; ++k)
+						{
+							vec3d& f = ss.m_Fn[se.m_lnode[k]];
+							#pragma omp atomic
+							f.x += fe[3 * k];
+							#pragma omp atomic
+							f.y += fe[3 * k + 1];
+							#pragma omp atomic
+							f.z += fe[3 * k + 2];
+						}
+						for (int k = 0; k < nmeln; ++k)
+						{
+							vec3d& f = ms.m_Fn[me.m_lnode[k]];
+							#pragma omp atomic
+							f.x += fe[3 * nseln + 3 * k];
+							#pragma omp atomic
+							f.y += fe[3 * nseln + 3 * k + 1];
+							#pragma omp atomic
+							f.z += fe[3 * nseln + 3 * k + 2];
+						}
 
 						// assemble the global residual
 						R.Assemble(en, LM, fe);
@@ -810,6 +830,7 @@ void FEFacet2FacetSliding::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FEFacetSlidingSurface& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
+		#pragma omp parallel for schedule(dynamic) private(sLM, mLM, LM, en, ke, N, T1, T2, D1, D2, Nb1, Nb2, detJ, w, Hs, Hm, Hmr, Hms, r0) firstprivate(N1, N2)
 		for (int i=0; i<ss.Elements(); ++i)
 		{
 			FESurfaceElement& se = ss.Element(i);
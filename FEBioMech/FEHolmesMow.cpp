@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEHolmesMow.h"
+#include "FEElasticBatch.h"
 
 //-----------------------------------------------------------------------------
 // define the material parameters
@@ -108,6 +109,80 @@ tens4ds FEHolmesMow::Tangent(FEMaterialPoint& mp)
 	return c;
 }
 
+//-----------------------------------------------------------------------------
+//! Evaluates the common terms of the Holmes-Mow stress for a batch of points.
+//! On return, s contains the stress components and eQ the exponential term.
+static void HolmesMowBatch(const FEElasticBatch& B, double lam, double mu, double Ha, double beta, double s[6][FEElasticBatch::MAX_POINTS], double* eQ)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	double b2[6][M], I3[M];
+	B.Square(b2);
+	B.Det(I3);
+
+	int n = B.m_n;
+#pragma omp simd
+	for (int i = 0; i < n; ++i)
+	{
+		double I1 = B.m_b[FEElasticBatch::XX][i] + B.m_b[FEElasticBatch::YY][i] + B.m_b[FEElasticBatch::ZZ][i];
+		double I2 = (I1*I1 - (b2[FEElasticBatch::XX][i] + b2[FEElasticBatch::YY][i] + b2[FEElasticBatch::ZZ][i]))*0.5;
+		eQ[i] = exp(beta*((2*mu-lam)*(I1-3) + lam*(I2-3))/Ha)/pow(I3[i],beta);
+
+		// s = 0.5/J*eQ*((2*mu+lam*(I1-1))*b - lam*b2 - Ha*I)
+		double f = 0.5*eQ[i]/B.m_J[i];
+		double a = 2*mu + lam*(I1 - 1);
+		for (int k = 0; k < 6; ++k) s[k][i] = f*(a*B.m_b[k][i] - lam*b2[k][i]);
+		s[FEElasticBatch::XX][i] -= f*Ha;
+		s[FEElasticBatch::YY][i] -= f*Ha;
+		s[FEElasticBatch::ZZ][i] -= f*Ha;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEHolmesMow::BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double sb[6][M], eQ[M];
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.Gather(mp + i0, n);
+		HolmesMowBatch(B, lam, mu, Ha, m_b, sb, eQ);
+
+		for (int i = 0; i < n; ++i)
+		{
+			s[i0 + i] = mat3ds(sb[0][i], sb[1][i], sb[2][i], sb[3][i], sb[4][i], sb[5][i]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEHolmesMow::BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double sb[6][M], eQ[M];
+
+	mat3ds identity(1.,1.,1.,0.,0.,0.);
+	tens4ds I4 = dyad4s(identity);
+
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.Gather(mp + i0, n);
+		HolmesMowBatch(B, lam, mu, Ha, m_b, sb, eQ);
+
+		for (int i = 0; i < n; ++i)
+		{
+			double detF = B.m_J[i];
+			mat3ds s(sb[0][i], sb[1][i], sb[2][i], sb[3][i], sb[4][i], sb[5][i]);
+			mat3ds b = B.LeftCauchyGreen(i);
+			c[i0 + i] = dyad1s(s)*(4.*m_b/Ha*detF/eQ[i])
+				+ ((dyad1s(b) - dyad4s(b))*lam + I4*Ha)*(eQ[i]/detF);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FEHolmesMow::StrainEnergyDensity(FEMaterialPoint& mp)
 {
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEIsotropicElastic.h"
+#include "FEElasticBatch.h"
 
 //-----------------------------------------------------------------------------
 // define the material parameters
@@ -89,6 +90,74 @@ tens4ds FEIsotropicElastic::Tangent(FEMaterialPoint& mp)
 	return dyad1s(b)*lam + dyad4s(b)*(2.0*mu);
 }
 
+//-----------------------------------------------------------------------------
+void FEIsotropicElastic::BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double E[M], v[M], a[M], mu[M];
+	double b2[6][M];
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.Gather(mp + i0, n);
+		B.Square(b2);
+		B.EvalParam(m_E, mp + i0, E);
+		B.EvalParam(m_v, mp + i0, v);
+
+		// s = b*(lam*trE - mu) + b2*mu
+#pragma omp simd
+		for (int i = 0; i < n; ++i)
+		{
+			double Ji = 1.0/B.m_J[i];
+			double lam = Ji*(v[i]*E[i]/((1+v[i])*(1-2*v[i])));
+			mu[i] = Ji*(0.5*E[i]/(1+v[i]));
+			double trE = 0.5*(B.m_b[FEElasticBatch::XX][i] + B.m_b[FEElasticBatch::YY][i] + B.m_b[FEElasticBatch::ZZ][i] - 3);
+			a[i] = lam*trE - mu[i];
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			s[i0 + i] = mat3ds(
+				a[i]*B.m_b[FEElasticBatch::XX][i] + mu[i]*b2[FEElasticBatch::XX][i],
+				a[i]*B.m_b[FEElasticBatch::YY][i] + mu[i]*b2[FEElasticBatch::YY][i],
+				a[i]*B.m_b[FEElasticBatch::ZZ][i] + mu[i]*b2[FEElasticBatch::ZZ][i],
+				a[i]*B.m_b[FEElasticBatch::XY][i] + mu[i]*b2[FEElasticBatch::XY][i],
+				a[i]*B.m_b[FEElasticBatch::YZ][i] + mu[i]*b2[FEElasticBatch::YZ][i],
+				a[i]*B.m_b[FEElasticBatch::XZ][i] + mu[i]*b2[FEElasticBatch::XZ][i]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEIsotropicElastic::BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double E[M], v[M], lam[M], mu2[M];
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.Gather(mp + i0, n);
+		B.EvalParam(m_E, mp + i0, E);
+		B.EvalParam(m_v, mp + i0, v);
+
+#pragma omp simd
+		for (int i = 0; i < n; ++i)
+		{
+			double Ji = 1.0/B.m_J[i];
+			lam[i] = Ji*(v[i]*E[i]/((1+v[i])*(1-2*v[i])));
+			mu2[i] = 2.0*Ji*(0.5*E[i]/(1+v[i]));
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			mat3ds b = B.LeftCauchyGreen(i);
+			c[i0 + i] = dyad1s(b)*lam[i] + dyad4s(b)*mu2[i];
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FEIsotropicElastic::StrainEnergyDensity(FEMaterialPoint& mp)
 {
@@ -46,6 +46,12 @@ public:
 	//! calculate tangent stiffness at material point
 	virtual tens4ds Tangent(FEMaterialPoint& pt) override;
 
+	//! calculate stress at a batch of material points
+	void BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s) override;
+
+	//! calculate tangent stiffness at a batch of material points
+	void BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c) override;
+
 	//! calculate strain energy density at material point
 	virtual double StrainEnergyDensity(FEMaterialPoint& pt) override;
     
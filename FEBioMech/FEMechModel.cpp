@@ -231,6 +231,13 @@ void FEMechModel::SerializeGeometry(DumpStream& ar)
 	m_prs->Serialize(ar);
 }
 
+//-----------------------------------------------------------------------------
+void FEMechModel::SerializeGeometryState(DumpStream& ar)
+{
+	FEModel::SerializeGeometryState(ar);
+	m_prs->Serialize(ar);
+}
+
 //-----------------------------------------------------------------------------
 //! Build the matrix profile for this model
 void FEMechModel::BuildMatrixProfile(FEGlobalMatrix& G, bool breset)
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEMooneyRivlin.h"
+#include "FEElasticBatch.h"
 
 //-----------------------------------------------------------------------------
 // define the material parameters
@@ -135,6 +136,87 @@ tens4ds FEMooneyRivlin::DevTangent(FEMaterialPoint& mp)
 	return c;
 }
 
+//-----------------------------------------------------------------------------
+//! Calculate the deviatoric stress at a batch of points
+void FEMooneyRivlin::BatchDevStress(FEMaterialPoint** mp, int npts, mat3ds* s)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double c1[M], c2[M], T[6][M], B2[6][M];
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.GatherDev(mp + i0, n);
+		B.Square(B2);
+		B.EvalParam(m_c1, mp + i0, c1);
+		B.EvalParam(m_c2, mp + i0, c2);
+
+		// s = dev(B*(W1 + W2*I1) - B2*W2)*(2/J)
+#pragma omp simd
+		for (int i = 0; i < n; ++i)
+		{
+			double I1 = B.m_b[FEElasticBatch::XX][i] + B.m_b[FEElasticBatch::YY][i] + B.m_b[FEElasticBatch::ZZ][i];
+			double a = c1[i] + c2[i]*I1;
+			double f = 2.0/B.m_J[i];
+			for (int k = 0; k < 6; ++k) T[k][i] = f*(a*B.m_b[k][i] - c2[i]*B2[k][i]);
+			double p = (T[FEElasticBatch::XX][i] + T[FEElasticBatch::YY][i] + T[FEElasticBatch::ZZ][i])/3.0;
+			T[FEElasticBatch::XX][i] -= p;
+			T[FEElasticBatch::YY][i] -= p;
+			T[FEElasticBatch::ZZ][i] -= p;
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			s[i0 + i] = mat3ds(T[0][i], T[1][i], T[2][i], T[3][i], T[4][i], T[5][i]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Calculate the deviatoric tangent at a batch of points
+void FEMooneyRivlin::BatchDevTangent(FEMaterialPoint** mp, int npts, tens4ds* c)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double c1[M], c2[M], B2[6][M];
+
+	// Identity tensor
+	mat3ds I(1,1,1,0,0,0);
+	tens4ds IxI = dyad1s(I);
+	tens4ds I4  = dyad4s(I);
+
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.GatherDev(mp + i0, n);
+		B.Square(B2);
+		B.EvalParam(m_c1, mp + i0, c1);
+		B.EvalParam(m_c2, mp + i0, c2);
+
+		for (int i = 0; i < n; ++i)
+		{
+			double W1 = c1[i];
+			double W2 = c2[i];
+			double Ji = 1.0/B.m_J[i];
+
+			mat3ds Bi = B.LeftCauchyGreen(i);
+			mat3ds B2i(B2[0][i], B2[1][i], B2[2][i], B2[3][i], B2[4][i], B2[5][i]);
+
+			double I1 = Bi.tr();
+			double I2 = 0.5*(I1*I1 - B2i.tr());
+			double WC = W1*I1 + 2*W2*I2;
+			double CWWC = 2*I2*W2;
+
+			mat3ds T = Bi*(W1 + W2*I1) - B2i*W2;
+			mat3ds devs = T.dev()*(2.0*Ji);
+
+			mat3ds WCCxC = Bi*(W2*I1) - B2i*W2;
+			tens4ds cw = (dyad1s(Bi) - dyad4s(Bi))*(W2*4.0*Ji) - dyad1s(WCCxC, I)*(4.0/3.0*Ji) + IxI*(4.0/9.0*Ji*CWWC);
+			c[i0 + i] = dyad1s(devs, I)*(-2.0/3.0) + (I4 - IxI/3.0)*(4.0/3.0*Ji*WC) + cw;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! calculate deviatoric strain energy density
 double FEMooneyRivlin::DevStrainEnergyDensity(FEMaterialPoint& mp)
@@ -49,6 +49,12 @@ public:
 	//! calculate deviatoric tangent stiffness at material point
 	tens4ds DevTangent(FEMaterialPoint& pt) override;
 
+	//! calculate deviatoric stress at a batch of material points
+	void BatchDevStress(FEMaterialPoint** mp, int npts, mat3ds* s) override;
+
+	//! calculate deviatoric tangent at a batch of material points
+	void BatchDevTangent(FEMaterialPoint** mp, int npts, tens4ds* c) override;
+
 	//! calculate deviatoric strain energy density
 	double DevStrainEnergyDensity(FEMaterialPoint& mp) override;
     
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FENeoHookean.h"
+#include "FEElasticBatch.h"
 
 //-----------------------------------------------------------------------------
 // define the material parameters
@@ -92,6 +93,81 @@ tens4ds FENeoHookean::Tangent(FEMaterialPoint& mp)
 	return dyad1s(I)*lam1 + dyad4s(I)*(2*mu1);
 }
 
+//-----------------------------------------------------------------------------
+void FENeoHookean::BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double E[M], v[M], a[M], c[M];
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.Gather(mp + i0, n);
+		B.EvalParam(m_E, mp + i0, E);
+		B.EvalParam(m_v, mp + i0, v);
+
+		// s = (b - I)*(mu/J) + I*(lam*lnJ/J)
+#pragma omp simd
+		for (int i = 0; i < n; ++i)
+		{
+			double lam = v[i]*E[i]/((1+v[i])*(1-2*v[i]));
+			double mu  = 0.5*E[i]/(1+v[i]);
+			double Ji = 1.0/B.m_J[i];
+			a[i] = mu*Ji;
+			c[i] = (lam*log(B.m_J[i]) - mu)*Ji;
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			s[i0 + i] = mat3ds(
+				a[i]*B.m_b[FEElasticBatch::XX][i] + c[i],
+				a[i]*B.m_b[FEElasticBatch::YY][i] + c[i],
+				a[i]*B.m_b[FEElasticBatch::ZZ][i] + c[i],
+				a[i]*B.m_b[FEElasticBatch::XY][i],
+				a[i]*B.m_b[FEElasticBatch::YZ][i],
+				a[i]*B.m_b[FEElasticBatch::XZ][i]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FENeoHookean::BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c)
+{
+	const int M = FEElasticBatch::MAX_POINTS;
+	FEElasticBatch B;
+	double E[M], v[M], lam1[M], mu2[M];
+
+	mat3dd I(1);
+	tens4ds IxI = dyad1s(I);
+	tens4ds I4  = dyad4s(I);
+
+	for (int i0 = 0; i0 < npts; i0 += M)
+	{
+		int n = (npts - i0 < M ? npts - i0 : M);
+		B.Gather(mp + i0, n);
+		B.EvalParam(m_E, mp + i0, E);
+		B.EvalParam(m_v, mp + i0, v);
+
+#pragma omp simd
+		for (int i = 0; i < n; ++i)
+		{
+			double lam = v[i]*E[i]/((1+v[i])*(1-2*v[i]));
+			double mu  = 0.5*E[i]/(1+v[i]);
+			double J = B.m_J[i];
+			lam1[i] = lam / J;
+			mu2[i] = 2.0*(mu - lam*log(J)) / J;
+		}
+
+		// c = IxI*lam1 + I4*(2*mu1)
+		for (int i = 0; i < n; ++i)
+		{
+			double* d = c[i0 + i].d;
+#pragma omp simd
+			for (int k = 0; k < tens4ds::NNZ; ++k) d[k] = IxI.d[k]*lam1[i] + I4.d[k]*mu2[i];
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FENeoHookean::StrainEnergyDensity(FEMaterialPoint& mp)
 {
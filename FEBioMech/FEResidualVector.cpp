@@ -50,18 +50,33 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 
 	// assemble the element residual into the global residual
 	int ndof = (int)fe.size();
-	for (int i = 0; i < ndof; ++i)
+	double* pR = PartialVector();
+	if (pR)
 	{
-		int I = elm[i];
-
-		if (I >= 0) {
-			#pragma omp atomic
-			R[I] += fe[i];
+		// buffered assembly: add to the partial vectors of this thread
+		double* pFr = pR + R.size();
+		for (int i = 0; i < ndof; ++i)
+		{
+			int I = elm[i];
+			if (I >= 0) pR[I] += fe[i];
+			else if (-I - 2 >= 0) pFr[-I - 2] -= fe[i];
 		}
-		// TODO: Find another way to store reaction forces
-		else if (-I - 2 >= 0) {
-			#pragma omp atomic
-			m_Fr[-I - 2] -= fe[i];
+	}
+	else
+	{
+		for (int i = 0; i < ndof; ++i)
+		{
+			int I = elm[i];
+
+			if (I >= 0) {
+				#pragma omp atomic
+				R[I] += fe[i];
+			}
+			// TODO: Find another way to store reaction forces
+			else if (-I - 2 >= 0) {
+				#pragma omp atomic
+				m_Fr[-I - 2] -= fe[i];
+			}
 		}
 	}
 
@@ -129,33 +144,51 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 					const int* lm = RB.m_LM;
 
 					if (lm[0] >= 0) {
-						#pragma omp atomic
-						R[lm[0]] += f.x;
+						if (pR) pR[lm[0]] += f.x;
+						else {
+							#pragma omp atomic
+							R[lm[0]] += f.x;
+						}
 					}
 
 					if (lm[1] >= 0) {
-						#pragma omp atomic
-						R[lm[1]] += f.y;
+						if (pR) pR[lm[1]] += f.y;
+						else {
+							#pragma omp atomic
+							R[lm[1]] += f.y;
+						}
 					}
 
 					if (lm[2] >= 0) {
-						#pragma omp atomic
-						R[lm[2]] += f.z;
+						if (pR) pR[lm[2]] += f.z;
+						else {
+							#pragma omp atomic
+							R[lm[2]] += f.z;
+						}
 					}
 
 					if (lm[3] >= 0) {
-						#pragma omp atomic
-						R[lm[3]] += m.x;
+						if (pR) pR[lm[3]] += m.x;
+						else {
+							#pragma omp atomic
+							R[lm[3]] += m.x;
+						}
 					}
 
 					if (lm[4] >= 0) {
-						#pragma omp atomic
-						R[lm[4]] += m.y;
+						if (pR) pR[lm[4]] += m.y;
+						else {
+							#pragma omp atomic
+							R[lm[4]] += m.y;
+						}
 					}
 
 					if (lm[5] >= 0) {
-						#pragma omp atomic
-						R[lm[5]] += m.z;
+						if (pR) pR[lm[5]] += m.z;
+						else {
+							#pragma omp atomic
+							R[lm[5]] += m.z;
+						}
 					}
 
 					/*
@@ -188,8 +221,12 @@ void FEResidualVector::Assemble(int node_id, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
+		double* pR = PartialVector();
+		if (pR) pR[n] += f;
+		else {
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 	else {
 		FESolidSolver2* solver = dynamic_cast<FESolidSolver2*>(m_fem.GetCurrentStep()->GetFESolver());
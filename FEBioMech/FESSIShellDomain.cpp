@@ -92,6 +92,13 @@ void FESSIShellDomain::Serialize(DumpStream& ar)
 	ar & m_bnodalnormals;
 }
 
+//-----------------------------------------------------------------------------
+void FESSIShellDomain::SerializeState(DumpStream& ar)
+{
+	FEShellDomainNew::SerializeState(ar);
+	ar & m_bnodalnormals;
+}
+
 //-----------------------------------------------------------------------------
 //! Calculate all shell normals (i.e. the shell directors).
 //! And find shell nodes
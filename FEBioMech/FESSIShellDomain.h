@@ -49,6 +49,9 @@ public:
 	//! serialization
 	void Serialize(DumpStream& ar) override;
 
+	//! serialize the shallow domain data (excluding material points)
+	void SerializeState(DumpStream& ar) override;
+
 	//! Update element data prior to solving time step
 	void PreSolveUpdate(const FETimeInfo& timeInfo) override;
 
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FESlidingElasticInterface.h"
 #include "FECore/FENormalProjection.h"
+#include "FECore/FESurfaceBVH.h"
 #include "FECore/FEModel.h"
 #include "FECore/FEAnalysis.h"
 #include <FECore/FELinearSystem.h>
@@ -48,6 +49,7 @@ BEGIN_FECORE_CLASS(FESlidingElasticInterface, FEContactInterface)
 	ADD_PARAMETER(m_stol     , "search_tol"         );
 	ADD_PARAMETER(m_bsymm    , "symmetric_stiffness");
     ADD_PARAMETER(m_srad     , "search_radius"      )->setUnits(UNIT_LENGTH);;
+	ADD_PARAMETER(m_bpattern , "reserve_pattern"    );
 	ADD_PARAMETER(m_nsegup   , "seg_up"             );
 	ADD_PARAMETER(m_btension , "tension"            );
 	ADD_PARAMETER(m_naugmin  , "minaug"             );
@@ -299,6 +301,7 @@ FESlidingElasticInterface::FESlidingElasticInterface(FEModel* pfem) : FEContactI
     m_stol = 0.01;
     m_bsymm = true;
     m_srad = 1.0;
+    m_bpattern = false;
     m_nsegup = 0;
     m_bautopen = false;
 	m_bupdtpen = false;
@@ -399,58 +402,89 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
     const int dof_RW = fem.GetDOFIndex("Rw");
     
     vector<int> lm(6*FEElement::MAX_NODES*2);
+
+    // adds the profile of a primary and secondary element pair
+    auto addPair = [&](FESurfaceElement& se, FESurfaceElement& me) {
+        int* sn = &se.m_node[0];
+        int* mn = &me.m_node[0];
+
+        assign(lm, -1);
+
+        int nseln = se.Nodes();
+        int nmeln = me.Nodes();
+
+        for (int l=0; l<nseln; ++l)
+        {
+            vector<int>& id = mesh.Node(sn[l]).m_ID;
+            lm[6*l  ] = id[dof_X];
+            lm[6*l+1] = id[dof_Y];
+            lm[6*l+2] = id[dof_Z];
+            lm[6*l+3] = id[dof_RU];
+            lm[6*l+4] = id[dof_RV];
+            lm[6*l+5] = id[dof_RW];
+        }
+
+        for (int l=0; l<nmeln; ++l)
+        {
+            vector<int>& id = mesh.Node(mn[l]).m_ID;
+            lm[6*(l+nseln)  ] = id[dof_X];
+            lm[6*(l+nseln)+1] = id[dof_Y];
+            lm[6*(l+nseln)+2] = id[dof_Z];
+            lm[6*(l+nseln)+3] = id[dof_RU];
+            lm[6*(l+nseln)+4] = id[dof_RV];
+            lm[6*(l+nseln)+5] = id[dof_RW];
+        }
+
+        K.build_add(lm);
+    };
     
     int npass = (m_btwo_pass?2:1);
     for (int np=0; np<npass; ++np)
     {
         FESlidingElasticSurface& ss = (np == 0? m_ss : m_ms);
+        FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
-        int k, l;
         for (int j=0; j<ss.Elements(); ++j)
         {
             FESurfaceElement& se = ss.Element(j);
             int nint = se.GaussPoints();
-            int* sn = &se.m_node[0];
-            for (k=0; k<nint; ++k)
+            for (int k=0; k<nint; ++k)
             {
 				FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(k));
 
                 FESurfaceElement* pe = data.m_pme;
-                
-                if (pe != 0)
+                if (pe != 0) addPair(se, *pe);
+            }
+        }
+
+        // Reserve room for all the secondary elements that the primary elements could 
+        // come in contact with, i.e. the ones that are within the search radius.
+        // This keeps the matrix structure fixed while contact pairs change, so that 
+        // the linear solver does not need to redo its symbolic factorization.
+        if (m_bpattern && (m_srad > 0))
+        {
+            ms.UpdateBVH();
+            FESurfaceBVH& bvh = ms.GetBVH();
+            vector<int> sel;
+            for (int j=0; j<ss.Elements(); ++j)
+            {
+                FESurfaceElement& se = ss.Element(j);
+
+                // find the center and radius of the element
+                int nseln = se.Nodes();
+                vec3d c(0,0,0);
+                for (int l=0; l<nseln; ++l) c += mesh.Node(se.m_node[l]).m_rt;
+                c /= (double) nseln;
+                double R = 0;
+                for (int l=0; l<nseln; ++l)
                 {
-                    FESurfaceElement& me = *pe;
-                    int* mn = &me.m_node[0];
-                    
-                    assign(lm, -1);
-                    
-                    int nseln = se.Nodes();
-                    int nmeln = me.Nodes();
-                    
-                    for (l=0; l<nseln; ++l)
-                    {
-                        vector<int>& id = mesh.Node(sn[l]).m_ID;
-                        lm[6*l  ] = id[dof_X];
-                        lm[6*l+1] = id[dof_Y];
-                        lm[6*l+2] = id[dof_Z];
-                        lm[6*l+3] = id[dof_RU];
-                        lm[6*l+4] = id[dof_RV];
-                        lm[6*l+5] = id[dof_RW];
-                    }
-                    
-                    for (l=0; l<nmeln; ++l)
-                    {
-                        vector<int>& id = mesh.Node(mn[l]).m_ID;
-                        lm[6*(l+nseln)  ] = id[dof_X];
-                        lm[6*(l+nseln)+1] = id[dof_Y];
-                        lm[6*(l+nseln)+2] = id[dof_Z];
-                        lm[6*(l+nseln)+3] = id[dof_RU];
-                        lm[6*(l+nseln)+4] = id[dof_RV];
-                        lm[6*(l+nseln)+5] = id[dof_RW];
-                    }
-                    
-                    K.build_add(lm);
+                    double r = (mesh.Node(se.m_node[l]).m_rt - c).norm();
+                    if (r > R) R = r;
                 }
+
+                sel.clear();
+                bvh.FindCandidates(c, R + m_srad, sel);
+                for (size_t l=0; l<sel.size(); ++l) addPair(se, ms.Element(sel[l]));
             }
         }
     }
@@ -526,29 +560,33 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
         for (int i=0; i<NN; ++i) normal[i].unit();
         if (ss.IsShellBottom()) for (int i=0; i<NN; ++i) normal[i] = -normal[i];
         
+        // project all nodes onto the secondary surface
+        vector<vec3d> rt(NN);
+        for (int i=0; i<NN; ++i)
+        {
+            FENode& node = ss.Node(i);
+            rt[i] = ss.IsShellBottom() ? node.st() : node.m_rt;
+        }
+        vector<FESurfaceElement*> pme;
+        vector<vec2d> rs;
+        np.Project(rt, normal, pme, rs);
+
         // loop over all nodes
         for (int i=0; i<NN; ++i)
         {
             FENode& node = ss.Node(i);
-            
-            // get the spatial nodal coordinates
-            vec3d rt = ss.IsShellBottom() ? node.st() : node.m_rt;
             vec3d nu = normal[i];
             
-            // project onto the secondary surface
-            vec3d q;
-            double rs[2] = {0,0};
-            FESurfaceElement* pme = np.Project(rt, nu, rs);
-            if (pme)
+            if (pme[i])
             {
                 // the node could potentially be in contact
                 // find the global location of the intersection point
-                vec3d q = ms.Local2Global(*pme, rs[0], rs[1]);
+                vec3d q = ms.Local2Global(*pme[i], rs[i][0], rs[i][1]);
                 
                 // calculate the gap function
                 // NOTE: this has the opposite sign compared
                 // to Gerard's notes.
-                double gap = nu*(rt - q);
+                double gap = nu*(rt[i] - q);
                 
                 if (gap>0) {
                     if (!ss.IsShellBottom()) {
@@ -960,8 +998,12 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingElasticSurface& ss = (np == 0? m_ss : m_ms);
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
+        // contact forces are accumulated per thread and combined after the loop
+        double fsx = 0, fsy = 0, fsz = 0;
+        double fmx = 0, fmy = 0, fmz = 0;
+
         // loop over all primary elements
-        //#pragma omp parallel for private(sLM, mLM, LM, en, fe, detJ, w, Hm, N)
+        #pragma omp parallel for schedule(dynamic) private(sLM, mLM, LM, en, fe, detJ, w, Hm, N) reduction(+:fsx, fsy, fsz, fmx, fmy, fmz)
         for (int i=0; i<ss.Elements(); ++i)
         {
             // get the surface element
@@ -1072,12 +1114,12 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
 							// calculate contact forces
 							for (int k = 0; k < nseln; ++k)
 							{
-								ss.m_Ft += vec3d(fe[k * 3], fe[k * 3 + 1], fe[k * 3 + 2]);
+								fsx += fe[k * 3]; fsy += fe[k * 3 + 1]; fsz += fe[k * 3 + 2];
 							}
 
 							for (int k = 0; k < nmeln; ++k)
 							{
-								ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+								fmx += fe[(k + nseln) * 3]; fmy += fe[(k + nseln) * 3 + 1]; fmz += fe[(k + nseln) * 3 + 2];
 							}
 
 							// assemble the global residual
@@ -1087,6 +1129,9 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
 				}
 			}
         }
+
+        ss.m_Ft += vec3d(fsx, fsy, fsz);
+        ms.m_Ft += vec3d(fmx, fmy, fmz);
     }
 }
 
@@ -1112,13 +1157,26 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
         // get the primary and secondary surface
         FESlidingElasticSurface& ss = (np == 0? m_ss : m_ms);
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
-        
+
+		// get the cached scatter maps and the offset of each element's first integration point.
+		// Each primary integration point has two maps, since the stick and slip matrices
+		// are assembled with different indices.
+		int NE = ss.Elements();
+		vector<int> ipoff(NE);
+		int nip = 0;
+		for (int i = 0; i < NE; ++i) { ipoff[i] = nip; nip += ss.Element(i).GaussPoints(); }
+		FEScatterMap* scatter = LS.GetScatterMaps(&ss, 2*nip);
+
         // loop over all primary elements
-        //#pragma omp parallel for private(detJ, w, Hm, N, sLM, mLM, LM, en, ke)
-		for (int i = 0; i < ss.Elements(); ++i)
+        #pragma omp parallel for schedule(dynamic) private(detJ, w, Hm, N, sLM, mLM, LM, en, ke)
+		for (int i = 0; i < NE; ++i)
 		{
 			// get ths primary element
 			FESurfaceElement& se = ss.Element(i);
+
+			// offset of this element's first integration point
+			int ip0 = ipoff[i];
+
 			if (se.isActive())
 			{
 				// get nr of nodes and integration points
@@ -1293,6 +1351,7 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
 								{
 									ke.SetNodes(en);
 									ke.SetIndices(LM);
+									ke.SetScatterMap(scatter ? scatter + 2*(ip0 + j) : nullptr);
 									LS.Assemble(ke);
 								}
 							}
@@ -1526,6 +1585,7 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
 								{
 									ke.SetNodes(en);
 									ke.SetIndices(LM);
+									ke.SetScatterMap(scatter ? scatter + 2*(ip0 + j) + 1 : nullptr);
 									LS.Assemble(ke);
 								}
 							}
@@ -165,6 +165,7 @@ public:
     double			m_stol;			//!< search tolerance
     bool			m_bsymm;		//!< use symmetric stiffness components only
     double			m_srad;			//!< contact search radius
+    bool			m_bpattern;		//!< reserve the matrix profile for all pairs within the search radius
     int				m_naugmax;		//!< maximum nr of augmentations
     int				m_naugmin;		//!< minimum nr of augmentations
     int				m_nsegup;		//!< segment update parameter
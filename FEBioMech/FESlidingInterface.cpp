@@ -726,6 +726,7 @@ void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 		// loop over all primary surface facets
 		int ne = ss.Elements();
+		#pragma omp parallel for schedule(dynamic) private(fe, lm, en, sLM, mLM, r0, w, Gr, Gs, detJ, dxr, dxs)
 		for (int j=0; j<ne; ++j)
 		{
 			// get the next element
@@ -1064,6 +1065,7 @@ void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 
 		// loop over all primary surface elements
 		int ne = ss.Elements();
+		#pragma omp parallel for schedule(dynamic) private(ke, lm, en, sLM, mLM, r0, w, Gr, Gs, detJ, dxr, dxs)
 		for (int j=0; j<ne; ++j)
 		{
 			// unpack the next element
@@ -1126,6 +1128,7 @@ void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 						for (int l=0; l<ndof; ++l) ke[k][l] *= detJ[n]*w[n];
 
 					// fill the lm array
+					lm.resize(3*(nmeln+1));
 					lm[0] = sLM[n*3  ];
 					lm[1] = sLM[n*3+1];
 					lm[2] = sLM[n*3+2];
@@ -0,0 +1,118 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/FESolidElement.h>
+#include <FECore/FEException.h>
+#include <FECore/fecore_enum.h>
+
+//-----------------------------------------------------------------------------
+//! Compile-time node and integration point counts of the solid element types that
+//! have specialized element kernels. Kernels templated on the element type use these
+//! counts for their loops and stack arrays, so that the compiler can unroll them.
+template <FE_Element_Type ET> struct FESolidKernelTraits {};
+
+template <> struct FESolidKernelTraits<FE_HEX8G8  > { enum { Nodes =  8, GaussPoints =  8 }; };
+template <> struct FESolidKernelTraits<FE_HEX8G1  > { enum { Nodes =  8, GaussPoints =  1 }; };
+template <> struct FESolidKernelTraits<FE_TET4G1  > { enum { Nodes =  4, GaussPoints =  1 }; };
+template <> struct FESolidKernelTraits<FE_TET4G4  > { enum { Nodes =  4, GaussPoints =  4 }; };
+template <> struct FESolidKernelTraits<FE_TET10G4 > { enum { Nodes = 10, GaussPoints =  4 }; };
+template <> struct FESolidKernelTraits<FE_TET10G8 > { enum { Nodes = 10, GaussPoints =  8 }; };
+template <> struct FESolidKernelTraits<FE_HEX20G8 > { enum { Nodes = 20, GaussPoints =  8 }; };
+template <> struct FESolidKernelTraits<FE_HEX20G27> { enum { Nodes = 20, GaussPoints = 27 }; };
+
+//-----------------------------------------------------------------------------
+//! Returns true if element type ntype has specialized kernels.
+inline bool FESolidElementHasKernel(int ntype)
+{
+	switch (ntype)
+	{
+	case FE_HEX8G8: case FE_HEX8G1:
+	case FE_TET4G1: case FE_TET4G4:
+	case FE_TET10G4: case FE_TET10G8:
+	case FE_HEX20G8: case FE_HEX20G27:
+		return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//! Calculates the spatial gradients G of the shape functions at integration point n 
+//! of an element of type ET, given the nodal coordinates x. Returns the Jacobian determinant.
+//! This evaluates the same expressions as FESolidDomain::ShapeGradient, but the 
+//! nodal coordinates are gathered only once per element by the caller.
+template <FE_Element_Type ET> inline double FESolidShapeGradient(const FESolidElement& el, int n, const vec3d* x, vec3d* G)
+{
+	const int NEN = FESolidKernelTraits<ET>::Nodes;
+
+	const double* Gr = el.Gr(n);
+	const double* Gs = el.Gs(n);
+	const double* Gt = el.Gt(n);
+
+	// calculate jacobian
+	double J[3][3] = { 0 };
+	for (int i = 0; i < NEN; ++i)
+	{
+		J[0][0] += Gr[i] * x[i].x; J[0][1] += Gs[i] * x[i].x; J[0][2] += Gt[i] * x[i].x;
+		J[1][0] += Gr[i] * x[i].y; J[1][1] += Gs[i] * x[i].y; J[1][2] += Gt[i] * x[i].y;
+		J[2][0] += Gr[i] * x[i].z; J[2][1] += Gs[i] * x[i].z; J[2][2] += Gt[i] * x[i].z;
+	}
+
+	// calculate the determinant
+	double det = J[0][0] * (J[1][1] * J[2][2] - J[1][2] * J[2][1])
+			   + J[0][1] * (J[1][2] * J[2][0] - J[2][2] * J[1][0])
+			   + J[0][2] * (J[1][0] * J[2][1] - J[1][1] * J[2][0]);
+
+	// make sure the determinant is positive
+	if (det <= 0) throw NegativeJacobian(el.GetID(), n + 1, det);
+
+	// calculate inverse jacobian
+	double deti = 1.0 / det;
+	double Ji[3][3];
+	Ji[0][0] = deti*(J[1][1] * J[2][2] - J[1][2] * J[2][1]);
+	Ji[1][0] = deti*(J[1][2] * J[2][0] - J[1][0] * J[2][2]);
+	Ji[2][0] = deti*(J[1][0] * J[2][1] - J[1][1] * J[2][0]);
+
+	Ji[0][1] = deti*(J[0][2] * J[2][1] - J[0][1] * J[2][2]);
+	Ji[1][1] = deti*(J[0][0] * J[2][2] - J[0][2] * J[2][0]);
+	Ji[2][1] = deti*(J[0][1] * J[2][0] - J[0][0] * J[2][1]);
+
+	Ji[0][2] = deti*(J[0][1] * J[1][2] - J[1][1] * J[0][2]);
+	Ji[1][2] = deti*(J[0][2] * J[1][0] - J[0][0] * J[1][2]);
+	Ji[2][2] = deti*(J[0][0] * J[1][1] - J[0][1] * J[1][0]);
+
+	// note that we need the transposed of Ji, not Ji itself !
+	for (int i = 0; i < NEN; ++i)
+	{
+		G[i].x = Ji[0][0] * Gr[i] + Ji[1][0] * Gs[i] + Ji[2][0] * Gt[i];
+		G[i].y = Ji[0][1] * Gr[i] + Ji[1][1] * Gs[i] + Ji[2][1] * Gt[i];
+		G[i].z = Ji[0][2] * Gr[i] + Ji[1][2] * Gs[i] + Ji[2][2] * Gt[i];
+	}
+
+	return det;
+}
@@ -52,6 +52,21 @@ double FESolidMaterial::Density(FEMaterialPoint& pt)
 	return m_density(pt);
 }
 
+//-----------------------------------------------------------------------------
+//! The default implementation evaluates the points one at a time. Materials can
+//! override this to evaluate all points of the batch at once.
+void FESolidMaterial::BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s)
+{
+	for (int i = 0; i < npts; ++i) s[i] = Stress(*mp[i]);
+}
+
+//-----------------------------------------------------------------------------
+void FESolidMaterial::BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c)
+{
+	for (int i = 0; i < npts; ++i) c[i] = Tangent(*mp[i]);
+}
+
+//-----------------------------------------------------------------------------
 tens4dmm FESolidMaterial::SolidTangent(FEMaterialPoint& mp)
 {
 	return (UseSecantTangent() ? SecantTangent(mp) : Tangent(mp));
@@ -47,6 +47,12 @@ public:
 	//! calculate tangent stiffness at material point
 	virtual tens4ds Tangent(FEMaterialPoint& pt) = 0;
 
+	//! calculate stress at a batch of material points
+	virtual void BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s);
+
+	//! calculate tangent stiffness at a batch of material points
+	virtual void BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c);
+
 	//! calculate the 2nd Piola-Kirchhoff stress at material point
 	virtual mat3ds PK2Stress(FEMaterialPoint& pt, const mat3ds E);
 
@@ -1455,7 +1455,11 @@ bool FESolidSolver2::Residual(vector<double>& R)
 	m_rigidSolver.Residual();
 
 	// calculate the internal (stress) forces
+	// (the partial vectors are summed once for all domains)
+	const bool bbuffered = RHS.ThreadBuffers();
+	if (bbuffered) RHS.BeginBufferedAssembly();
 	InternalForces(RHS);
+	if (bbuffered) RHS.EndBufferedAssembly();
 
 	// calculate nodal reaction forces
 	for (int i = 0; i < m_neq; ++i) m_Fr[i] -= R[i];
@@ -1539,6 +1543,11 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 	const FETimeInfo& tp = fem.GetTime();
 	FEMesh& mesh = fem.GetMesh();
 
+	// with buffered assembly, all external forces go to the partial vectors
+	// which are summed before the reaction forces are read below
+	const bool bbuffered = RHS.ThreadBuffers();
+	if (bbuffered) RHS.BeginBufferedAssembly();
+
 	// apply loads
 	for (int j = 0; j<fem.ModelLoads(); ++j)
 	{
@@ -1582,6 +1591,8 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 	// forces due to point constraints
 	//	for (i=0; i<(int) fem.m_PC.size(); ++i) fem.m_PC[i]->Residual(this, R);
 
+	if (bbuffered) RHS.EndBufferedAssembly();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (int i = 0; i<mesh.Nodes(); ++i)
@@ -194,6 +194,16 @@ void FEUT4Domain::Serialize(DumpStream& ar)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void FEUT4Domain::SerializeState(DumpStream& ar)
+{
+	FEElasticSolidDomain::SerializeState(ar);
+	ar & m_alpha & m_bdev;
+	ar & m_tag;
+	ar & m_NODE;
+	ar & m_Ve0;
+}
+
 //-----------------------------------------------------------------------------
 FEUT4Domain::~FEUT4Domain()
 {
@@ -62,6 +62,9 @@ public:
 	//! data serialization
 	void Serialize(DumpStream& ar) override;
 
+	//! serialize the shallow domain data (excluding material points)
+	void SerializeState(DumpStream& ar) override;
+
 	//! get nodal data
 	int UT4Nodes() { return (int) m_NODE.size(); }
 	UT4NODE& UT4Node(int i) { return m_NODE[i]; }
@@ -120,6 +120,53 @@ tens4ds FEUncoupledMaterial::Tangent(FEMaterialPoint &mp)
 	return DevTangent(mp) + (IxI - I4*2)*pt.m_p + IxI*(UJJ(pt.m_J)*pt.m_J);
 }
 
+//-----------------------------------------------------------------------------
+void FEUncoupledMaterial::BatchDevStress(FEMaterialPoint** mp, int npts, mat3ds* s)
+{
+	for (int i = 0; i < npts; ++i) s[i] = DevStress(*mp[i]);
+}
+
+//-----------------------------------------------------------------------------
+void FEUncoupledMaterial::BatchDevTangent(FEMaterialPoint** mp, int npts, tens4ds* c)
+{
+	for (int i = 0; i < npts; ++i) c[i] = DevTangent(*mp[i]);
+}
+
+//-----------------------------------------------------------------------------
+//! Batched version of Stress. The deviatoric stress is evaluated for all points
+//! at once, after which the pressure term is added.
+void FEUncoupledMaterial::BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s)
+{
+	BatchDevStress(mp, npts, s);
+	for (int i = 0; i < npts; ++i)
+	{
+		FEElasticMaterialPoint& pt = *mp[i]->ExtractData<FEElasticMaterialPoint>();
+		pt.m_p = UJ(pt.m_J);
+		s[i] += mat3dd(pt.m_p);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Batched version of Tangent.
+void FEUncoupledMaterial::BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c)
+{
+	BatchDevTangent(mp, npts, c);
+
+	// 4th-order identity tensors
+	mat3dd I(1);
+	tens4ds IxI = dyad1s(I);
+	tens4ds I4  = dyad4s(I);
+
+	for (int i = 0; i < npts; ++i)
+	{
+		FEElasticMaterialPoint& pt = *mp[i]->ExtractData<FEElasticMaterialPoint>();
+		pt.m_p = UJ(pt.m_J);
+		double a = pt.m_p + UJJ(pt.m_J)*pt.m_J;
+		double b = -2.0*pt.m_p;
+		for (int k = 0; k < tens4ds::NNZ; ++k) c[i].d[k] += IxI.d[k]*a + I4.d[k]*b;
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! The strain energy density function calculates the total sed as a sum of
 //! two terms, namely the deviatoric sed and U(J).
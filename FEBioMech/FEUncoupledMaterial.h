@@ -72,6 +72,12 @@ public:
 
 	//! Deviatoric strain energy density
 	virtual double DevStrainEnergyDensity(FEMaterialPoint& mp) { return 0; }
+
+	//! Deviatoric Cauchy stress at a batch of material points
+	virtual void BatchDevStress(FEMaterialPoint** mp, int npts, mat3ds* s);
+
+	//! Deviatoric spatial tangent at a batch of material points
+	virtual void BatchDevTangent(FEMaterialPoint** mp, int npts, tens4ds* c);
     
 public:
     virtual double StrongBondDevSED(FEMaterialPoint& pt) { return DevStrainEnergyDensity(pt); }
@@ -126,6 +132,12 @@ public:
 	//! total spatial tangent (do not overload!)
 	tens4ds Tangent(FEMaterialPoint& mp) final;
 
+	//! total Cauchy stress at a batch of points (do not overload!)
+	void BatchStress(FEMaterialPoint** mp, int npts, mat3ds* s) final;
+
+	//! total spatial tangent at a batch of points (do not overload!)
+	void BatchTangent(FEMaterialPoint** mp, int npts, tens4ds* c) final;
+
 	//! calculate strain energy (do not overload!)
 	double StrainEnergyDensity(FEMaterialPoint& pt) final;
     double StrongBondSED(FEMaterialPoint& pt) final;
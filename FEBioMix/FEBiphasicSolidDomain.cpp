@@ -34,6 +34,7 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FEBioMech/FEBioMech.h>
 #include <FECore/FELinearSystem.h>
+#include <FECore/FEScratch.h>
 #include "FEBioMix.h"
 
 //-----------------------------------------------------------------------------
@@ -266,9 +267,11 @@ void FEBiphasicSolidDomain::InternalForces(FEGlobalVector& R)
 	#pragma omp parallel for shared (NE)
 	for (int i=0; i<NE; ++i)
 	{
-		// element force vector
-		vector<double> fe;
-		vector<int> lm;
+		// element force vector (from the scratch pool of this thread)
+		FEScratch< vector<double> > pfe;
+		FEScratch< vector<int> > plm;
+		vector<double>& fe = pfe;
+		vector<int>& lm = plm;
 		
 		// get the element
 		FESolidElement& el = m_Elem[i];
@@ -392,9 +395,11 @@ void FEBiphasicSolidDomain::InternalForcesSS(FEGlobalVector& R)
 #pragma omp parallel for shared (NE)
     for (int i=0; i<NE; ++i)
     {
-        // element force vector
-        vector<double> fe;
-        vector<int> lm;
+        // element force vector (from the scratch pool of this thread)
+        FEScratch< vector<double> > pfe;
+        FEScratch< vector<int> > plm;
+        vector<double>& fe = pfe;
+        vector<int>& lm = plm;
         
         // get the element
         FESolidElement& el = m_Elem[i];
@@ -514,7 +519,9 @@ void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEScratch<FEElementMatrix> pke;
+		FEElementMatrix& ke = pke;
+		ke.SetNodes(el.m_node);
 		int ndof = el.Nodes()*4;
 		ke.resize(ndof, ndof);
 		
@@ -526,7 +533,8 @@ void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -547,7 +555,9 @@ void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEScratch<FEElementMatrix> pke;
+		FEElementMatrix& ke = pke;
+		ke.SetNodes(el.m_node);
 		int ndof = el.Nodes()*4;
 		ke.resize(ndof, ndof);
 		
@@ -559,7 +569,8 @@ void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 		// have to create a new lm array and place the equation numbers in the right order.
 		// What we really ought to do is fix the UnpackLM function so that it returns
 		// the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
 
@@ -1030,7 +1041,9 @@ void FEBiphasicSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
-		FEElementMatrix ke(el);
+		FEScratch<FEElementMatrix> pke;
+		FEElementMatrix& ke = pke;
+		ke.SetNodes(el.m_node);
         int neln = el.Nodes();
         int ndof = 4*neln;
         ke.resize(ndof, ndof);
@@ -1044,7 +1057,8 @@ void FEBiphasicSolidDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce&
         // have to create a new lm array and place the equation numbers in the right order.
         // What we really ought to do is fix the UnpackLM function so that it returns
         // the LM vector in the right order for poroelastic elements.
-		vector<int> lm;
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
         
@@ -1028,7 +1028,12 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface2& ss = (np == 0? m_ss : m_ms);
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
+		// contact forces are accumulated per thread and combined after the loop
+		double fsx = 0, fsy = 0, fsz = 0;
+		double fmx = 0, fmy = 0, fmz = 0;
+
 		// loop over all primary surface elements
+		#pragma omp parallel for schedule(dynamic) private(j, k, sLM, mLM, LM, en, fe, detJ, w, Hs, Hm, N) reduction(+:fsx, fsy, fsz, fmx, fmy, fmz)
 		for (i=0; i<ss.Elements(); ++i)
 		{
 			// get the surface element
@@ -1150,12 +1155,12 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 					for (k=0; k<nseln; ++k)
 					{
-						ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+						fsx += fe[k*3]; fsy += fe[k*3+1]; fsz += fe[k*3+2];
 					}
 
 					for (k = 0; k<nmeln; ++k)
 					{
-						ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+						fmx += fe[(k + nseln) * 3]; fmy += fe[(k + nseln) * 3 + 1]; fmz += fe[(k + nseln) * 3 + 2];
 					}
 
 					// assemble the global residual
@@ -1191,6 +1196,9 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 				}
 			}
 		}
+
+		ss.m_Ft += vec3d(fsx, fsy, fsz);
+		ms.m_Ft += vec3d(fmx, fmy, fmz);
 	}
 }
 
@@ -1236,6 +1244,7 @@ void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
+		#pragma omp parallel for schedule(dynamic) private(j, k, l, sLM, mLM, LM, en, detJ, w, Hs, Hm, pt, dpr, dps, N, ke)
 		for (i=0; i<ss.Elements(); ++i)
 		{
 			// get the next element
@@ -1165,7 +1165,12 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface3& ss = (np == 0? m_ss : m_ms);
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
+		// contact forces are accumulated per thread and combined after the loop
+		double fsx = 0, fsy = 0, fsz = 0;
+		double fmx = 0, fmy = 0, fmz = 0;
+
 		// loop over all primary surface elements
+		#pragma omp parallel for schedule(dynamic) private(sLM, mLM, LM, en, fe, detJ, w, Hs, Hm, N) reduction(+:fsx, fsy, fsz, fmx, fmy, fmz)
 		for (int i = 0; i<ss.Elements(); ++i)
 		{
 			// get the surface element
@@ -1289,12 +1294,12 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 					
                     for (int k=0; k<nseln; ++k)
                     {
-                        ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                        fsx += fe[k*3]; fsy += fe[k*3+1]; fsz += fe[k*3+2];
                     }
                     
                     for (int k = 0; k<nmeln; ++k)
                     {
-                        ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                        fmx += fe[(k + nseln) * 3]; fmy += fe[(k + nseln) * 3 + 1]; fmz += fe[(k + nseln) * 3 + 2];
                     }
                     
 					// assemble the global residual
@@ -1359,6 +1364,9 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 				}
 			}
 		}
+
+		ss.m_Ft += vec3d(fsx, fsy, fsz);
+		ms.m_Ft += vec3d(fmx, fmy, fmz);
 	}
 }
 
@@ -1406,6 +1414,7 @@ void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all primary surface elements
+		#pragma omp parallel for schedule(dynamic) private(j, k, l, sLM, mLM, LM, en, detJ, w, Hs, Hm, pt, dpr, dps, ct, dcr, dcs, N, ke)
 		for (i=0; i<ss.Elements(); ++i)
 		{
 			// get the next element
@@ -1431,7 +1431,12 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingSurfaceBiphasic& ss = (np == 0? m_ss : m_ms);
         FESlidingSurfaceBiphasic& ms = (np == 0? m_ms : m_ss);
         
+        // contact forces are accumulated per thread and combined after the loop
+        double fsx = 0, fsy = 0, fsz = 0;
+        double fmx = 0, fmy = 0, fmz = 0;
+
         // loop over all primary surface elements
+        #pragma omp parallel for schedule(dynamic) private(sLM, mLM, LM, en, fe, detJ, w, Hs, Hm, N) reduction(+:fsx, fsy, fsz, fmx, fmy, fmz)
         for (int i=0; i<ss.Elements(); ++i)
         {
             // get the surface element
@@ -1544,10 +1549,14 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
                         
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
-                            ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                        {
+                            fsx += fe[3*k]; fsy += fe[3*k+1]; fsz += fe[3*k+2];
+                        }
                         
                         for (int k = 0; k<nmeln; ++k)
-                            ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                        {
+                            fmx += fe[3*(k+nseln)]; fmy += fe[3*(k+nseln)+1]; fmz += fe[3*(k+nseln)+2];
+                        }
                         
                         // assemble the global residual
                         R.Assemble(en, LM, fe);
@@ -1583,6 +1592,9 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
                 }
             }
         }
+
+        ss.m_Ft += vec3d(fsx, fsy, fsz);
+        ms.m_Ft += vec3d(fmx, fmy, fmz);
     }
 }
 
@@ -1614,6 +1626,7 @@ void FESlidingInterfaceBiphasic::StiffnessMatrix(FELinearSystem& LS, const FETim
         FEMesh& mesh = *ms.GetMesh();
         
         // loop over all primary elements
+        #pragma omp parallel for schedule(dynamic) private(detJ, w, Hs, Hm, N, sLM, mLM, LM, en, ke)
         for (int i=0; i<ss.Elements(); ++i)
         {
             // get the primary element
@@ -1496,7 +1496,12 @@ void FESlidingInterfaceBiphasicMixed::LoadVector(FESlidingSurfaceBiphasicMixed&
     // need to multiply biphasic force entries by the timestep
     double dt = tp.timeIncrement;
     
+    // contact forces are accumulated per thread and combined after the loop
+    double fsx = 0, fsy = 0, fsz = 0;
+    double fmx = 0, fmy = 0, fmz = 0;
+
     // loop over all primary surface elements
+    #pragma omp parallel for schedule(dynamic) private(sLM, mLM, LM, en, fe, detJ, w, Hs, Hm, Hmp, N) reduction(+:fsx, fsy, fsz, fmx, fmy, fmz)
     for (int i=0; i<ss.Elements(); ++i)
     {
         // get the surface element
@@ -1611,10 +1616,14 @@ void FESlidingInterfaceBiphasicMixed::LoadVector(FESlidingSurfaceBiphasicMixed&
                         
                     // calculate contact forces
                     for (int k=0; k<nseln; ++k)
-                        ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                    {
+                        fsx += fe[3*k]; fsy += fe[3*k+1]; fsz += fe[3*k+2];
+                    }
                         
                     for (int k = 0; k<nmeln; ++k)
-                        ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                    {
+                        fmx += fe[3*(k+nseln)]; fmy += fe[3*(k+nseln)+1]; fmz += fe[3*(k+nseln)+2];
+                    }
                         
                     // assemble the global residual
                     R.Assemble(en, LM, fe);
@@ -1661,6 +1670,9 @@ void FESlidingInterfaceBiphasicMixed::LoadVector(FESlidingSurfaceBiphasicMixed&
             }
         }
     }
+
+    ss.m_Ft += vec3d(fsx, fsy, fsz);
+    ms.m_Ft += vec3d(fmx, fmy, fmz);
 }
 
 //-----------------------------------------------------------------------------
@@ -1704,6 +1716,7 @@ void FESlidingInterfaceBiphasicMixed::StiffnessMatrix(FESlidingSurfaceBiphasicMi
     FEMesh& mesh = *ms.GetMesh();
         
     // loop over all primary surface elements
+    #pragma omp parallel for schedule(dynamic) private(detJ, w, Hs, Hm, Hmp, N, H, sLM, mLM, LM, en, ke)
     for (int i=0; i<ss.Elements(); ++i)
     {
         // get the next element
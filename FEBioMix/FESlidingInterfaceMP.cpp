@@ -1811,7 +1811,12 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
         FESlidingSurfaceMP& ms = (np == 0? m_ms : m_ss);
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
+        // contact forces are accumulated per thread and combined after the loop
+        double fsx = 0, fsy = 0, fsz = 0;
+        double fmx = 0, fmy = 0, fmz = 0;
+
         // loop over all primary surface elements
+        #pragma omp parallel for schedule(dynamic) private(sLM, mLM, LM, en, fe, detJ, w, Hs, Hm, N) reduction(+:fsx, fsy, fsz, fmx, fmy, fmz)
         for (int i=0; i<ss.Elements(); ++i)
         {
             // get the surface element
@@ -1923,10 +1928,14 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
                         
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
-                            ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                        {
+                            fsx += fe[3*k]; fsy += fe[3*k+1]; fsz += fe[3*k+2];
+                        }
                         
                         for (int k = 0; k<nmeln; ++k)
-                            ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                        {
+                            fmx += fe[3*(k+nseln)]; fmy += fe[3*(k+nseln)+1]; fmz += fe[3*(k+nseln)+2];
+                        }
                         
                         // assemble the global residual
                         R.Assemble(en, LM, fe);
@@ -1992,6 +2001,9 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
                 }
             }
         }
+
+        ss.m_Ft += vec3d(fsx, fsy, fsz);
+        ms.m_Ft += vec3d(fmx, fmy, fmz);
     }
 }
 
@@ -2039,6 +2051,7 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
         // loop over all primary surface elements
+        #pragma omp parallel for schedule(dynamic) private(j, k, l, sLM, mLM, LM, en, detJ, w, Hs, Hm, ke) firstprivate(jn)
         for (i=0; i<ss.Elements(); ++i)
         {
             // get the next element
@@ -684,6 +684,9 @@ bool FEBioPlotFile::IsValid() const
 void FEBioPlotFile::Close()
 {
 	m_ar.Close();
+
+	// report a write that failed after the last state was written
+	if (m_ar.WriteFailed()) feLogError("Failed writing to plot file.");
 }
 
 //-----------------------------------------------------------------------------
@@ -709,6 +712,7 @@ bool FEBioPlotFile::Open(const char *szfile)
 	// set compression
 	FEPlotDataStore& pltData = fem->GetPlotDataStore();
 	SetCompression(pltData.GetPlotCompression());
+	m_ar.SetAsyncWrite(pltData.GetPlotAsyncWrite());
 
 	BuildDictionary();
 
@@ -1654,6 +1658,13 @@ bool FEBioPlotFile::Write(float ftime, int flag)
 	}
 	m_ar.EndChunk();
 
+	// In async mode, this reports a failure to write a previous state.
+	if (m_ar.WriteFailed())
+	{
+		feLogError("Failed writing to plot file.");
+		return false;
+	}
+
 	return true;
 }
 
@@ -1938,6 +1949,7 @@ bool FEBioPlotFile::Append(const char *szfile)
 	FEModel* fem = GetFEModel();
 	FEPlotDataStore& pltData = fem->GetPlotDataStore();
 	SetCompression(pltData.GetPlotCompression());
+	m_ar.SetAsyncWrite(pltData.GetPlotAsyncWrite());
 
 	// add plot variables
 	for (int n = 0; n < pltData.PlotVariables(); ++n)
@@ -32,7 +32,6 @@ SOFTWARE.*/
 
 #ifdef HAVE_ZLIB
 #include "zlib.h"
-static z_stream strm;
 #endif
 
 //=============================================================================
@@ -47,6 +46,12 @@ FileStream::FileStream(FILE* fp, bool owner)
 	m_ncompress = 0;
 	m_fp = fp;
 	m_fileOwner = owner;
+	m_berror = false;
+#ifdef HAVE_ZLIB
+	m_strm = new z_stream();
+#else
+	m_strm = nullptr;
+#endif
 }
 
 FileStream::~FileStream()
@@ -56,10 +61,15 @@ FileStream::~FileStream()
 	delete [] m_pout;
 	m_buf = 0;
 	m_pout = 0;
+#ifdef HAVE_ZLIB
+	delete (z_stream*)m_strm;
+#endif
+	m_strm = nullptr;
 }
 
 bool FileStream::Open(const char* szfile)
 {
+	m_berror = false;
 	m_fp = fopen(szfile, "rb");
 	if (m_fp == 0) return false;
 	return true;
@@ -67,12 +77,14 @@ bool FileStream::Open(const char* szfile)
 
 bool FileStream::Append(const char* szfile)
 {
+	m_berror = false;
 	m_fp = fopen(szfile, "a+b");
 	return (m_fp != 0);
 }
 
 bool FileStream::Create(const char* szfile)
 {
+	m_berror = false;
 	m_fp = fopen(szfile, "wb");
 	return (m_fp != 0);
 }
@@ -90,6 +102,7 @@ void FileStream::Close()
 void FileStream::BeginStreaming()
 {
 #ifdef HAVE_ZLIB
+	z_stream& strm = *(z_stream*)m_strm;
 	if (m_ncompress)
 	{
 		strm.zalloc = Z_NULL;
@@ -104,6 +117,7 @@ void FileStream::EndStreaming()
 {
 	Flush();
 #ifdef HAVE_ZLIB
+	z_stream& strm = *(z_stream*)m_strm;
 	if (m_ncompress)
 	{
 		strm.avail_in = 0;
@@ -117,14 +131,14 @@ void FileStream::EndStreaming()
 			int ret = deflate(&strm, Z_FINISH);    /* no bad return value */
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
 			int have = m_bufsize - strm.avail_out;
-			fwrite(m_pout, 1, have, m_fp);
+			if ((int)fwrite(m_pout, 1, have, m_fp) != have) m_berror = true;
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
 
 		// all done
 		deflateEnd(&strm);
 
-		fflush(m_fp);
+		if (fflush(m_fp) != 0) m_berror = true;
 	}
 #endif
 }
@@ -155,6 +169,7 @@ void FileStream::Write(void* pd, size_t Size, size_t Count)
 void FileStream::Flush()
 {
 #ifdef HAVE_ZLIB
+	z_stream& strm = *(z_stream*)m_strm;
 	if (m_ncompress)
 	{
 		strm.avail_in = m_current;
@@ -168,20 +183,20 @@ void FileStream::Flush()
 			int ret = deflate(&strm, Z_NO_FLUSH);    /* no bad return value */
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
 			int have = m_bufsize - strm.avail_out;
-			fwrite(m_pout, 1, have, m_fp);
+			if ((int)fwrite(m_pout, 1, have, m_fp) != have) m_berror = true;
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
 	}
 	else
 	{
-		if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
+		if (m_fp && (m_current > 0) && (fwrite(m_buf, m_current, 1, m_fp) != 1)) m_berror = true;
 	}
 #else
-	if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
+	if (m_fp && (m_current > 0) && (fwrite(m_buf, m_current, 1, m_fp) != 1)) m_berror = true;
 #endif
 
 	// flush the file
-	if (m_fp) fflush(m_fp);
+	if (m_fp && (fflush(m_fp) != 0)) m_berror = true;
 
 	// reset current data pointer
 	m_current = 0;
@@ -213,6 +228,13 @@ PltArchive::PltArchive()
 	m_pRoot = 0;
 	m_pChunk = 0;
 	m_bSaving = true;
+	m_ncompress = 0;
+
+	m_async = false;
+	m_stop = false;
+	m_pending = nullptr;
+	m_pendingCompress = 0;
+	m_werror = false;
 }
 
 PltArchive::~PltArchive()
@@ -225,6 +247,9 @@ void PltArchive::Close()
 	if (m_bSaving)
 	{
 		if (m_pRoot) Flush();
+
+		// make sure the writer thread is done
+		SetAsyncWrite(false);
 	}
 	else 
 	{
@@ -243,26 +268,118 @@ void PltArchive::Close()
 
 void PltArchive::SetCompression(int n)
 {
-	if (m_fp) m_fp->SetCompression(n);
+	m_ncompress = n;
 }
 
 void PltArchive::Flush()
 {
-	if (m_fp && m_pRoot)
+	// wait for the writer thread first so that the trees are written in order
+	Wait();
+	if (WriteTree(m_pRoot, m_ncompress) == false)
 	{
-		m_fp->BeginStreaming();
-		m_pRoot->Write(m_fp);
-		m_fp->EndStreaming();
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_werror = true;
 	}
-	delete m_pRoot;
 	m_pRoot = 0;
 	m_pChunk = 0;
 }
 
+// write a chunk tree to file and delete it
+bool PltArchive::WriteTree(OBranch* root, int ncompress)
+{
+	bool bok = true;
+	if (m_fp && root)
+	{
+		m_fp->SetCompression(ncompress);
+		m_fp->BeginStreaming();
+		root->Write(m_fp);
+		m_fp->EndStreaming();
+		m_fp->SetCompression(0);
+		bok = (m_fp->HasError() == false);
+	}
+	delete root;
+	return bok;
+}
+
+bool PltArchive::WriteFailed()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	bool b = m_werror;
+	m_werror = false;
+	return b;
+}
+
+// In async mode, a completed chunk tree is handed to a writer thread, which
+// compresses and writes it while the caller builds the next tree. At most one
+// tree is in flight, so the caller blocks if the writer falls behind.
+void PltArchive::SetAsyncWrite(bool b)
+{
+	if (b == m_async) return;
+
+	if (b)
+	{
+		m_stop = false;
+		m_writer = std::thread(&PltArchive::WriterThread, this);
+	}
+	else
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_cv.notify_all();
+		m_writer.join();
+	}
+	m_async = b;
+}
+
+void PltArchive::Wait()
+{
+	if (m_async == false) return;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cv.wait(lock, [this]() { return (m_pending == nullptr); });
+}
+
+void PltArchive::Submit(OBranch* root)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cv.wait(lock, [this]() { return (m_pending == nullptr); });
+	m_pending = root;
+	m_pendingCompress = m_ncompress;
+	lock.unlock();
+	m_cv.notify_all();
+}
+
+void PltArchive::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_cv.wait(lock, [this]() { return ((m_pending != nullptr) || m_stop); });
+		if (m_pending)
+		{
+			OBranch* root = m_pending;
+			int ncompress = m_pendingCompress;
+
+			// the tree is only accessed by this thread from now on
+			lock.unlock();
+			bool bok = WriteTree(root, ncompress);
+			lock.lock();
+
+			// the error is reported by the next call to WriteFailed
+			if (bok == false) m_werror = true;
+			m_pending = nullptr;
+			m_cv.notify_all();
+		}
+		else break;
+	}
+}
+
 bool PltArchive::Create(const char* szfile)
 {
 	// attempt to create the file
 	assert(m_fp == 0);
+	m_werror = false;
 	m_fp = new FileStream();
 	if (m_fp->Create(szfile) == false) return false;
 
@@ -299,6 +416,12 @@ void PltArchive::EndChunk()
 {
 	if (m_pChunk != m_pRoot)
 		m_pChunk = m_pChunk->GetParent();
+	else if (m_async)
+	{
+		Submit(m_pRoot);
+		m_pRoot = 0;
+		m_pChunk = 0;
+	}
 	else 
 	{
 		Flush();
@@ -331,6 +454,7 @@ bool PltArchive::Append(const char* szfile)
 {
 	// reopen the plot file for appending
 	assert(m_fp == 0);
+	m_werror = false;
 	m_fp = new FileStream();
 	if (m_fp->Append(szfile) == false) return false;
 	m_bSaving = true;
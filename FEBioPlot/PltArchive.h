@@ -34,6 +34,9 @@ SOFTWARE.*/
 #include <list>
 #include <vector>
 #include <stack>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 //-----------------------------------------------------------------------------
 enum IOResult { IO_ERROR, IO_OK, IO_END };
@@ -69,14 +72,19 @@ public:
 
 	bool IsValid() { return (m_fp != nullptr); }
 
+	//! returns true if writing to the file failed
+	bool HasError() const { return m_berror; }
+
 private:
 	FILE*	m_fp;
+	bool	m_berror;		//!< a write to the file failed
 	bool	m_fileOwner;
 	size_t	m_bufsize;		//!< buffer size
 	size_t	m_current;		//!< current index
 	unsigned char*	m_buf;	//!< buffer
 	unsigned char*	m_pout;	//!< temp buffer when writing
 	int		m_ncompress;	//!< compression level
+	void*	m_strm;			//!< compression stream
 };
 
 class OBranch;
@@ -265,6 +273,12 @@ public:
 	// flush data to file
 	void Flush();
 
+	// Write the chunk trees on a background thread
+	void SetAsyncWrite(bool b);
+
+	// wait until all pending data was written
+	void Wait();
+
 public:
 	// --- Writing ---
 
@@ -352,6 +366,11 @@ public:
 
 	bool IsValid() const { return (m_fp != 0); }
 
+	// Returns true if a chunk tree could not be written since the last call. In async mode,
+	// a failed write is only detected after the tree was handed to the writer thread, so
+	// it is reported by a later call.
+	bool WriteFailed();
+
 protected:
 	FileStream*	m_fp;		// pointer to file stream
 	bool		m_bSaving;	// read or write mode?
@@ -363,4 +382,27 @@ protected:
 	// read data
 	bool			m_bend;		// chunk end flag
 	std::stack<CHUNK*>	m_Chunk;
+
+protected:
+	// write a chunk tree to file and delete it (returns false if the write failed)
+	bool WriteTree(OBranch* root, int ncompress);
+
+	// hand a chunk tree to the writer thread
+	void Submit(OBranch* root);
+
+	// writer thread function
+	void WriterThread();
+
+protected:
+	int			m_ncompress;	// compression level of next chunk tree
+
+	// async writing
+	bool		m_async;		// write on background thread
+	bool		m_stop;			// signals the writer thread to stop
+	OBranch*	m_pending;		// chunk tree that is being written
+	int			m_pendingCompress;	// compression level of pending tree
+	bool		m_werror;		// a chunk tree could not be written
+	std::thread	m_writer;		// the writer thread
+	std::mutex	m_mutex;
+	std::condition_variable	m_cv;
 };
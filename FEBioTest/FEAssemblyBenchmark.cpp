@@ -0,0 +1,236 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "FEAssemblyBenchmark.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FEDomain.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/FEScratch.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <stdlib.h>
+#include <math.h>
+#include <atomic>
+#include <new>
+
+//-----------------------------------------------------------------------------
+// To verify that the assembly loops don't allocate, the global operator new is replaced
+// by a version that counts the heap allocations while the benchmark is timing.
+// (On Windows, this does not see the allocations made inside the DLLs.)
+static std::atomic<bool>	count_heap_allocations(false);
+static std::atomic<size_t>	heap_allocations(0);
+
+void* operator new(size_t n)
+{
+	if (count_heap_allocations.load(std::memory_order_relaxed)) heap_allocations++;
+	void* p = malloc(n > 0 ? n : 1);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+// start counting the heap allocations
+static void start_heap_count()
+{
+	heap_allocations = 0;
+	count_heap_allocations = true;
+}
+
+// stop counting and return the nr of heap allocations
+static size_t stop_heap_count()
+{
+	count_heap_allocations = false;
+	return heap_allocations;
+}
+
+//-----------------------------------------------------------------------------
+FEAssemblyBenchmark::FEAssemblyBenchmark(FEModel* fem) : FECoreTask(fem)
+{
+	m_iters = 10;
+	m_bdone = false;
+}
+
+//-----------------------------------------------------------------------------
+// The (optional) argument is the number of assemblies for each mode.
+bool FEAssemblyBenchmark::Init(const char* szarg)
+{
+	if (szarg && szarg[0])
+	{
+		m_iters = atoi(szarg);
+		if (m_iters <= 0) return false;
+	}
+	return GetFEModel()->Init();
+}
+
+//-----------------------------------------------------------------------------
+bool assembly_benchmark_cb(FEModel* fem, unsigned int when, void* pd)
+{
+	FEAssemblyBenchmark* benchmark = (FEAssemblyBenchmark*)pd;
+	return benchmark->Benchmark();
+}
+
+//-----------------------------------------------------------------------------
+bool FEAssemblyBenchmark::Run()
+{
+	FEModel& fem = *GetFEModel();
+	fem.AddCallback(assembly_benchmark_cb, CB_MATRIX_REFORM, (void*)this);
+
+	bool bret = fem.Solve();
+	if (m_bdone == false)
+	{
+		feLogError("No stiffness matrix was formed. Aborting benchmark.\n");
+		return false;
+	}
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+bool FEAssemblyBenchmark::Benchmark()
+{
+	// we only need to do this once
+	if (m_bdone) return true;
+
+	FEModel* fem = GetFEModel();
+	FEAnalysis* step = fem->GetCurrentStep();
+	if (step == nullptr) return false;
+
+	FENewtonSolver* nlsolve = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	if ((nlsolve == nullptr) || (nlsolve->m_pK == nullptr)) return false;
+
+	FEGlobalMatrix& K = *nlsolve->m_pK;
+	SparseMatrix* pA = K.GetSparseMatrixPtr();
+	if (pA == nullptr) return false;
+	m_bdone = true;
+
+	// report the element colors
+	FEMesh& mesh = fem->GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		feLog("\tdomain %d: %d elements, %d colors\n", i + 1, dom.Elements(), dom.ElementColors());
+	}
+
+	const bool bcolored = K.ColoredAssembly();
+	const size_t nnz = pA->NonZeroes();
+	std::vector<double> A[2];
+	double time[2] = { 0.0, 0.0 };
+	size_t nalloc[2] = { 0, 0 };
+	size_t nheap[2] = { 0, 0 };
+	for (int mode = 0; mode < 2; ++mode)
+	{
+		K.SetColoredAssembly(mode == 1);
+
+		Timer timer;
+		timer.start();
+		for (int n = 0; n < m_iters; ++n)
+		{
+			// count the allocations after the first assembly
+			if (n == 1) { FEScratchCounter::Reset(); start_heap_count(); }
+
+			K.Zero();
+			zero(nlsolve->m_Fd);
+			nlsolve->StiffnessMatrix();
+		}
+		timer.stop();
+		time[mode] = timer.GetTime();
+		nheap[mode] = stop_heap_count();
+		nalloc[mode] = (m_iters > 1 ? FEScratchCounter::Allocations() : 0);
+
+		double* pv = pA->Values();
+		if (pv) A[mode].assign(pv, pv + nnz);
+	}
+	K.SetColoredAssembly(bcolored);
+
+	// The callback is invoked after the matrix was factored, and the assemblies above
+	// overwrote the matrix, which may hold the factorization. So we need to factor again.
+	if (nlsolve->m_plinsolve->Factor() == false) return false;
+
+	// compare the assembled matrices
+	double maxdiff = 0.0, maxval = 0.0;
+	for (size_t i = 0; i < A[0].size(); ++i)
+	{
+		double d = fabs(A[1][i] - A[0][i]);
+		if (d > maxdiff) maxdiff = d;
+		if (fabs(A[0][i]) > maxval) maxval = fabs(A[0][i]);
+	}
+
+	// time the residual evaluation with atomic and with buffered assembly
+	const bool bbuffered = nlsolve->m_bbuffered_residual;
+	std::vector<double> R[2];
+	double timeR[2] = { 0.0, 0.0 };
+	size_t nallocR = 0, nheapR = 0;
+	for (int mode = 0; mode < 2; ++mode)
+	{
+		nlsolve->m_bbuffered_residual = (mode == 1);
+		R[mode].assign(nlsolve->m_R1.size(), 0.0);
+
+		Timer timer;
+		timer.start();
+		for (int n = 0; n < m_iters; ++n)
+		{
+			if (n == 1) { FEScratchCounter::Reset(); start_heap_count(); }
+			nlsolve->Residual(R[mode]);
+		}
+		timer.stop();
+		timeR[mode] = timer.GetTime();
+		nheapR += stop_heap_count();
+		if (m_iters > 1) nallocR += FEScratchCounter::Allocations();
+	}
+	nlsolve->m_bbuffered_residual = bbuffered;
+
+	// compare the residuals
+	double maxdiffR = 0.0, maxvalR = 0.0;
+	for (size_t i = 0; i < R[0].size(); ++i)
+	{
+		double d = fabs(R[1][i] - R[0][i]);
+		if (d > maxdiffR) maxdiffR = d;
+		if (fabs(R[0][i]) > maxvalR) maxvalR = fabs(R[0][i]);
+	}
+
+	feLog("\nAssembly benchmark (%d assemblies, %d nonzeroes):\n", m_iters, (int)nnz);
+	feLog("\tatomic assembly .......... : %lg sec\n", time[0]);
+	feLog("\tcolored assembly ......... : %lg sec\n", time[1]);
+	feLog("\tscratch allocations ...... : %d (atomic), %d (colored), %d (residual)\n", (int)nalloc[0], (int)nalloc[1], (int)nallocR);
+	feLog("\theap allocations ......... : %d (atomic), %d (colored), %d (residual)\n", (int)nheap[0], (int)nheap[1], (int)nheapR);
+	if (time[1] > 0.0) feLog("\tspeedup .................. : %lg\n", time[0] / time[1]);
+	if (maxval > 0.0) feLog("\trelative difference ...... : %lg\n", maxdiff / maxval);
+	feLog("\tatomic residual .......... : %lg sec\n", timeR[0]);
+	feLog("\tbuffered residual ........ : %lg sec\n", timeR[1]);
+	if (timeR[1] > 0.0) feLog("\tspeedup .................. : %lg\n", timeR[0] / timeR[1]);
+	if (maxvalR > 0.0) feLog("\trelative difference ...... : %lg\n", maxdiffR / maxvalR);
+	feLog("\n");
+
+	return true;
+}
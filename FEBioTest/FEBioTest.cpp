@@ -36,6 +36,8 @@ SOFTWARE.*/
 #include "FEMaterialTest.h"
 #include "FEResetTest.h"
 #include "FEStiffnessDiagnostic.h"
+#include "FEAssemblyBenchmark.h"
+#include "FESpMVBenchmark.h"
 
 namespace FEBioTest
 {
@@ -48,5 +50,7 @@ void InitModule()
 	REGISTER_FECORE_CLASS(FEResetTest, "reset_test");
 	REGISTER_FECORE_CLASS(FEMaterialTest, "material test");
 	REGISTER_FECORE_CLASS(FEStiffnessDiagnostic, "stiffness_test");
+	REGISTER_FECORE_CLASS(FEAssemblyBenchmark, "assembly_benchmark");
+	REGISTER_FECORE_CLASS(FESpMVBenchmark, "spmv_benchmark");
 }
 }
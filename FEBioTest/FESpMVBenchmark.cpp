@@ -0,0 +1,190 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FESpMVBenchmark.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/SELLMatrix.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <stdlib.h>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+FESpMVBenchmark::FESpMVBenchmark(FEModel* fem) : FECoreTask(fem)
+{
+	m_iters = 100;
+	m_bdone = false;
+}
+
+//-----------------------------------------------------------------------------
+// The (optional) argument is the number of products for each mode.
+bool FESpMVBenchmark::Init(const char* szarg)
+{
+	if (szarg && szarg[0])
+	{
+		m_iters = atoi(szarg);
+		if (m_iters <= 0) return false;
+	}
+	return GetFEModel()->Init();
+}
+
+//-----------------------------------------------------------------------------
+bool spmv_benchmark_cb(FEModel* fem, unsigned int when, void* pd)
+{
+	FESpMVBenchmark* benchmark = (FESpMVBenchmark*)pd;
+	return benchmark->Benchmark();
+}
+
+//-----------------------------------------------------------------------------
+bool FESpMVBenchmark::Run()
+{
+	FEModel& fem = *GetFEModel();
+	fem.AddCallback(spmv_benchmark_cb, CB_MATRIX_REFORM, (void*)this);
+
+	bool bret = fem.Solve();
+	if (m_bdone == false)
+	{
+		feLogError("No stiffness matrix was formed. Aborting benchmark.\n");
+		return false;
+	}
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+// time a number of products and return the time per product in t.
+// Returns false if the operator does not implement the product.
+static bool time_product(MatrixOperator& A, std::vector<double>& x, std::vector<double>& y, int iters, double& t)
+{
+	// the first product is not timed, since it may set up additional data
+	t = 0.0;
+	if (A.mult_vector(&x[0], &y[0]) == false) return false;
+
+	Timer timer;
+	timer.start();
+	for (int n = 0; n < iters; ++n) A.mult_vector(&x[0], &y[0]);
+	timer.stop();
+	t = timer.GetTime() / iters;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// return the max difference between two vectors, relative to the max norm of a
+static double relative_difference(const std::vector<double>& a, const std::vector<double>& b)
+{
+	double maxdiff = 0.0, maxval = 0.0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		double d = fabs(a[i] - b[i]);
+		if (d > maxdiff) maxdiff = d;
+		if (fabs(a[i]) > maxval) maxval = fabs(a[i]);
+	}
+	return (maxval > 0.0 ? maxdiff / maxval : maxdiff);
+}
+
+//-----------------------------------------------------------------------------
+bool FESpMVBenchmark::Benchmark()
+{
+	// we only need to do this once
+	if (m_bdone) return true;
+
+	FEModel* fem = GetFEModel();
+	FEAnalysis* step = fem->GetCurrentStep();
+	if (step == nullptr) return false;
+
+	FENewtonSolver* nlsolve = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	if ((nlsolve == nullptr) || (nlsolve->m_pK == nullptr)) return false;
+
+	FEGlobalMatrix& K = *nlsolve->m_pK;
+	SparseMatrix* pA = K.GetSparseMatrixPtr();
+	if ((pA == nullptr) || (pA->Rows() == 0)) return false;
+	m_bdone = true;
+
+	// Assemble the stiffness matrix. Note that this overwrites the matrix, which
+	// may hold the factorization, so we have to factor it again when we're done.
+	K.Zero();
+	zero(nlsolve->m_Fd);
+	nlsolve->StiffnessMatrix();
+
+	const int N = pA->Rows();
+	std::vector<double> x(N), y0(N), y(N);
+	for (int i = 0; i < N; ++i) x[i] = 1.0 + 0.1*(i % 7);
+
+	feLog("\nSpMV benchmark (%d products, %d equations, %d nonzeroes):\n", m_iters, N, (int)pA->NonZeroes());
+
+	// The symmetric matrix has a serial and a threaded product.
+	CompactSymmMatrix* pS = dynamic_cast<CompactSymmMatrix*>(pA);
+	double t0 = 0.0;
+	bool bprod = true;
+	if (pS)
+	{
+		const bool bparallel = pS->ParallelMultiply();
+		pS->SetParallelMultiply(false);
+		time_product(*pA, x, y0, m_iters, t0);
+		feLog("\tserial product ........... : %lg sec\n", t0);
+
+		pS->SetParallelMultiply(true);
+		double t1 = 0.0;
+		time_product(*pA, x, y, m_iters, t1);
+		pS->SetParallelMultiply(bparallel);
+		feLog("\tthreaded product ......... : %lg sec (speedup %lg, relative difference %lg)\n", t1, (t1 > 0.0 ? t0 / t1 : 0.0), relative_difference(y0, y));
+	}
+	else
+	{
+		bprod = time_product(*pA, x, y0, m_iters, t0);
+		if (bprod) feLog("\tmatrix product ........... : %lg sec\n", t0);
+		else feLog("\tmatrix product ........... : not supported for this matrix format\n");
+	}
+
+	// the SELL-C-sigma copy (this needs the reference product for comparison)
+	SELLMatrix sell;
+	Timer timer;
+	timer.start();
+	bool bsell = (bprod && sell.Create(pA));
+	timer.stop();
+	if (bsell)
+	{
+		double t2 = 0.0;
+		time_product(sell, x, y, m_iters, t2);
+		feLog("\tSELL-C-sigma setup ....... : %lg sec (fill ratio %lg)\n", timer.GetTime(), (double)sell.StoredValues() / (double)sell.NonZeroes());
+		feLog("\tSELL-C-sigma product ..... : %lg sec (speedup %lg, relative difference %lg)\n", t2, (t2 > 0.0 ? t0 / t2 : 0.0), relative_difference(y0, y));
+	}
+	else feLog("\tSELL-C-sigma ............. : not supported for this matrix format\n");
+	feLog("\n");
+
+	// The callback is invoked after the matrix was factored, so we need to restore the factorization.
+	if (nlsolve->m_plinsolve->Factor() == false) return false;
+
+	return true;
+}
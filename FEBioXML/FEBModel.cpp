@@ -33,6 +33,10 @@ SOFTWARE.*/
 #include <FECore/FEMaterial.h>
 #include <FECore/FEDomain.h>
 #include <FECore/FEShellDomain.h>
+#include <FECore/FEElementLibrary.h>
+#include <FECore/FEElementTraits.h>
+#include <FECore/FEMeshReorder.h>
+#include <algorithm>
 #include <FECore/log.h>
 using namespace std;
 
@@ -132,6 +136,7 @@ FEBModel::Domain::Domain(const FEBModel::Domain& dom)
 	m_spec = dom.m_spec;
 	m_name = dom.m_name;
 	m_matName = dom.m_matName;
+	m_typeName = dom.m_typeName;
 	m_Elem = dom.m_Elem;
 	m_defaultShellThickness = dom.m_defaultShellThickness;
 }
@@ -233,6 +238,142 @@ void FEBModel::Part::AddNodes(const std::vector<NODE>& nodes)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// Reorder the nodes and the elements of each domain for better memory locality.
+// All the other data of the part refers to nodes and elements via their IDs, so
+// only the node list and the element lists need to be permuted.
+void FEBModel::Part::Reorder(int method)
+{
+	int NN = Nodes();
+	if ((method == FEMeshReorder::REORDER_NONE) || (NN == 0)) return;
+
+	// build node-index lookup table
+	int noff = -1, maxID = 0;
+	for (int i = 0; i < NN; ++i)
+	{
+		int nid = m_Node[i].id;
+		if ((noff < 0) || (nid < noff)) noff = nid;
+		if (nid > maxID) maxID = nid;
+	}
+	vector<int> NLT(maxID - noff + 1, -1);
+	for (int i = 0; i < NN; ++i) NLT[m_Node[i].id - noff] = i;
+	auto nodeIndex = [&](int nid) {
+		nid -= noff;
+		return ((nid >= 0) && (nid < (int)NLT.size()) ? NLT[nid] : -1);
+	};
+
+	// number of nodes of the elements of a domain
+	auto elementNodes = [](const Domain& dom) {
+		FEElementTraits* traits = FEElementLibrary::GetElementTraits(dom.ElementSpec().etype);
+		return (traits ? traits->m_neln : 0);
+	};
+
+	// calculate the new node order
+	vector<int> P;
+	if (method == FEMeshReorder::REORDER_RCM)
+	{
+		// build the node graph
+		vector< vector<int> > NNL(NN);
+		vector<int> en(FEElement::MAX_NODES);
+		for (Domain* dom : m_Dom)
+		{
+			int NE = dom->Elements();
+			int neln = elementNodes(*dom);
+			for (int i = 0; i < NE; ++i)
+			{
+				const ELEMENT& el = dom->GetElement(i);
+				int nn = 0;
+				for (int j = 0; j < neln; ++j)
+				{
+					int nj = nodeIndex(el.node[j]);
+					if (nj >= 0) en[nn++] = nj;
+				}
+
+				for (int j = 0; j < nn; ++j)
+					for (int k = 0; k < nn; ++k)
+						if (en[j] != en[k]) NNL[en[j]].push_back(en[k]);
+			}
+		}
+
+		// convert to compressed row format
+		vector<int> ptr(NN + 1, 0), ind;
+		for (int i = 0; i < NN; ++i)
+		{
+			vector<int>& ni = NNL[i];
+			sort(ni.begin(), ni.end());
+			ni.erase(unique(ni.begin(), ni.end()), ni.end());
+			ptr[i + 1] = ptr[i] + (int)ni.size();
+		}
+		ind.reserve(ptr[NN]);
+		for (int i = 0; i < NN; ++i) ind.insert(ind.end(), NNL[i].begin(), NNL[i].end());
+
+		FEMeshReorder::RCMOrder(ptr, ind, P);
+	}
+	else
+	{
+		vector<vec3d> r(NN);
+		for (int i = 0; i < NN; ++i) r[i] = m_Node[i].r;
+		FEMeshReorder::CurveOrder(method, r, P);
+	}
+
+	// permute the nodes
+	vector<NODE> oldNodes(m_Node);
+	vector<int> newIndex(NN);
+	for (int i = 0; i < NN; ++i)
+	{
+		m_Node[i] = oldNodes[P[i]];
+		newIndex[P[i]] = i;
+	}
+
+	// reorder the elements of each domain
+	for (Domain* dom : m_Dom)
+	{
+		int NE = dom->Elements();
+		int neln = elementNodes(*dom);
+		if ((NE < 2) || (neln == 0)) continue;
+
+		vector<int> Q;
+		if (method == FEMeshReorder::REORDER_RCM)
+		{
+			// sort the elements by their lowest (new) node index
+			vector<int> key(NE, NN);
+			for (int i = 0; i < NE; ++i)
+			{
+				const ELEMENT& el = dom->GetElement(i);
+				for (int j = 0; j < neln; ++j)
+				{
+					int nj = nodeIndex(el.node[j]);
+					if ((nj >= 0) && (newIndex[nj] < key[i])) key[i] = newIndex[nj];
+				}
+			}
+
+			Q.resize(NE);
+			for (int i = 0; i < NE; ++i) Q[i] = i;
+			stable_sort(Q.begin(), Q.end(), [&](int a, int b) { return key[a] < key[b]; });
+		}
+		else
+		{
+			// sort the element centroids along the curve
+			vector<vec3d> c(NE, vec3d(0, 0, 0));
+			for (int i = 0; i < NE; ++i)
+			{
+				const ELEMENT& el = dom->GetElement(i);
+				int nn = 0;
+				for (int j = 0; j < neln; ++j)
+				{
+					int nj = nodeIndex(el.node[j]);
+					if (nj >= 0) { c[i] += oldNodes[nj].r; nn++; }
+				}
+				if (nn > 0) c[i] /= (double)nn;
+			}
+			FEMeshReorder::CurveOrder(method, c, Q);
+		}
+
+		vector<ELEMENT> oldElems(dom->ElementList());
+		for (int i = 0; i < NE; ++i) dom->GetElement(i) = oldElems[Q[i]];
+	}
+}
+
 FEBModel::Domain* FEBModel::Part::FindDomain(const string& name)
 {
 	for (size_t i = 0; i<m_Dom.size(); ++i)
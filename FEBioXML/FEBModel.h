@@ -82,6 +82,10 @@ public:
 		void SetMaterialName(const std::string& name);
 		const std::string& MaterialName() const;
 
+		// the element type as it was specified in the input file (e.g. "hex8")
+		void SetTypeName(const std::string& name) { m_typeName = name; }
+		const std::string& TypeName() const { return m_typeName; }
+
 		void SetElementList(const std::vector<ELEMENT>& el);
 		const std::vector<ELEMENT>& ElementList() const;
 
@@ -100,6 +104,7 @@ public:
 		FE_Element_Spec		m_spec;
 		std::string			m_name;
 		std::string			m_matName;
+		std::string			m_typeName;
 		std::vector<ELEMENT>	m_Elem;
 
 	public:
@@ -265,6 +270,9 @@ public:
 
 		void AddNodes(const std::vector<NODE>& nodes);
 
+		// reorder nodes and elements (method is one of the FEMeshReorder methods)
+		void Reorder(int method);
+
 		int Domains() const { return (int)m_Dom.size(); }
 		void AddDomain(Domain* dom);
 		const Domain& GetDomain(int i) const { return *m_Dom[i]; }
@@ -1057,6 +1057,7 @@ void FEBioGeometrySection25::ParsePartSection(XMLTag& tag)
 	// instantiate the part
 	if (binstance) 
 	{
+		GetBuilder()->ReorderPart(*part);
 		if (m_feb.BuildPart(*GetFEModel(), *part) == false) throw FEBioImport::FailedBuildingPart(part->Name());
 	}
 }
@@ -1164,6 +1165,7 @@ void FEBioGeometrySection25::ParseInstanceSection(XMLTag& tag)
 	}
 
 	// build this part
+	GetBuilder()->ReorderPart(*newPart);
 	if (m_feb.BuildPart(*GetFEModel(), *newPart, true, transform) == false) throw FEBioImport::FailedBuildingPart(newPart->Name());
 }
 
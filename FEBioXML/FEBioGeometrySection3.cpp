@@ -117,6 +117,7 @@ void FEBioGeometrySection3::ParsePartSection(XMLTag& tag)
 	// instantiate the part
 	if (binstance) 
 	{
+		GetBuilder()->ReorderPart(*part);
 		if (m_feb.BuildPart(*GetFEModel(), *part) == false) throw FEBioImport::FailedBuildingPart(part->Name());
 	}
 }
@@ -252,6 +253,7 @@ void FEBioGeometrySection3::ParseInstanceSection(XMLTag& tag)
 	}
 
 	// build this part
+	GetBuilder()->ReorderPart(*newPart);
 	if (m_feb.BuildPart(*GetFEModel(), *newPart, true, transform) == false) throw FEBioImport::FailedBuildingPart(newPart->Name());
 
 	// tell the file reader to rebuild the node ID table
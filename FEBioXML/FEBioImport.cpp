@@ -56,9 +56,11 @@ SOFTWARE.*/
 #include "FEBioMeshSection.h"
 #include "FEBioMeshSection4.h"
 #include "FEBioMeshDomainsSection4.h"
+#include "FEBioMeshFile.h"
 #include "FEBioStepSection3.h"
 #include "FECore/FEModel.h"
 #include "FECore/FECoreKernel.h"
+#include "FECore/log.h"
 #include <string.h>
 #include "xmltool.h"
 
@@ -434,7 +436,12 @@ bool FEBioImport::ReadFile(const char* szfile, bool broot)
 			if (nversion >= 0x0200)
 			{
 				const char* szinc = tag.AttributeValue("from", true);
-				if (szinc)
+				if (szinc && (nversion >= 0x0400) && (tag == "Mesh") && FEBioMeshFile::IsMeshFile(szinc))
+				{
+					// binary mesh files are read by the Mesh section itself
+					is->second->Parse(tag);
+				}
+				else if (szinc)
 				{
 					// make sure this is a leaf
 					if (tag.isleaf() == false) return errf("FATAL ERROR: included sections may not have child sections.\n\n");
@@ -504,6 +511,73 @@ bool FEBioImport::ReadFile(const char* szfile, bool broot)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! This function reads the Mesh section of an input file and writes it to a
+//! binary mesh file, which can then be referenced with <Mesh from="file.febm"/>.
+//! Only the mesh is read, so the model is not modified.
+bool FEBioImport::ConvertMesh(FEModel& fem, const char* szfile, const char* szmesh)
+{
+	if (m_builder == nullptr)
+	{
+		m_builder = new FEModelBuilder(fem);
+	}
+
+	// Open the XML file
+	XMLReader xml;
+	if (xml.Open(szfile) == false) return errf("FATAL ERROR: Failed opening input file %s\n\n", szfile);
+
+	XMLTag tag;
+	try
+	{
+		if (xml.FindTag("febio_spec", tag) == false) return errf("FATAL ERROR: febio_spec tag was not found. This is not a valid input file.\n\n");
+
+		// mesh files store the Mesh section of version 4.0 files
+		ParseVersion(tag);
+		int nversion = GetFileVersion();
+		if (nversion != 0x0400) return errf("FATAL ERROR: Mesh files can only be created from version 4.0 input files.\n\n");
+		BuildFileSectionMap(nversion);
+
+		// find the mesh section
+		if (xml.FindTag("febio_spec/Mesh", tag) == false) return errf("FATAL ERROR: Couldn't find Mesh section in file %s.\n\n", szfile);
+		if (tag.AttributeValue("from", true)) return errf("FATAL ERROR: The Mesh section of %s is already read from another file.\n\n", szfile);
+
+		m_map["Mesh"]->Parse(tag);
+	}
+	catch (XMLReader::Error& e)
+	{
+		return errf("%s", e.what());
+	}
+	catch (FEFileException& e)
+	{
+		return errf("%s (line %d)\n", e.GetErrorString(), xml.GetCurrentLine());
+	}
+	catch (std::exception& e)
+	{
+		return errf("%s", e.what());
+	}
+	catch (...)
+	{
+		return errf("unrecoverable error (line %d)\n", xml.GetCurrentLine());
+	}
+	xml.Close();
+
+	// write the mesh file
+	FEBModel& feb = m_builder->GetFEBModel();
+	FEBModel::Part* part = feb.GetPart(0);
+	if (part == nullptr) return errf("FATAL ERROR: No mesh found in %s.\n\n", szfile);
+
+	FEBioMeshFile meshFile;
+	if (meshFile.Write(szmesh, *part) == false) return errf("FATAL ERROR: %s\n\n", meshFile.GetErrorString().c_str());
+
+	// these are not stored in the mesh file, so they need to remain in the input file
+	if (part->PartLists() || part->SurfacePairs() || part->DiscreteSets())
+	{
+		feLogWarningEx((&fem), "Part lists, surface pairs and discrete sets are not stored in mesh files.\nThey can be defined inside the Mesh section that refers to %s.", szmesh);
+	}
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! This function parses the febio_spec tag for the version number
 void FEBioImport::ParseVersion(XMLTag &tag)
@@ -180,6 +180,9 @@ public:
 	//! read the contents of a file
 	bool ReadFile(const char* szfile, bool broot = true);
 
+	//! Convert the Mesh section of an input file (version 4.0) to a binary mesh file
+	bool ConvertMesh(FEModel& fem, const char* szfile, const char* szmesh);
+
 public:
 	void SetDumpfileName(const char* sz);
 	void SetLogfileName (const char* sz);
@@ -41,6 +41,10 @@ FEBioMeshDomainsSection4::FEBioMeshDomainsSection4(FEBioImport* pim) : FEBioFile
 
 void FEBioMeshDomainsSection4::Parse(XMLTag& tag)
 {
+	// reorder the mesh (this has to be done before the node ID lookup table is built)
+	FEBModel::Part* part0 = GetBuilder()->GetFEBModel().GetPart(0);
+	if (part0) GetBuilder()->ReorderPart(*part0);
+
 	// build the node ID lookup table
 	BuildNLT();
 	
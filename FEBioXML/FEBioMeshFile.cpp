@@ -0,0 +1,382 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBioMeshFile.h"
+#include "FEModelBuilder.h"
+#include <FECore/FEElementLibrary.h>
+#include <FECore/FEElementTraits.h>
+#include <stdio.h>
+#include <string.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// The file starts with this tag, followed by the version number
+static const char FEBM_TAG[4] = { 'F', 'E', 'B', 'M' };
+
+//-----------------------------------------------------------------------------
+// helper functions for writing/reading raw data
+static bool write_int(FILE* fp, int n) { return (fwrite(&n, sizeof(int), 1, fp) == 1); }
+
+static bool write_string(FILE* fp, const string& s)
+{
+	int l = (int)s.size();
+	if (write_int(fp, l) == false) return false;
+	return ((l == 0) || (fwrite(s.data(), 1, l, fp) == (size_t)l));
+}
+
+template <typename T> static bool write_array(FILE* fp, const vector<T>& v)
+{
+	return (v.empty() || (fwrite(v.data(), sizeof(T), v.size(), fp) == v.size()));
+}
+
+static bool read_int(FILE* fp, int& n) { return (fread(&n, sizeof(int), 1, fp) == 1); }
+
+static bool read_string(FILE* fp, string& s)
+{
+	int l = 0;
+	if ((read_int(fp, l) == false) || (l < 0)) return false;
+	s.resize(l);
+	return ((l == 0) || (fread(&s[0], 1, l, fp) == (size_t)l));
+}
+
+template <typename T> static bool read_array(FILE* fp, vector<T>& v, int n)
+{
+	if (n < 0) return false;
+	v.resize(n);
+	return ((n == 0) || (fread(v.data(), sizeof(T), n, fp) == (size_t)n));
+}
+
+// write a list of facets or edges (which only differ in type)
+template <typename T> static bool write_facets(FILE* fp, const vector<T>& face)
+{
+	int n = (int)face.size();
+	vector<int> ntype(n), id(n), node;
+	for (int i = 0; i < n; ++i)
+	{
+		const T& f = face[i];
+		ntype[i] = f.ntype;
+		id[i] = f.id;
+		node.insert(node.end(), f.node, f.node + f.ntype);
+	}
+	return write_int(fp, n) && write_array(fp, ntype) && write_array(fp, id) && write_int(fp, (int)node.size()) && write_array(fp, node);
+}
+
+template <typename T> static bool read_facets(FILE* fp, vector<T>& face)
+{
+	int n = 0, nn = 0;
+	vector<int> ntype, id, node;
+	if (!read_int(fp, n) || !read_array(fp, ntype, n) || !read_array(fp, id, n)) return false;
+	if (!read_int(fp, nn) || !read_array(fp, node, nn)) return false;
+
+	face.resize(n);
+	const int* pn = node.data();
+	for (int i = 0; i < n; ++i)
+	{
+		T& f = face[i];
+		f.ntype = ntype[i];
+		f.id = id[i];
+		if ((f.ntype <= 0) || (f.ntype > FEElement::MAX_NODES) || (pn + f.ntype > node.data() + nn)) return false;
+		for (int j = 0; j < f.ntype; ++j) f.node[j] = pn[j];
+		pn += f.ntype;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FEBioMeshFile::FEBioMeshFile()
+{
+
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshFile::error(const string& err)
+{
+	m_err = err;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshFile::IsMeshFile(const char* szfile)
+{
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+	char tag[4] = { 0 };
+	size_t nread = fread(tag, 1, 4, fp);
+	fclose(fp);
+	return ((nread == 4) && (memcmp(tag, FEBM_TAG, 4) == 0));
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshFile::Write(const char* szfile, FEBModel::Part& part)
+{
+	FILE* fp = fopen(szfile, "wb");
+	if (fp == nullptr) return error(string("Failed opening file ") + szfile);
+
+	bool ok = (fwrite(FEBM_TAG, 1, 4, fp) == 4) && write_int(fp, VERSION);
+
+	// nodes
+	int NN = part.Nodes();
+	vector<int> nodeID(NN);
+	vector<double> r(3 * NN);
+	for (int i = 0; i < NN; ++i)
+	{
+		FEBModel::NODE& nd = part.GetNode(i);
+		nodeID[i] = nd.id;
+		r[3 * i    ] = nd.r.x;
+		r[3 * i + 1] = nd.r.y;
+		r[3 * i + 2] = nd.r.z;
+	}
+	ok = ok && write_int(fp, NN) && write_array(fp, nodeID) && write_array(fp, r);
+
+	// element blocks
+	ok = ok && write_int(fp, part.Domains());
+	for (int i = 0; ok && (i < part.Domains()); ++i)
+	{
+		const FEBModel::Domain& dom = part.GetDomain(i);
+		if (dom.TypeName().empty()) { fclose(fp); return error("Unknown element type for part " + dom.Name()); }
+
+		FE_Element_Spec spec = dom.ElementSpec();
+		int neln = FEElementLibrary::GetElementTraits(spec.etype)->m_neln;
+
+		int NE = dom.Elements();
+		vector<int> elemID(NE), elemNode((size_t)NE*neln);
+		for (int j = 0; j < NE; ++j)
+		{
+			const FEBModel::ELEMENT& el = dom.GetElement(j);
+			elemID[j] = el.id;
+			for (int k = 0; k < neln; ++k) elemNode[(size_t)j*neln + k] = el.node[k];
+		}
+
+		ok = write_string(fp, dom.Name()) && write_string(fp, dom.TypeName()) && 
+			write_int(fp, NE) && write_int(fp, neln) && write_array(fp, elemID) && write_array(fp, elemNode);
+	}
+
+	// node sets
+	ok = ok && write_int(fp, part.NodeSets());
+	for (int i = 0; ok && (i < part.NodeSets()); ++i)
+	{
+		FEBModel::NodeSet* set = part.GetNodeSet(i);
+		const vector<int>& nodeList = set->NodeList();
+		ok = write_string(fp, set->Name()) && write_int(fp, (int)nodeList.size()) && write_array(fp, nodeList);
+	}
+
+	// surfaces
+	ok = ok && write_int(fp, part.Surfaces());
+	for (int i = 0; ok && (i < part.Surfaces()); ++i)
+	{
+		FEBModel::Surface* surf = part.GetSurface(i);
+		ok = write_string(fp, surf->Name()) && write_facets(fp, surf->FacetList());
+	}
+
+	// edges
+	ok = ok && write_int(fp, part.EdgeSets());
+	for (int i = 0; ok && (i < part.EdgeSets()); ++i)
+	{
+		FEBModel::EdgeSet* edge = part.GetEdgeSet(i);
+		ok = write_string(fp, edge->Name()) && write_facets(fp, edge->EdgeList());
+	}
+
+	// element sets
+	// (The sets that are created for the element blocks and part lists are not stored.)
+	vector<FEBModel::ElementSet*> elemSets;
+	for (int i = 0; i < part.ElementSets(); ++i)
+	{
+		FEBModel::ElementSet* set = part.GetElementSet(i);
+		const string& name = set->Name();
+		if ((name.empty() == false) && (name[0] == '@')) continue;
+		if (part.FindDomain(name)) continue;
+		elemSets.push_back(set);
+	}
+	ok = ok && write_int(fp, (int)elemSets.size());
+	for (size_t i = 0; ok && (i < elemSets.size()); ++i)
+	{
+		const vector<int>& elemList = elemSets[i]->ElementList();
+		ok = write_string(fp, elemSets[i]->Name()) && write_int(fp, (int)elemList.size()) && write_array(fp, elemList);
+	}
+
+	fclose(fp);
+	if (ok == false) return error(string("Failed writing file ") + szfile);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshFile::Read(const char* szfile, FEBModel::Part& part, FEModelBuilder& builder)
+{
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return error(string("Failed opening file ") + szfile);
+
+	// check the header
+	char tag[4] = { 0 };
+	int version = 0;
+	if ((fread(tag, 1, 4, fp) != 4) || (memcmp(tag, FEBM_TAG, 4) != 0) || !read_int(fp, version))
+	{
+		fclose(fp);
+		return error(string(szfile) + " is not a valid mesh file");
+	}
+	if (version != VERSION)
+	{
+		fclose(fp);
+		return error(string("Unsupported version of mesh file ") + szfile);
+	}
+
+	try {
+		// nodes
+		int NN = 0;
+		vector<int> nodeID;
+		vector<double> r;
+		if (!read_int(fp, NN) || !read_array(fp, nodeID, NN) || !read_array(fp, r, 3 * NN)) throw std::runtime_error("nodes");
+
+		vector<FEBModel::NODE> node(NN);
+		for (int i = 0; i < NN; ++i)
+		{
+			// make sure node IDs are incrementing
+			if ((i > 0) && (nodeID[i] <= nodeID[i - 1])) throw std::runtime_error("node ID");
+
+			FEBModel::NODE& nd = node[i];
+			nd.id = nodeID[i];
+			nd.r = vec3d(r[3 * i], r[3 * i + 1], r[3 * i + 2]);
+		}
+		part.AddNodes(node);
+
+		// element blocks
+		int ND = 0;
+		if (!read_int(fp, ND)) throw std::runtime_error("parts");
+		for (int i = 0; i < ND; ++i)
+		{
+			string name, typeName;
+			int NE = 0, neln = 0;
+			vector<int> elemID, elemNode;
+			if (!read_string(fp, name) || !read_string(fp, typeName) || !read_int(fp, NE) || !read_int(fp, neln)) throw std::runtime_error("part");
+			if ((neln <= 0) || (neln > FEElement::MAX_NODES)) throw std::runtime_error("part " + name);
+			if (!read_array(fp, elemID, NE) || !read_array(fp, elemNode, NE*neln)) throw std::runtime_error("part " + name);
+
+			// process the element type (just like in the Mesh section)
+			FE_Element_Spec espec = builder.ElementSpec(typeName.c_str());
+			if (FEElementLibrary::IsValid(espec) == false) throw std::runtime_error("element type of part " + name);
+			if (FEElementLibrary::GetElementTraits(espec.etype)->m_neln != neln) throw std::runtime_error("part " + name);
+			if (part.FindDomain(name)) throw std::runtime_error("duplicate part " + name);
+
+			FEBModel::Domain* dom = new FEBModel::Domain(espec);
+			dom->SetTypeName(typeName);
+			dom->SetName(name);
+			part.AddDomain(dom);
+
+			dom->Create(NE);
+			for (int j = 0; j < NE; ++j)
+			{
+				// element IDs must be increasing
+				if ((j > 0) && (elemID[j] <= elemID[j - 1])) throw std::runtime_error("element ID in part " + name);
+
+				FEBModel::ELEMENT& el = dom->GetElement(j);
+				el.id = elemID[j];
+				for (int k = 0; k < neln; ++k) el.node[k] = elemNode[(size_t)j*neln + k];
+			}
+
+			// for named domains, we'll also create an element set
+			if (name.empty() == false)
+			{
+				FEBModel::ElementSet* pg = new FEBModel::ElementSet(name);
+				pg->SetElementList(elemID);
+				part.AddElementSet(pg);
+			}
+		}
+
+		// node sets
+		int NS = 0;
+		if (!read_int(fp, NS)) throw std::runtime_error("node sets");
+		for (int i = 0; i < NS; ++i)
+		{
+			string name;
+			int n = 0;
+			vector<int> nodeList;
+			if (!read_string(fp, name) || !read_int(fp, n) || !read_array(fp, nodeList, n)) throw std::runtime_error("node set");
+			if (part.FindNodeSet(name)) throw std::runtime_error("duplicate node set " + name);
+
+			FEBModel::NodeSet* set = new FEBModel::NodeSet(name);
+			set->SetNodeList(nodeList);
+			part.AddNodeSet(set);
+		}
+
+		// surfaces
+		int NF = 0;
+		if (!read_int(fp, NF)) throw std::runtime_error("surfaces");
+		for (int i = 0; i < NF; ++i)
+		{
+			string name;
+			vector<FEBModel::FACET> face;
+			if (!read_string(fp, name) || !read_facets(fp, face)) throw std::runtime_error("surface");
+			if (part.FindSurface(name)) throw std::runtime_error("duplicate surface " + name);
+
+			FEBModel::Surface* surf = new FEBModel::Surface(name);
+			surf->SetFacetList(face);
+			part.AddSurface(surf);
+		}
+
+		// edges
+		int NL = 0;
+		if (!read_int(fp, NL)) throw std::runtime_error("edges");
+		for (int i = 0; i < NL; ++i)
+		{
+			string name;
+			vector<FEBModel::EDGE> edge;
+			if (!read_string(fp, name) || !read_facets(fp, edge)) throw std::runtime_error("edge");
+			if (part.FindEdgeSet(name)) throw std::runtime_error("duplicate edge " + name);
+
+			FEBModel::EdgeSet* set = new FEBModel::EdgeSet(name);
+			set->SetEdgeList(edge);
+			part.AddEdgeSet(set);
+		}
+
+		// element sets
+		int NES = 0;
+		if (!read_int(fp, NES)) throw std::runtime_error("element sets");
+		for (int i = 0; i < NES; ++i)
+		{
+			string name;
+			int n = 0;
+			vector<int> elemList;
+			if (!read_string(fp, name) || !read_int(fp, n) || !read_array(fp, elemList, n)) throw std::runtime_error("element set");
+			if (part.FindElementSet(name)) throw std::runtime_error("duplicate element set " + name);
+
+			FEBModel::ElementSet* set = new FEBModel::ElementSet(name);
+			set->SetElementList(elemList);
+			part.AddElementSet(set);
+		}
+	}
+	catch (std::runtime_error& e)
+	{
+		fclose(fp);
+		return error(string("Error reading mesh file ") + szfile + ": invalid " + e.what());
+	}
+
+	fclose(fp);
+
+	return true;
+}
@@ -0,0 +1,66 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEBModel.h"
+#include <string>
+
+class FEModelBuilder;
+
+//-----------------------------------------------------------------------------
+// This class reads and writes binary mesh files (.febm). A mesh file stores the
+// contents of the Mesh section of an febio input file (nodes, element blocks, 
+// node sets, surfaces, edges and element sets) as raw arrays, so that it can be 
+// loaded without any parsing. A mesh file is referenced from the input file as
+// <Mesh from="model.febm"/>.
+class FEBioMeshFile
+{
+public:
+	enum { VERSION = 1 };
+
+public:
+	FEBioMeshFile();
+
+	//! see if the file is a binary mesh file
+	static bool IsMeshFile(const char* szfile);
+
+	//! write a part to a mesh file
+	bool Write(const char* szfile, FEBModel::Part& part);
+
+	//! read a mesh file into a part. The builder is needed for processing the element types.
+	bool Read(const char* szfile, FEBModel::Part& part, FEModelBuilder& builder);
+
+	//! return the last error message
+	const std::string& GetErrorString() const { return m_err; }
+
+private:
+	bool error(const std::string& err);
+
+private:
+	std::string	m_err;
+};
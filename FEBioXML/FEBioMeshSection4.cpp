@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEBioMeshSection4.h"
+#include "FEBioMeshFile.h"
 #include <FECore/FEModel.h>
 #include <sstream>
 
@@ -51,6 +52,19 @@ void FEBioMeshSection4::Parse(XMLTag& tag)
 	assert(feb.Parts() == 0);
 	FEBModel::Part* part = feb.AddPart("");
 
+	// see if the mesh is stored in a binary mesh file
+	const char* szfile = tag.AttributeValue("from", true);
+	if (szfile)
+	{
+		FEBioMeshFile meshFile;
+		if (meshFile.Read(szfile, *part, *builder) == false) throw XMLReader::Error(tag, meshFile.GetErrorString());
+
+		if (part->Nodes() > 0) m_maxNodeId = part->GetNode(part->Nodes() - 1).id;
+
+		// the remaining mesh items can still be defined in the input file
+		if (tag.isleaf() || tag.isempty()) return;
+	}
+
 	// read all sections
 	++tag;
 	do
@@ -151,6 +165,7 @@ void FEBioMeshSection4::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 
 	// create the new domain
 	dom = new FEBModel::Domain(espec);
+	dom->SetTypeName(sztype);
 	if (szname) dom->SetName(szname);
 
 	// add domain it to the mesh
@@ -168,7 +168,7 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 				int n = pns->Size();
 				assert(n);
 				items.resize(n);
-				for (int i = 0; i < n; ++i) items[i] = (*pns)[i] + 1;
+				for (int i = 0; i < n; ++i) items[i] = mesh.Node((*pns)[i]).GetID();
 
 				pdr->SetItemList(items);
 			}
@@ -397,6 +397,12 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
 				tag.value(ncomp);
 				plotData.SetPlotCompression(ncomp);
 			}
+			else if (tag=="async_write")
+			{
+				bool b;
+				tag.value(b);
+				plotData.SetPlotAsyncWrite(b);
+			}
 			++tag;
 		}
 		while (!tag.isend());
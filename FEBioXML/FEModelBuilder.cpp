@@ -354,11 +354,17 @@ FEModelBuilder::NodeSetSet* FEModelBuilder::FindNodeSetSet(const char* szname)
 void FEModelBuilder::BuildNodeList()
 {
 	// find the min, max ID
-	// (We assume that they are given by the first and last node)
+	// (The nodes are not necessarily sorted by ID, e.g. when the mesh was reordered)
 	FEMesh& mesh = m_fem.GetMesh();
 	int NN = mesh.Nodes();
 	int nmin = mesh.Node(0).GetID();
-	int nmax = mesh.Node(NN - 1).GetID();
+	int nmax = nmin;
+	for (int i = 1; i < NN; ++i)
+	{
+		int nid = mesh.Node(i).GetID();
+		if (nid < nmin) nmin = nid;
+		if (nid > nmax) nmax = nid;
+	}
 	assert(nmax >= nmin);
 
 	// get the range
@@ -934,3 +940,13 @@ FEBModel& FEModelBuilder::GetFEBModel()
 {
 	return m_feb;
 }
+
+//-----------------------------------------------------------------------------
+// This must be called before any node or element indices of the part are assigned.
+// Note that only the Control section that precedes the mesh can request the reordering.
+void FEModelBuilder::ReorderPart(FEBModel::Part& part)
+{
+	if (m_fem.Steps() == 0) return;
+	FEAnalysis* step = m_fem.GetStep(0);
+	part.Reorder(step->m_nmeshReorder);
+}
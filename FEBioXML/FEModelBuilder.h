@@ -194,6 +194,9 @@ public:
 
 	FEBModel& GetFEBModel();
 
+	// reorder the nodes and elements of a part, as requested by the first step
+	void ReorderPart(FEBModel::Part& part);
+
 	void SetDefaultSolver(const std::string& s) { m_defaultSolver = s; }
 
 private:
@@ -216,29 +216,28 @@ void FEFileSection::value(XMLTag& tag, vec2d& v)
 
 void FEFileSection::value(XMLTag& tag, vec3d& v)
 {
-	const char* sz = tag.szvalue();
-	int n = sscanf(sz, "%lg,%lg,%lg", &v.x, &v.y, &v.z);
+	double d[3];
+	int n = tag.scan(d, 3);
 	if (n != 3) throw XMLReader::XMLSyntaxError(tag.m_nstart_line);
+	v = vec3d(d[0], d[1], d[2]);
 }
 
 //-----------------------------------------------------------------------------
 void FEFileSection::value(XMLTag& tag, mat3d& m)
 {
-	const char* sz = tag.szvalue();
-	double xx, xy, xz, yx, yy, yz, zx, zy, zz;
-	int n = sscanf(sz, "%lg,%lg,%lg,%lg,%lg,%lg,%lg,%lg,%lg", &xx, &xy, &xz, &yx, &yy, &yz, &zx, &zy, &zz);
+	double d[9];
+	int n = tag.scan(d, 9);
 	if (n != 9) throw XMLReader::XMLSyntaxError(tag.m_nstart_line);
-	m = mat3d(xx, xy, xz, yx, yy, yz, zx, zy, zz);
+	m = mat3d(d[0], d[1], d[2], d[3], d[4], d[5], d[6], d[7], d[8]);
 }
 
 //-----------------------------------------------------------------------------
 void FEFileSection::value(XMLTag& tag, mat3ds& m)
 {
-	const char* sz = tag.szvalue();
-	double x, y, z, xy, yz, xz;
-	int n = sscanf(sz, "%lg,%lg,%lg,%lg,%lg,%lg", &x, &y, &z, &xy, &yz, &xz);
+	double d[6];
+	int n = tag.scan(d, 6);
 	if (n != 6) throw XMLReader::XMLSyntaxError(tag.m_nstart_line);
-	m = mat3ds(x, y, z, xy, yz, xz);
+	m = mat3ds(d[0], d[1], d[2], d[3], d[4], d[5]);
 }
 
 //-----------------------------------------------------------------------------
@@ -325,37 +324,13 @@ void FEFileSection::value(XMLTag& tag, std::vector<double>& v)
 //-----------------------------------------------------------------------------
 int FEFileSection::value(XMLTag& tag, int* pi, int n)
 {
-	const char* sz = tag.szvalue();
-	int nr = 0;
-	for (int i = 0; i<n; ++i)
-	{
-		const char* sze = strchr(sz, ',');
-
-		pi[i] = atoi(sz);
-nr++;
-
-if (sze) sz = sze + 1;
-else break;
-	}
-	return nr;
+	return tag.value(pi, n);
 }
 
 //-----------------------------------------------------------------------------
 int FEFileSection::value(XMLTag& tag, double* pf, int n)
 {
-	const char* sz = tag.szvalue();
-	int nr = 0;
-	for (int i = 0; i < n; ++i)
-	{
-		const char* sze = strchr(sz, ',');
-
-		pf[i] = atof(sz);
-		nr++;
-
-		if (sze) sz = sze + 1;
-		else break;
-	}
-	return nr;
+	return tag.value(pf, n);
 }
 
 //-----------------------------------------------------------------------------
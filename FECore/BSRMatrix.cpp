@@ -0,0 +1,441 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "BSRMatrix.h"
+#include "FEModel.h"
+#include "FEMesh.h"
+#include <algorithm>
+#include <assert.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+BSRMatrix::BSRMatrix(bool symmetric, FEModel* fem)
+{
+	m_bsymm = symmetric;
+	m_nbr = 0;
+	m_bident = true;
+	m_fem = fem;
+}
+
+//-----------------------------------------------------------------------------
+BSRMatrix::~BSRMatrix()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Zero()
+{
+	std::fill(m_val.begin(), m_val.end(), 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Clear()
+{
+	m_nbr = 0;
+	m_bident = true;
+	m_beq.clear(); m_beq.shrink_to_fit();
+	m_slot.clear(); m_slot.shrink_to_fit();
+	m_ptr.clear(); m_ptr.shrink_to_fit();
+	m_col.clear(); m_col.shrink_to_fit();
+	m_diag.clear(); m_diag.shrink_to_fit();
+	m_val.clear(); m_val.shrink_to_fit();
+	m_xp.clear(); m_xp.shrink_to_fit();
+	m_yp.clear(); m_yp.shrink_to_fit();
+
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+//! Assign each equation to a block slot. The free degrees of freedom of a node
+//! are placed in consecutive slots, starting a new block row for each node.
+//! The remaining equations are appended in order.
+void BSRMatrix::BuildBlockMap(int N)
+{
+	m_beq.clear();
+	m_slot.assign(N, -1);
+
+	if (m_fem)
+	{
+		FEMesh& mesh = m_fem->GetMesh();
+		for (int i = 0; i < mesh.Nodes(); ++i)
+		{
+			FENode& node = mesh.Node(i);
+			int n0 = (int)m_beq.size();
+			for (int j = 0; j < node.dofs(); ++j)
+			{
+				int n = node.m_ID[j];
+				if ((n >= 0) && (n < N) && (m_slot[n] < 0))
+				{
+					m_slot[n] = (int)m_beq.size();
+					m_beq.push_back(n);
+				}
+			}
+
+			// pad the last block row of this node
+			if ((int)m_beq.size() > n0)
+			{
+				while (m_beq.size() % BS) m_beq.push_back(-1);
+			}
+		}
+	}
+
+	for (int i = 0; i < N; ++i)
+	{
+		if (m_slot[i] < 0)
+		{
+			m_slot[i] = (int)m_beq.size();
+			m_beq.push_back(i);
+		}
+	}
+	while (m_beq.size() % BS) m_beq.push_back(-1);
+
+	m_nbr = (int)m_beq.size() / BS;
+
+	m_bident = ((int)m_beq.size() == N);
+	for (int i = 0; (i < N) && m_bident; ++i) m_bident = (m_slot[i] == i);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Create(SparseMatrixProfile& mp)
+{
+	Clear();
+
+	int N = mp.Rows();
+	assert(N == mp.Columns());
+	BuildBlockMap(N);
+	int nb = m_nbr;
+
+	// Collect the block columns of each block row. A block exists if any of
+	// its entries is in the profile. For symmetric matrices we also add the transpose,
+	// and the diagonal blocks are always added.
+	vector< vector<int> > rows(nb);
+	for (int i = 0; i < nb; ++i) rows[i].push_back(i);
+	vector<int> tag(nb, -1);
+	for (int bj = 0; bj < nb; ++bj)
+	{
+		for (int s = bj*BS; s < bj*BS + BS; ++s)
+		{
+			int j = m_beq[s];
+			if (j < 0) continue;
+
+			SparseMatrixProfile::ColumnProfile& a = mp.Column(j);
+			for (int n = 0; n < (int)a.size(); ++n)
+			{
+				for (int i = a[n].start; i <= a[n].end; ++i)
+				{
+					int bi = m_slot[i] / BS;
+					if ((tag[bi] != bj) && (bi != bj))
+					{
+						tag[bi] = bj;
+						rows[bi].push_back(bj);
+						if (m_bsymm) rows[bj].push_back(bi);
+					}
+				}
+			}
+		}
+	}
+
+	// build the block row structure
+	m_ptr.assign(nb + 1, 0);
+	for (int i = 0; i < nb; ++i)
+	{
+		vector<int>& ri = rows[i];
+		sort(ri.begin(), ri.end());
+		ri.erase(unique(ri.begin(), ri.end()), ri.end());
+		m_ptr[i + 1] = m_ptr[i] + (int)ri.size();
+	}
+
+	int nblocks = m_ptr[nb];
+	m_col.resize(nblocks);
+	m_diag.resize(nb);
+	for (int i = 0; i < nb; ++i)
+	{
+		vector<int>& ri = rows[i];
+		copy(ri.begin(), ri.end(), m_col.begin() + m_ptr[i]);
+		m_diag[i] = m_ptr[i] + (int)(lower_bound(ri.begin(), ri.end(), i) - ri.begin());
+
+		// release memory as we go
+		vector<int>().swap(ri);
+	}
+
+	m_val.assign((size_t)nblocks*BS*BS, 0.0);
+
+	m_nrow = N;
+	m_ncol = N;
+	m_nsize = m_val.size();
+}
+
+//-----------------------------------------------------------------------------
+int BSRMatrix::FindBlock(int i, int j) const
+{
+	const int* p0 = m_col.data() + m_ptr[i];
+	const int* p1 = m_col.data() + m_ptr[i + 1];
+	const int* p = lower_bound(p0, p1, j);
+	return ((p != p1) && (*p == j) ? (int)(p - m_col.data()) : -1);
+}
+
+//-----------------------------------------------------------------------------
+double* BSRMatrix::find(int i, int j)
+{
+	int si = m_slot[i], sj = m_slot[j];
+	int n = FindBlock(si / BS, sj / BS);
+	return (n >= 0 ? &m_val[(size_t)n*BS*BS + (si % BS)*BS + (sj % BS)] : nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Assemble(const matrix& ke, const vector<int>& lm)
+{
+	Assemble(ke, lm, lm);
+}
+
+//-----------------------------------------------------------------------------
+//! Assemble an element matrix. For each row of the element matrix, the block
+//! is only searched when the block column changes. Since the equations of a node are
+//! usually numbered consecutively, this means about one search per node.
+void BSRMatrix::Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	double* pv = Values();
+
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		const int bi = m_slot[I] / BS;
+		const int li = m_slot[I] % BS;
+		const double* ki = ke[i];
+
+		int bj0 = -1, nb = -1, nt = -1;
+		for (int j = 0; j < M; ++j)
+		{
+			int J = lmj[j];
+
+			// for symmetric matrices we only use the lower-triangular part
+			if ((J < 0) || (m_bsymm && (J > I))) continue;
+
+			const int bj = m_slot[J] / BS;
+			if (bj != bj0)
+			{
+				bj0 = bj;
+				nb = FindBlock(bi, bj);
+				nt = (m_bsymm && (bi != bj) ? FindBlock(bj, bi) : -1);
+			}
+			if (nb < 0) continue;
+
+			const int lj = m_slot[J] % BS;
+			double* pij = pv + (size_t)nb*BS*BS + li*BS + lj;
+			if (m_batomic)
+			{
+				#pragma omp atomic
+				*pij += ki[j];
+			}
+			else *pij += ki[j];
+
+			// the mirrored entry (in the transposed block, or in the diagonal block)
+			const int nm = (bi == bj ? nb : nt);
+			if (m_bsymm && (I != J) && (nm >= 0))
+			{
+				double* pji = pv + (size_t)nm*BS*BS + lj*BS + li;
+				if (m_batomic)
+				{
+					#pragma omp atomic
+					*pji += ki[j];
+				}
+				else *pji += ki[j];
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Find the offsets into the value array for each entry of an element matrix.
+// For symmetric matrices each entry may update two values, which cannot be
+// expressed with a scatter map, so these use the regular assembly.
+bool BSRMatrix::BuildScatterMap(int nr, int nc, const vector<int>& lmi, const vector<int>& lmj, vector<int>& map)
+{
+	if (m_bsymm) return false;
+
+	map.assign(nr*nc, -1);
+	for (int i = 0; i < nr; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+
+		const int si = m_slot[I];
+		int bj0 = -1, nb = -1;
+		for (int j = 0; j < nc; ++j)
+		{
+			int J = lmj[j];
+			if (J < 0) continue;
+
+			const int sj = m_slot[J];
+			if (sj / BS != bj0)
+			{
+				bj0 = sj / BS;
+				nb = FindBlock(si / BS, bj0);
+			}
+			if (nb >= 0) map[i*nc + j] = nb*BS*BS + (si % BS)*BS + (sj % BS);
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool BSRMatrix::check(int i, int j)
+{
+	return (find(i, j) != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::set(int i, int j, double v)
+{
+	// for symmetric matrices, only the upper triangular entries are used
+	if (m_bsymm && (i > j)) return;
+
+	double* pij = find(i, j);
+	if (pij) *pij = v;
+	if (m_bsymm && (i != j))
+	{
+		double* pji = find(j, i);
+		if (pji) *pji = v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::add(int i, int j, double v)
+{
+	// for symmetric matrices, only the upper triangular entries are used
+	if (m_bsymm && (i > j)) return;
+
+	double* pij = find(i, j);
+	assert(pij);
+	if (pij)
+	{
+		#pragma omp atomic
+		*pij += v;
+	}
+	if (m_bsymm && (i != j))
+	{
+		double* pji = find(j, i);
+		if (pji)
+		{
+			#pragma omp atomic
+			*pji += v;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+double BSRMatrix::get(int i, int j)
+{
+	double* pij = find(i, j);
+	return (pij ? *pij : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+double BSRMatrix::diag(int i)
+{
+	int si = m_slot[i];
+	return m_val[(size_t)m_diag[si / BS]*BS*BS + (si % BS)*(BS + 1)];
+}
+
+//-----------------------------------------------------------------------------
+bool BSRMatrix::mult_vector(double* x, double* r)
+{
+	Multiply(x, r);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Multiply(const double* x, double* y) const
+{
+	const int N = Rows();
+
+	// unless the slots are the equations, we work with permuted (and padded) vectors
+	// (the work vectors are kept, so that the products in the solver loops don't allocate)
+	double* py = y;
+	if (m_bident == false)
+	{
+		const int ns = m_nbr*BS;
+		if ((int)m_xp.size() != ns) { m_xp.resize(ns); m_yp.resize(ns); }
+		double* xp = m_xp.data();
+		#pragma omp parallel for
+		for (int i = 0; i < ns; ++i) xp[i] = (m_beq[i] >= 0 ? x[m_beq[i]] : 0.0);
+		x = xp;
+		py = m_yp.data();
+	}
+
+	const double* pv = m_val.data();
+	#pragma omp parallel for schedule(guided)
+	for (int i = 0; i < m_nbr; ++i)
+	{
+		double y0 = 0.0, y1 = 0.0, y2 = 0.0;
+		for (int k = m_ptr[i]; k < m_ptr[i + 1]; ++k)
+		{
+			const double* a = pv + (size_t)k*BS*BS;
+			const double* xj = x + m_col[k]*BS;
+			y0 += a[0]*xj[0] + a[1]*xj[1] + a[2]*xj[2];
+			y1 += a[3]*xj[0] + a[4]*xj[1] + a[5]*xj[2];
+			y2 += a[6]*xj[0] + a[7]*xj[1] + a[8]*xj[2];
+		}
+		py[BS*i    ] = y0;
+		py[BS*i + 1] = y1;
+		py[BS*i + 2] = y2;
+	}
+
+	if (py != y)
+	{
+		#pragma omp parallel for
+		for (int i = 0; i < N; ++i) y[i] = py[m_slot[i]];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::scale(const vector<double>& L, const vector<double>& R)
+{
+	#pragma omp parallel for
+	for (int i = 0; i < m_nbr; ++i)
+	{
+		for (int k = m_ptr[i]; k < m_ptr[i + 1]; ++k)
+		{
+			double* a = &m_val[(size_t)k*BS*BS];
+			for (int r = 0; r < BS; ++r)
+			{
+				int I = m_beq[i*BS + r];
+				for (int c = 0; c < BS; ++c)
+				{
+					int J = m_beq[m_col[k]*BS + c];
+					if ((I >= 0) && (J >= 0)) a[r*BS + c] *= L[I] * R[J];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,161 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "SparseMatrix.h"
+#include <vector>
+
+class FEModel;
+
+//=============================================================================
+//! This class stores a sparse matrix in block compressed row format (BSR) with 3x3 blocks.
+
+//! When a model is given, the blocks are formed from the nodes, as in the nodal
+//! block Jacobi preconditioner: the free degrees of freedom of a node (taken from FENode::m_ID)
+//! are grouped into one block row, so each block couples two nodes. A node
+//! with more than three free degrees of freedom spans several block rows, and a node
+//! with prescribed degrees of freedom leaves padded slots in its block. Equations that
+//! don't belong to a node, and all equations if no model is given, are grouped
+//! in order, so that equations 3i, 3i+1 and 3i+2 form block row i.
+//! The padded entries are never referenced.
+//!
+//! Only one column index is stored per block, and the values of a block are
+//! stored contiguously (row by row). The full block pattern is stored, also for
+//! symmetric matrices, so that the matrix-vector product can be done in parallel
+//! without write conflicts.
+//!
+//! A symmetric matrix follows the same conventions as CompactSymmMatrix:
+//! Assemble only uses the lower triangular part of the element matrix, and add and set
+//! only use the upper triangular entries. The mirrored entries are updated as well.
+class FECORE_API BSRMatrix : public SparseMatrix
+{
+public:
+	enum { BS = 3 };	// block size
+
+public:
+	//! constructor
+	BSRMatrix(bool symmetric = false, FEModel* fem = nullptr);
+
+	//! destructor
+	~BSRMatrix();
+
+	//! zero matrix elements
+	void Zero() override;
+
+	//! Create the block structure from the SparseMatrixProfile.
+	void Create(SparseMatrixProfile& mp) override;
+
+	//! Clear
+	void Clear() override;
+
+	//! Assemble an element matrix into the global matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! build a scatter map for an element matrix
+	bool BuildScatterMap(int nr, int nc, const std::vector<int>& lmi, const std::vector<int>& lmj, std::vector<int>& map) override;
+
+	//! see if a matrix element is defined
+	bool check(int i, int j) override;
+
+	//! set matrix item
+	void set(int i, int j, double v) override;
+
+	//! add a matrix item
+	void add(int i, int j, double v) override;
+
+	//! get a matrix item
+	double get(int i, int j) override;
+
+	//! return the diagonal component
+	double diag(int i) override;
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! do row (L) and column (R) scaling
+	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+	//! is the matrix symmetric or not
+	bool isSymmetric() const { return m_bsymm; }
+
+	//! Pointer to matrix values
+	double* Values() override { return (m_val.empty() ? nullptr : &m_val[0]); }
+
+public:
+	//! calculate the product y = Ax (parallel)
+	//! Note that this uses work vectors of the matrix, so it cannot be called concurrently.
+	void Multiply(const double* x, double* y) const;
+
+	//! nr of block rows
+	int BlockRows() const { return m_nbr; }
+
+	//! nr of stored blocks
+	int Blocks() const { return (int)m_col.size(); }
+
+	//! start of each block row in the block arrays
+	const std::vector<int>& BlockPointers() const { return m_ptr; }
+
+	//! block column index of each block
+	const std::vector<int>& BlockIndices() const { return m_col; }
+
+	//! equation of each block slot (BS per block row), or -1 for padded slots
+	const std::vector<int>& BlockEquations() const { return m_beq; }
+
+	//! block slot of each equation (block row = slot / BS, position in block = slot % BS)
+	const std::vector<int>& EquationSlots() const { return m_slot; }
+
+	//! position of block (i,j) in the block arrays, or -1 if the block does not exist
+	int FindBlock(int i, int j) const;
+
+private:
+	//! assign the equations to block slots
+	void BuildBlockMap(int neq);
+
+	//! pointer to the value of entry (i,j), or null if it does not exist
+	double* find(int i, int j);
+
+private:
+	bool	m_bsymm;	//!< symmetric matrix
+	int		m_nbr;		//!< nr of block rows (and block columns)
+	bool	m_bident;	//!< equation i is in slot i (no permutation needed in products)
+	FEModel*	m_fem;	//!< model that defines the nodal blocks (can be null)
+
+	std::vector<int>	m_beq;		//!< equation of each block slot (-1 for padding)
+	std::vector<int>	m_slot;		//!< block slot of each equation
+
+	std::vector<int>	m_ptr;		//!< start of each block row
+	std::vector<int>	m_col;		//!< block column index of each block (sorted per block row)
+	std::vector<int>	m_diag;		//!< position of the diagonal block of each block row
+	std::vector<double>	m_val;		//!< block values (BS*BS per block, row by row)
+
+	mutable std::vector<double>	m_xp;	//!< work vectors for products with permuted (and padded) vectors
+	mutable std::vector<double>	m_yp;
+};
@@ -140,3 +140,31 @@ size_t CompactMatrix::actualNonZeroes()
 	}
 	return nnz;
 }
+
+//-----------------------------------------------------------------------------
+//! The row ranges of the profile and the indices of the matrix are both sorted,
+//! so they can be merged in a single pass. Since the profile is symmetric, row j
+//! of a row-based matrix contains the same indices as column j. The symmetric
+//! format only stores the lower triangular part, so only the rows i >= j are checked
+//! here. The entries above the diagonal are checked with their mirrored column.
+bool CompactMatrix::checkColumn(int j, const SparseMatrixProfile::ColumnProfile& col)
+{
+	const int* pi = m_pindices + (m_ppointers[j] - m_offset);
+	int n = m_ppointers[j + 1] - m_ppointers[j];
+	int rmin = (isSymmetric() ? j : 0);
+	int m = 0;
+	for (int k = 0; k < col.size(); ++k)
+	{
+		int r0 = col[k].start;
+		int r1 = col[k].end;
+		if (r1 < rmin) continue;
+		if (r0 < rmin) r0 = rmin;
+		for (int r = r0; r <= r1; ++r)
+		{
+			while ((m < n) && (pi[m] - m_offset < r)) ++m;
+			if ((m == n) || (pi[m] - m_offset != r)) return false;
+			++m;
+		}
+	}
+	return true;
+}
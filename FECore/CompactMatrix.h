@@ -86,6 +86,9 @@ public:
 	//! count the actual nr. of nonzeroes
 	size_t actualNonZeroes();
 
+	//! check if all entries of column j of a (symmetric) matrix profile were allocated
+	bool checkColumn(int j, const SparseMatrixProfile::ColumnProfile& col) override;
+
 protected:
 	double*	m_pd;			//!< matrix values
 	int*	m_pindices;		//!< indices
@@ -28,17 +28,45 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactSymmMatrix.h"
+#include "FEScratch.h"
+#include <algorithm>
+#include <omp.h>
 using namespace std;
 
 //-----------------------------------------------------------------------------
 //! constructor
 CompactSymmMatrix::CompactSymmMatrix(int offset) : CompactMatrix(offset) 
 {
-	
+	m_bparallel = true;
+}
+
+//-----------------------------------------------------------------------------
+void CompactSymmMatrix::Clear()
+{
+	m_mptr.clear();
+	m_mcol.clear();
+	m_mpos.clear();
+
+	CompactMatrix::Clear();
 }
 
 //-----------------------------------------------------------------------------
 bool CompactSymmMatrix::mult_vector(double* x, double* r)
+{
+	// The serial product scatters into the result vector, so it cannot be run in parallel.
+	// When more than one thread is available, we use the mirror of the lower triangle instead.
+	if (m_bparallel && (omp_get_max_threads() > 1))
+	{
+		if (m_mptr.empty()) BuildMirror();
+		mult_vector_parallel(x, r);
+	}
+	else mult_vector_serial(x, r);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void CompactSymmMatrix::mult_vector_serial(double* x, double* r)
 {
 	// get row count
 	int N = Rows();
@@ -91,8 +119,69 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 
 		r[j] += rj;
 	}
+}
 
-	return true;
+//-----------------------------------------------------------------------------
+void CompactSymmMatrix::mult_vector_parallel(double* x, double* r)
+{
+	const int N = Rows();
+	const int* mptr = &m_mptr[0];
+	const int* mcol = (m_mcol.empty() ? nullptr : &m_mcol[0]);
+	const int* mpos = (m_mpos.empty() ? nullptr : &m_mpos[0]);
+
+	#pragma omp parallel for schedule(guided)
+	for (int i = 0; i < N; ++i)
+	{
+		// diagonal and upper-triangular elements
+		const double* pv = m_pd + (m_ppointers[i] - m_offset);
+		const int* pi = m_pindices + (m_ppointers[i] - m_offset);
+		const int n = m_ppointers[i + 1] - m_ppointers[i];
+		double ri = 0.0;
+		for (int k = 0; k < n; ++k) ri += pv[k] * x[pi[k] - m_offset];
+
+		// lower-triangular elements
+		for (int k = mptr[i]; k < mptr[i + 1]; ++k) ri += m_pd[mpos[k]] * x[mcol[k]];
+
+		r[i] = ri;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void CompactSymmMatrix::BuildMirror()
+{
+	const int N = Rows();
+
+	// count the strict lower-triangular entries of each row
+	m_mptr.assign(N + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = m_ppointers[j] - m_offset; k < m_ppointers[j + 1] - m_offset; ++k)
+		{
+			int i = m_pindices[k] - m_offset;
+			if (i > j) m_mptr[i + 1]++;
+		}
+	}
+	for (int i = 0; i < N; ++i) m_mptr[i + 1] += m_mptr[i];
+
+	// fill the mirror. Since we loop over the columns in order, the
+	// entries of each row end up sorted by column index.
+	int nm = m_mptr[N];
+	m_mcol.resize(nm);
+	m_mpos.resize(nm);
+	vector<int> tag(m_mptr.begin(), m_mptr.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = m_ppointers[j] - m_offset; k < m_ppointers[j + 1] - m_offset; ++k)
+		{
+			int i = m_pindices[k] - m_offset;
+			if (i > j)
+			{
+				int l = tag[i]++;
+				m_mcol[l] = j;
+				m_mpos[l] = k;
+			}
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -190,6 +279,10 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 
 	// find the permutation array that sorts LM in ascending order
 	// we can use this to speed up the row search (i.e. loop over n below)
+	// NOTE: This function can be called from multiple threads, so we cannot use a member here.
+	// The array is taken from the scratch pool of the calling thread instead.
+	FEScratch< vector<int> > pP;
+	vector<int>& P = pP;
 	P.resize(N);
 	qsort(N, &LM[0], &P[0]);
 
@@ -221,8 +314,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
-					#pragma omp atomic
-					pm[n] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
@@ -257,8 +354,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 				for (int n = 0; n<l; ++n) 
 					if (pi[n] - m_offset == I)
 					{
-						#pragma omp atomic
-						pv[n] += ke[i][j];
+						if (m_batomic)
+						{
+							#pragma omp atomic
+							pv[n] += ke[i][j];
+						}
+						else pv[n] += ke[i][j];
 						break;
 					}
 			}
@@ -266,6 +367,36 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 	}
 }
 
+//-----------------------------------------------------------------------------
+// Find the offsets into the value array for each entry of an element matrix.
+// Only entries in the lower-triangular part are mapped, consistent with Assemble.
+bool CompactSymmMatrix::BuildScatterMap(int nr, int nc, const vector<int>& LMi, const vector<int>& LMj, vector<int>& map)
+{
+	map.assign(nr*nc, -1);
+	for (int j = 0; j < nc; ++j)
+	{
+		int J = LMj[j];
+		if (J < 0) continue;
+
+		int* pi = m_pindices + (m_ppointers[J] - m_offset);
+		int l = m_ppointers[J + 1] - m_ppointers[J];
+		for (int i = 0; i < nr; ++i)
+		{
+			int I = LMi[i];
+			if (I >= J)
+			{
+				// the row indices are sorted, so we can do a binary search
+				int* p = lower_bound(pi, pi + l, I + m_offset);
+				if ((p != pi + l) && (*p == I + m_offset))
+				{
+					map[i*nc + j] = (m_ppointers[J] - m_offset) + (int)(p - pi);
+				}
+			}
+		}
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! add a matrix item
 void CompactSymmMatrix::add(int i, int j, double v)
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "CompactMatrix.h"
 #include "fecore_api.h"
+#include <vector>
 
 //=============================================================================
 //! This class stores a sparse matrix in Harwell-Boeing format (i.e. column major, lower triangular compact).
@@ -45,12 +46,18 @@ public:
 	//! Create the matrix structure from the SparseMatrixProfile.
 	void Create(SparseMatrixProfile& mp) override;
 
+	//! Clear
+	void Clear() override;
+
 	//! Assemble an element matrix into the global matrix
 	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
 
 	//! assemble a matrix into the sparse matrix
 	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
 
+	//! build a scatter map for an element matrix
+	bool BuildScatterMap(int nr, int nc, const std::vector<int>& lmi, const std::vector<int>& lmj, std::vector<int>& map) override;
+
 	//! add a matrix item
 	void add(int i, int j, double v) override;
 
@@ -86,4 +93,33 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+public:
+	//! enable or disable the threaded matrix-vector product
+	void SetParallelMultiply(bool b) { m_bparallel = b; }
+
+	//! is the threaded matrix-vector product enabled
+	bool ParallelMultiply() const { return m_bparallel; }
+
+protected:
+	//! serial matrix-vector product
+	void mult_vector_serial(double* x, double* r);
+
+	//! threaded matrix-vector product
+	void mult_vector_parallel(double* x, double* r);
+
+	//! build the row-wise index of the strict lower triangle
+	void BuildMirror();
+
+private:
+	bool	m_bparallel;	//!< use the threaded matrix-vector product
+
+	// The threaded product computes each row of the result independently. The diagonal and
+	// upper triangle of row i are stored contiguously in column i. The remaining entries of
+	// row i (i.e. the strict lower triangle) are found through this mirror, which stores the
+	// column and the position in the value array of each entry. Since the mirror only stores
+	// positions, it does not need to be updated when the matrix values change.
+	std::vector<int>	m_mptr;		//!< start of each row in the mirror
+	std::vector<int>	m_mcol;		//!< (zero-based) column index of the mirror entries
+	std::vector<int>	m_mpos;		//!< position in the value array of the mirror entries
 };
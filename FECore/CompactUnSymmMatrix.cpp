@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactUnSymmMatrix.h"
+#include <algorithm>
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -251,6 +252,35 @@ void CRSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const v
 	}
 }
 
+//-----------------------------------------------------------------------------
+// Find the offsets into the value array for each entry of an element matrix.
+bool CRSSparseMatrix::BuildScatterMap(int nr, int nc, const vector<int>& LMi, const vector<int>& LMj, vector<int>& map)
+{
+	map.assign(nr*nc, -1);
+	for (int i = 0; i < nr; ++i)
+	{
+		int I = LMi[i];
+		if (I < 0) continue;
+
+		int* pi = m_pindices + (m_ppointers[I] - m_offset);
+		int l = m_ppointers[I + 1] - m_ppointers[I];
+		for (int j = 0; j < nc; ++j)
+		{
+			int J = LMj[j];
+			if (J >= 0)
+			{
+				// the column indices are sorted, so we can do a binary search
+				int* p = lower_bound(pi, pi + l, J + m_offset);
+				if ((p != pi + l) && (*p == J + m_offset))
+				{
+					map[i*nc + j] = (m_ppointers[I] - m_offset) + (int)(p - pi);
+				}
+			}
+		}
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // This algorithm uses a binary search for locating the correct row index
 // This assumes that the indices are ordered!
@@ -73,6 +73,9 @@ public:
 	//! assemble a matrix into the sparse matrix
 	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
 
+	//! build a scatter map for an element matrix
+	bool BuildScatterMap(int nr, int nc, const std::vector<int>& lmi, const std::vector<int>& lmj, std::vector<int>& map) override;
+
 	//! add a value to the matrix item
 	void add(int i, int j, double v) override;
 
@@ -0,0 +1,84 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <cstdlib>
+#include <new>
+#ifdef WIN32
+#include <malloc.h>
+#endif
+
+//-----------------------------------------------------------------------------
+//! Allocator that aligns the storage to a cache line. This is used for arrays that are
+//! streamed through in the element loops, so that they don't share cache lines with
+//! unrelated data and can be loaded with aligned vector instructions.
+template <typename T, size_t Alignment = 64>
+class FEAlignedAllocator
+{
+public:
+	typedef T value_type;
+
+	template <typename U> struct rebind { typedef FEAlignedAllocator<U, Alignment> other; };
+
+public:
+	FEAlignedAllocator() {}
+	template <typename U> FEAlignedAllocator(const FEAlignedAllocator<U, Alignment>&) {}
+
+	T* allocate(size_t n)
+	{
+		if (n == 0) return nullptr;
+		void* p = nullptr;
+#ifdef WIN32
+		p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+		if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0) p = nullptr;
+#endif
+		if (p == nullptr) throw std::bad_alloc();
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, size_t)
+	{
+#ifdef WIN32
+		_aligned_free(p);
+#else
+		free(p);
+#endif
+	}
+};
+
+template <typename T, typename U, size_t A>
+bool operator == (const FEAlignedAllocator<T, A>&, const FEAlignedAllocator<U, A>&) { return true; }
+
+template <typename T, typename U, size_t A>
+bool operator != (const FEAlignedAllocator<T, A>&, const FEAlignedAllocator<U, A>&) { return false; }
+
+//-----------------------------------------------------------------------------
+//! vector with cache-line aligned storage
+template <typename T> using FEAlignedVector = std::vector<T, FEAlignedAllocator<T> >;
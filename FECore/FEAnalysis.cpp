@@ -35,8 +35,11 @@ SOFTWARE.*/
 #include "MatrixProfile.h"
 #include "FEBoundaryCondition.h"
 #include "DumpMemStream.h"
+#include "FESolutionSnapshot.h"
+#include "FEMeshReorder.h"
 #include "FELinearConstraintManager.h"
 #include "FEShellDomain.h"
+#include "FESolidDomain.h"
 #include "FEMeshAdaptor.h"
 #include "FETimeStepController.h"
 #include "FEModule.h"
@@ -65,6 +68,9 @@ BEGIN_FECORE_CLASS(FEAnalysis, FECoreBase)
 
 	BEGIN_PARAM_GROUP("Advanced settings");
 		ADD_PARAMETER(m_badaptorReSolve, "adaptor_re_solve")->setLongName("re-solve after adaptation");
+		ADD_PARAMETER(m_nrefGeomCache, "reference_geometry_cache", 0, "NONE\0JACOBIANS\0SHAPE_GRADIENTS\0")->setLongName("cache reference geometry");
+		ADD_PARAMETER(m_bsnapshot, "rollback_snapshot")->setLongName("use solution snapshots for retries");
+		ADD_PARAMETER(m_nmeshReorder, "mesh_reorder", 0, "NONE\0HILBERT\0MORTON\0RCM\0")->setLongName("reorder mesh for memory locality");
 	END_PARAM_GROUP();
 
 	ADD_PROPERTY(m_timeController, "time_stepper", FEProperty::Preferred)->SetDefaultType("default").SetLongName("Auto time stepper");
@@ -88,6 +94,9 @@ FEAnalysis::FEAnalysis(FEModel* fem) : FECoreBase(fem)
 	// --- Analysis data ---
 	m_nanalysis = 0;
 	m_badaptorReSolve = true;
+	m_nrefGeomCache = FESolidDomain::REF_CACHE_NONE;
+	m_bsnapshot = false;
+	m_nmeshReorder = FEMeshReorder::REORDER_NONE;
 
 	// --- Time Step Data ---
 	m_ntime = 10;
@@ -125,6 +134,9 @@ FEAnalysis::~FEAnalysis()
 void FEAnalysis::CopyFrom(FEAnalysis* step)
 {
 	m_nanalysis = step->m_nanalysis;
+	m_nrefGeomCache = step->m_nrefGeomCache;
+	m_bsnapshot = step->m_bsnapshot;
+	m_nmeshReorder = step->m_nmeshReorder;
 
 	m_ntime      = step->m_ntime;
 	m_final_time = step->m_final_time;
@@ -303,6 +315,15 @@ bool FEAnalysis::Activate()
 	// be applied after initial conditions.
 	for (int i=0; i<(int) m_MC.size(); ++i) m_MC[i]->Activate();
 
+	// set up the reference geometry cache of the solid domains
+	// NOTE: this must be done after the model components are activated, since
+	// some (e.g. contact interfaces) may move the reference nodes.
+	for (int i = 0; i < ndom; ++i)
+	{
+		FESolidDomain* solidDomain = dynamic_cast<FESolidDomain*>(&mesh.Domain(i));
+		if (solidDomain) solidDomain->SetReferenceGeometryCache(m_nrefGeomCache);
+	}
+
 	// Next, we need to determine which degrees of freedom are active. 
 	// We start by resetting all nodal degrees of freedom.
 	for (int i=0; i<mesh.Nodes(); ++i)
@@ -411,7 +432,10 @@ bool FEAnalysis::Solve()
 	}
 
 	// dump stream for running restarts
+	// (Only used when solution snapshots are turned off. The snapshot only stores
+	// the solution state, which is much cheaper than serializing the model.)
 	DumpMemStream dmp(fem);
+	FESolutionSnapshot snapshot(&fem);
 
 	// repeat for all timesteps
 	if (m_timeController) m_timeController->m_nretries = 0;
@@ -421,8 +445,12 @@ bool FEAnalysis::Solve()
 		// we need to retry this time step
 		if (m_timeController && (m_timeController->m_maxretries > 0))
 		{ 
-			dmp.clear();
-			fem.Serialize(dmp); 
+			if (m_bsnapshot) snapshot.Save();
+			else
+			{
+				dmp.clear();
+				fem.Serialize(dmp);
+			}
 		}
 
 		// Inform that the time is about to change. (Plugins can use 
@@ -510,8 +538,12 @@ bool FEAnalysis::Solve()
 			if (m_timeController && (m_timeController->m_nretries < m_timeController->m_maxretries))
 			{
 				// restore the previous state
-				dmp.Open(false, true);
-				fem.Serialize(dmp);
+				if (m_bsnapshot) snapshot.Restore();
+				else
+				{
+					dmp.Open(false, true);
+					fem.Serialize(dmp);
+				}
 				
 				// let's try again
 				m_timeController->Retry();
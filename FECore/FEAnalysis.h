@@ -148,6 +148,9 @@ public:
 	//{
 		int		m_nanalysis;		//!< analysis type
 		bool	m_badaptorReSolve;	//!< resolve analysis after mesh adaptor phase
+		int		m_nrefGeomCache;	//!< level of the reference geometry cache of solid domains
+		bool	m_bsnapshot;		//!< use solution snapshots (instead of serialization) for retries
+		int		m_nmeshReorder;		//!< reordering of the mesh that is applied after input (see FEMeshReorder)
 	//}
 
 	// --- Time Step Data ---
@@ -30,6 +30,8 @@ SOFTWARE.*/
 #include "FEClosestPointProjection.h"
 #include "FEElemElemList.h"
 #include "FEMesh.h"
+#include "FESurfaceBVH.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // constructor
@@ -223,10 +225,13 @@ FESurfaceElement* FEClosestPointProjection::Project(int nodeIndex, vec3d& q, vec
 	// 2. its star does not contain n
 	int mn = -1;	// local index of closest node
 	double d2min;	// min squared distance
-	int N = m_surf.Nodes();
+	vector<int> nodeList;
+	CandidateNodes(x, nodeList);
+	int N = (int)nodeList.size();
 	double R2 = m_rad * m_rad;
-	for (int i = 0; i < N; ++i)
+	for (int k = 0; k < N; ++k)
 	{
+		int i = nodeList[k];
 		if (m_surf.NodeIndex(i) != nodeIndex)
 		{
 			vec3d r = m_surf.Node(i).m_rt;
@@ -305,9 +310,12 @@ FESurfaceElement* FEClosestPointProjection::Project(FESurfaceElement* pse, int i
 	int mn = -1;
 	double d2min;
 	double R2 = m_rad * m_rad;
-	int N = m_surf.Nodes();
-	for (int i = 0; i < N; ++i)
+	vector<int> nodeList;
+	CandidateNodes(x, nodeList);
+	int N = (int)nodeList.size();
+	for (int k = 0; k < N; ++k)
 	{
+		int i = nodeList[k];
 		vec3d ri = m_surf.Node(i).m_rt;
 		double d2 = (ri - x)*(ri - x);
 
@@ -361,6 +369,50 @@ FESurfaceElement* FEClosestPointProjection::Project(FESurfaceElement* pse, int i
 	return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+// Collect the (local) surface nodes that need to be considered in the self-projections.
+// When a search radius is set, only the nodes of facets within that radius of x are
+// returned, otherwise all nodes. The list is sorted, so the nodes are visited in the
+// same order as a loop over all surface nodes would.
+void FEClosestPointProjection::CandidateNodes(const vec3d& x, vector<int>& nodeList)
+{
+	nodeList.clear();
+	FESurfaceBVH* bvh = m_SNQ.GetBVH();
+	if ((m_rad > 0) && bvh)
+	{
+		vector<int> facets;
+		bvh->FindCandidates(x, m_rad, facets);
+		for (size_t i = 0; i < facets.size(); ++i)
+		{
+			FESurfaceElement& el = m_surf.Element(facets[i]);
+			for (int j = 0; j < el.Nodes(); ++j) nodeList.push_back(el.m_lnode[j]);
+		}
+		sort(nodeList.begin(), nodeList.end());
+		nodeList.erase(unique(nodeList.begin(), nodeList.end()), nodeList.end());
+	}
+	else
+	{
+		int N = m_surf.Nodes();
+		nodeList.resize(N);
+		for (int i = 0; i < N; ++i) nodeList[i] = i;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEClosestPointProjection::Project(const std::vector<vec3d>& x, std::vector<FESurfaceElement*>& pe, std::vector<vec3d>& q, std::vector<vec2d>& r)
+{
+	int N = (int)x.size();
+	pe.resize(N);
+	q.resize(N);
+	r.resize(N);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < N; ++i)
+	{
+		pe[i] = Project(x[i], q[i], r[i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
 bool FEClosestPointProjection::ContainsElement(FESurfaceElement* el)
 {
 	if (el == nullptr) return false;
@@ -41,7 +41,7 @@ public:
 	//! constructor
 	FEClosestPointProjection(FESurface& s);
 
-	//! Initialization
+	//! Initialization (must be called outside parallel regions)
 	bool Init();
 
 	//! Project a point onto surface
@@ -53,6 +53,9 @@ public:
 	//! Project a point of a surface element onto a surface
 	FESurfaceElement* Project(FESurfaceElement* pse, int intgrPoint, vec3d& q, vec2d& r);
 
+	//! Project a batch of points onto the surface (evaluated in parallel)
+	void Project(const std::vector<vec3d>& x, std::vector<FESurfaceElement*>& pe, std::vector<vec3d>& q, std::vector<vec2d>& r);
+
 public:
 	//! Set the projection tolerance
 	void SetTolerance(double t) { m_tol = t; }
@@ -72,6 +75,7 @@ public:
 private:
 	bool ContainsElement(FESurfaceElement* el);
 	FESurfaceElement* ProjectSpecial(int closestPoint, const vec3d& x, vec3d& q, vec2d& r);
+	void CandidateNodes(const vec3d& x, std::vector<int>& nodeList);
 
 protected:
 	double	m_tol;	//!< projection tolerance
@@ -85,13 +85,19 @@ FEDataMap* FEDataMathGenerator::Generate()
 	FENodeDataMap* map = new FENodeDataMap(FE_DOUBLE);
 	map->Create(m_nodeSet);
 	int N = m_nodeSet->Size();
+
+	// evaluate the expression for all nodes at once
+	vector<double> p(3 * N), v(N);
 	for (int i=0; i<N; ++i)
 	{
 		FENode* node = m_nodeSet->Node(i);
 		vec3d r = node->m_r0;
-		vector<double> p{ r.x, r.y, r.z };
-		double v = m_val[0].value_s(p);
-		map->setValue(i, v);
+		p[3 * i    ] = r.x;
+		p[3 * i + 1] = r.y;
+		p[3 * i + 2] = r.z;
 	}
+	m_val[0].values_s(N, p.data(), v.data());
+
+	for (int i = 0; i < N; ++i) map->setValue(i, v[i]);
 	return map;
 }
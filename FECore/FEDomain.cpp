@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include "DumpStream.h"
 #include "FEMesh.h"
 #include "FEGlobalMatrix.h"
+#include "FELinearSystem.h"
+#include "FEGlobalVector.h"
 
 //-----------------------------------------------------------------------------
 FEDomain::FEDomain(int nclass, FEModel* fem) : FEMeshPartition(nclass, fem)
@@ -87,14 +89,7 @@ void FEDomain::Serialize(DumpStream& ar)
 
 	if (ar.IsShallow())
 	{
-		int NEL = Elements();
-		for (int i = 0; i < NEL; ++i)
-		{
-			FEElement& el = ElementRef(i);
-			el.Serialize(ar);
-			int nint = el.GaussPoints();
-			for (int j = 0; j < nint; ++j) el.GetMaterialPoint(j)->Serialize(ar);
-		}
+		SerializeMaterialPoints(ar, 0, Elements());
 	}
 	else
 	{
@@ -140,6 +135,25 @@ void FEDomain::Serialize(DumpStream& ar)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void FEDomain::SerializeState(DumpStream& ar)
+{
+	assert(ar.IsShallow());
+	FEMeshPartition::Serialize(ar);
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::SerializeMaterialPoints(DumpStream& ar, int n0, int n1)
+{
+	for (int i = n0; i < n1; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		el.Serialize(ar);
+		int nint = el.GaussPoints();
+		for (int j = 0; j < nint; ++j) el.GetMaterialPoint(j)->Serialize(ar);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! Unpack the LM data for an element of this domain
 void FEDomain::UnpackLM(FEElement& el, vector<int>& lm)
@@ -209,3 +223,121 @@ void FEDomain::Activate(const FEDofList& dof)
 		}
 	}
 }
+
+//-----------------------------------------------------------------------------
+// This function partitions the elements into colors using a greedy algorithm.
+// Two elements that share a node will always be assigned a different color,
+// so that elements of the same color never write to the same equations.
+void FEDomain::CreateElementColors()
+{
+	m_elemColor.clear();
+
+	FEMesh& mesh = *GetMesh();
+	const int NN = mesh.Nodes();
+	const int NE = Elements();
+
+	// build the node-element table
+	vector<int> pn(NN + 1, 0);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		for (int j = 0; j < el.Nodes(); ++j) pn[el.m_node[j] + 1]++;
+	}
+	for (int i = 0; i < NN; ++i) pn[i + 1] += pn[i];
+
+	vector<int> nel(pn[NN]);
+	vector<int> pos(pn.begin(), pn.end() - 1);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		for (int j = 0; j < el.Nodes(); ++j) nel[pos[el.m_node[j]]++] = i;
+	}
+
+	// assign each element the lowest color that is not used by any of its neighbors
+	vector<int> color(NE, -1);
+	vector<int> tag;
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		for (int j = 0; j < el.Nodes(); ++j)
+		{
+			int n = el.m_node[j];
+			for (int k = pn[n]; k < pn[n + 1]; ++k)
+			{
+				int c = color[nel[k]];
+				if (c >= 0) tag[c] = i;
+			}
+		}
+
+		int c = 0;
+		while ((c < (int)tag.size()) && (tag[c] == i)) c++;
+		if (c == (int)tag.size())
+		{
+			tag.push_back(-1);
+			m_elemColor.push_back(vector<int>());
+		}
+
+		color[i] = c;
+		m_elemColor[c].push_back(i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+int FEDomain::ElementColors()
+{
+	// (re)build the colors if the element count has changed
+	size_t ne = 0;
+	for (size_t i = 0; i < m_elemColor.size(); ++i) ne += m_elemColor[i].size();
+	if (m_elemColor.empty() || (ne != (size_t)Elements())) CreateElementColors();
+
+	return (int)m_elemColor.size();
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::AssembleElements(FELinearSystem& LS, std::function<void(int iel)> f)
+{
+	if (LS.ColoredAssembly() == false)
+	{
+		const int NE = Elements();
+		#pragma omp parallel for shared(f)
+		for (int i = 0; i < NE; ++i)
+		{
+			FEElement& el = ElementRef(i);
+			if (el.isActive()) f(i);
+		}
+	}
+	else
+	{
+		// elements of the same color do not share any equations,
+		// so we can turn off the atomic updates in the global matrix
+		SparseMatrix& K = LS.GetStiffnessMatrix();
+		K.SetAtomicAssembly(false);
+
+		const int NC = ElementColors();
+		for (int c = 0; c < NC; ++c)
+		{
+			const vector<int>& elist = m_elemColor[c];
+			const int NE = (int)elist.size();
+			#pragma omp parallel for shared(f)
+			for (int i = 0; i < NE; ++i)
+			{
+				FEElement& el = ElementRef(elist[i]);
+				if (el.isActive()) f(elist[i]);
+			}
+		}
+
+		K.SetAtomicAssembly(true);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::AssembleElements(FEGlobalVector& R, std::function<void(int iel)> f)
+{
+	const int NE = Elements();
+	#pragma omp parallel for shared(f)
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		if (el.isActive()) f(i);
+	}
+}
@@ -32,6 +32,8 @@ SOFTWARE.*/
 
 // forward declaration of material class
 class FEMaterial;
+class FELinearSystem;
+class FEGlobalVector;
 
 // Base class for solid and shell parts. Domains can also have materials assigned.
 class FECORE_API FEDomain : public FEMeshPartition
@@ -52,11 +54,19 @@ public:
 	//! This is called after elements get read in from the input file.
 	//! And must be called before material point data can be accessed.
 	//! \todo Perhaps I can make this part of the "creation" routine
-	void CreateMaterialPointData();
+	virtual void CreateMaterialPointData();
 
 	// serialization
 	void Serialize(DumpStream& ar) override;
 
+	//! Serialize the shallow data of this domain, except for the material point data.
+	//! Domains that stream additional data in a shallow Serialize must override this as well.
+	//! This is used by FESolutionSnapshot, which stores the material point data separately.
+	virtual void SerializeState(DumpStream& ar);
+
+	//! Serialize the (shallow) material point data of the elements in the range [n0, n1)
+	void SerializeMaterialPoints(DumpStream& ar, int n0, int n1);
+
 	//! augmentation
 	// NOTE: This is here so that the FESolver can do the augmentations
 	// for the 3-field hex/shell domains.
@@ -83,6 +93,27 @@ public:
 	//! indicates whether it is safe to commit the updates.
 	virtual void IncrementalUpdate(std::vector<double>& ui, bool finalFlag);
 
+public:
+	//! Partition the elements into colors, such that elements of the same color do not share any nodes.
+	void CreateElementColors();
+
+	//! return the number of element colors (the colors are created on first access)
+	int ElementColors();
+
+	//! return the list of elements of a particular color
+	const std::vector<int>& ElementColor(int n) const { return m_elemColor[n]; }
+
+	//! Loop over all active elements in parallel for assembling into the linear system.
+	//! The function is called with the (local) element index.
+	//! If the linear system requests colored assembly, the elements are processed one
+	//! color at a time and the global matrix is assembled without atomic updates.
+	void AssembleElements(FELinearSystem& LS, std::function<void(int iel)> f);
+
+	//! Loop over all active elements in parallel for assembling into a global vector.
+	//! If the caller started a buffered assembly on the global vector, each thread
+	//! assembles into its own partial vector (see FEGlobalVector::BeginBufferedAssembly).
+	void AssembleElements(FEGlobalVector& R, std::function<void(int iel)> f);
+
 protected:
 	// helper function for activating dof lists
 	void Activate(const FEDofList& dof);
@@ -92,4 +123,6 @@ protected:
 
 protected:
 	FEMat3dValuator* m_matAxis; // initial material axis
+
+	std::vector< std::vector<int> >	m_elemColor;	//!< element lists for each color
 };
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEModel.h"
 #include "FEDomain.h"
 #include "FESurface.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el)
@@ -44,6 +45,7 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke) : matrix(ke)
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
+	m_scatter = ke.m_scatter;
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +54,7 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke, double scale)
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
+	m_scatter = ke.m_scatter;
 	matrix& T = *this;
 	const matrix& K = ke;
 	T = (scale == 1.0 ? K : K*scale);
@@ -90,6 +93,12 @@ FEGlobalMatrix::FEGlobalMatrix(SparseMatrix* pK, bool del)
 	m_pMP = 0;
 	m_nlm = 0;
 	m_delA = del;
+	m_bcolored = false;
+	m_bscatter = false;
+	m_bincremental = false;
+	m_breuse = false;
+	m_btrack = false;
+	m_bdynValid = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -105,6 +114,7 @@ FEGlobalMatrix::~FEGlobalMatrix()
 void FEGlobalMatrix::Clear()
 { 
 	if (m_pA) m_pA->Clear(); 
+	m_scatter.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -120,6 +130,10 @@ void FEGlobalMatrix::build_begin(int neq)
 	m_pMP->CreateDiagonal();
 
 	m_nlm = 0;
+
+	// the profile no longer contains the dynamic part
+	m_bdynValid = false;
+	m_dynCols.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -155,6 +169,12 @@ void FEGlobalMatrix::build_flush()
 		{
 			lm = &(m_LM[i])[0];
 			for (j=0; j<n; ++j) if (lm[j] < -1) lm[j] = -lm[j]-2;
+
+			// remember which columns are changed
+			if (m_btrack)
+			{
+				for (j = 0; j<n; ++j) if (lm[j] >= 0) m_dynCols.push_back(lm[j]);
+			}
 		}
 	}
 
@@ -169,10 +189,26 @@ void FEGlobalMatrix::build_end()
 {
 	if (m_nlm > 0) build_flush();
 	m_pA->Create(*m_pMP);
+
+	// the matrix structure has changed, so the scatter maps are no longer valid
+	m_scatter.clear();
 }
 
 //-----------------------------------------------------------------------------
 bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
+{
+	// build the profile
+	BuildProfile(pfem, neq, breset);
+
+	// All done! We can now finish building the profile and create 
+	// the actual sparse matrix. This is done in the following function
+	build_end();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::BuildProfile(FEModel* pfem, int neq, bool breset)
 {
 	// The first time we come here we build the "static" profile.
 	// This static profile stores the contribution to the matrix profile
@@ -182,9 +218,23 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 	// reconstructing it every time we come here saves us a lot of time. The 
 	// static profile is stored in the variable m_MPs.
 
-	// begin building the profile
-	build_begin(neq);
+	// In incremental mode, the current profile still contains the static profile, 
+	// so we only have to undo the changes of the previous dynamic profile.
+	if (m_bincremental && (breset == false) && m_bdynValid && m_pMP && (m_pMP->Columns() == neq) && (m_MPs.Columns() == neq))
+	{
+		for (size_t i = 0; i < m_dynCols.size(); ++i)
+		{
+			int n = m_dynCols[i];
+			m_pMP->Column(n) = m_MPs.Column(n);
+		}
+		m_dynCols.clear();
+		m_nlm = 0;
+	}
+	else
 	{
+		// begin building the profile
+		build_begin(neq);
+
 		// The first time we are here we construct the "static"
 		// profile. This profile contains the contribution from
 		// all static elements. A static element is defined as
@@ -209,15 +259,44 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 			// copy the old static profile
 			*m_pMP = m_MPs;
 		}
+	}
+
+	// Add the "dynamic" profile
+	// (we keep track of the columns it changes, for the next incremental update, 
+	// or to see if the profile still fits in the matrix)
+	m_btrack = (m_bincremental || m_breuse);
+	pfem->BuildMatrixProfile(*this, false);
+	if (m_nlm > 0) build_flush();
 
-		// Add the "dynamic" profile
-		pfem->BuildMatrixProfile(*this, false);
+	if (m_btrack)
+	{
+		std::sort(m_dynCols.begin(), m_dynCols.end());
+		m_dynCols.erase(std::unique(m_dynCols.begin(), m_dynCols.end()), m_dynCols.end());
+		m_bdynValid = true;
 	}
-	// All done! We can now finish building the profile and create 
-	// the actual sparse matrix. This is done in the following function
-	build_end();
+	m_btrack = false;
+}
 
-	return true;
+//-----------------------------------------------------------------------------
+//! Since the static profile does not change, only the columns of the 
+//! dynamic profile need to be checked. Each column is compared with the matrix 
+//! structure in one pass.
+bool FEGlobalMatrix::ProfileFitsMatrix()
+{
+	if ((m_pMP == 0) || (m_bdynValid == false)) return false;
+	if ((m_pA->NonZeroes() == 0) || (m_pA->Rows() != m_pMP->Rows())) return false;
+
+	int nmiss = 0;
+	int N = (int)m_dynCols.size();
+#pragma omp parallel for reduction(+:nmiss) schedule(dynamic, 16)
+	for (int n = 0; n < N; ++n)
+	{
+		int j = m_dynCols[n];
+		const SparseMatrixProfile::ColumnProfile& col = m_pMP->Column(j);
+		if (m_pA->checkColumn(j, col) == false) nmiss++;
+	}
+
+	return (nmiss == 0);
 }
 
 //-----------------------------------------------------------------------------
@@ -314,7 +393,43 @@ bool FEGlobalMatrix::Create(const FESurface& surf, const std::vector<int>& equat
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+FEScatterMap* FEGlobalMatrix::GetScatterMaps(const void* src, int n)
+{
+	if (m_bscatter == false) return nullptr;
+
+	std::vector<FEScatterMap>& maps = m_scatter[src];
+	if (maps.size() != n) maps.resize(n);
+	return (n > 0 ? &maps[0] : nullptr);
+}
+
+//-----------------------------------------------------------------------------
 void FEGlobalMatrix::Assemble(const FEElementMatrix& ke)
 {
-	m_pA->Assemble(ke, ke.RowIndices(), ke.ColumnsIndices());
+	const vector<int>& lmi = ke.RowIndices();
+	const vector<int>& lmj = ke.ColumnsIndices();
+
+	FEScatterMap* map = ke.ScatterMap();
+	if (map)
+	{
+		// (re)build the map if this element matrix has different indices than the cached one
+		if ((map->lmi != lmi) || (map->lmj != lmj) || (map->offset.size() != ke.rows()*ke.columns()))
+		{
+			map->lmi = lmi;
+			map->lmj = lmj;
+			if (m_pA->BuildScatterMap(ke.rows(), ke.columns(), lmi, lmj, map->offset) == false)
+			{
+				map->offset.clear();
+			}
+		}
+
+		// if we have a valid map, we can do a direct scatter
+		if (map->offset.empty() == false)
+		{
+			m_pA->AssembleScatter(ke, map->offset);
+			return;
+		}
+	}
+
+	m_pA->Assemble(ke, lmi, lmj);
 }
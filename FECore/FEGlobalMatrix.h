@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "SparseMatrix.h"
 #include "FESolver.h"
 #include <vector>
+#include <map>
 
 //-----------------------------------------------------------------------------
 class FEModel;
@@ -38,6 +39,17 @@ class FEMesh;
 class FESurface;
 class FEElement;
 
+//-----------------------------------------------------------------------------
+//! A scatter map stores for each entry of an element matrix the offset into the
+//! value array of the global matrix. This allows element matrices to be added to
+//! the global matrix without searching the sparse matrix indices.
+struct FEScatterMap
+{
+	std::vector<int>	lmi;	//!< row indices the map was built for
+	std::vector<int>	lmj;	//!< column indices the map was built for
+	std::vector<int>	offset;	//!< offsets into the matrix values (-1 if the entry is not assembled)
+};
+
 //-----------------------------------------------------------------------------
 //! This class represents an element matrix, i.e. a matrix of values and the row and
 //! column indices of the corresponding matrix elements in the global matrix. 
@@ -82,10 +94,17 @@ public:
 	// get the nodes
 	const std::vector<int>& Nodes() const { return m_node; }
 
+	// set the scatter map that will be used to assemble this matrix (can be null)
+	void SetScatterMap(FEScatterMap* map) { m_scatter = map; }
+
+	// get the scatter map
+	FEScatterMap* ScatterMap() const { return m_scatter; }
+
 private:
 	std::vector<int>	m_node;	//!< node indices
 	std::vector<int>	m_lmi;	//!< row indices
 	std::vector<int>	m_lmj;	//!< column indices
+	FEScatterMap*		m_scatter = nullptr;	//!< cached scatter map
 };
 
 //-----------------------------------------------------------------------------
@@ -116,6 +135,14 @@ public:
 	//! construct the stiffness matrix from a FEM object
 	bool Create(FEModel* pfem, int neq, bool breset);
 
+	//! build the matrix profile from a FEM object, without creating the sparse matrix.
+	//! (Call build_end to create the sparse matrix.)
+	void BuildProfile(FEModel* pfem, int neq, bool breset);
+
+	//! Returns true if all entries of the current profile are stored in the sparse matrix.
+	//! This requires that the profile was built with pattern reuse or incremental updates turned on.
+	bool ProfileFitsMatrix();
+
 	//! construct the stiffness matrix from a mesh
 	bool Create(FEMesh& mesh, int neq);
 
@@ -153,6 +180,35 @@ public:
 	//! get the sparse matrix profile
 	SparseMatrixProfile* GetSparseMatrixProfile() { return m_pMP; }
 
+	//! Turn colored assembly on or off. In colored assembly, domains assemble their
+	//! elements one color at a time, where elements of the same color do not share nodes.
+	//! This allows the element matrices to be assembled without atomic updates.
+	void SetColoredAssembly(bool b) { m_bcolored = b; }
+
+	//! see if colored assembly is requested
+	bool ColoredAssembly() const { return m_bcolored; }
+
+	//! Turn caching of the element scatter maps on or off.
+	void SetCacheScatterMaps(bool b) { m_bscatter = b; }
+
+	//! Turn incremental profile updates on or off. When on, Create (without reset) only
+	//! restores the columns that the dynamic elements (e.g. contact) touched during the previous
+	//! call and then adds the current dynamic elements, instead of copying the entire static profile.
+	void SetIncrementalProfile(bool b) { m_bincremental = b; }
+
+	//! Allow the structure of the sparse matrix to be reused when the profile changes 
+	//! but still fits in the current matrix (see ProfileFitsMatrix). 
+	void SetReusePattern(bool b) { m_breuse = b; }
+
+	//! see if the matrix structure can be reused
+	bool ReusePattern() const { return m_breuse; }
+
+	//! Get the scatter maps for an assembly source (e.g. a domain) that assembles n element matrices.
+	//! The maps are built the first time an element matrix is assembled and are discarded when 
+	//! the matrix profile changes. This must be called outside of parallel regions.
+	//! Returns null if scatter maps are not cached.
+	FEScatterMap* GetScatterMaps(const void* src, int n);
+
 public:
 	void build_begin(int neq);
 	void build_add(std::vector<int>& lm);
@@ -162,6 +218,12 @@ public:
 protected:
 	SparseMatrix*	m_pA;	//!< the actual global stiffness matrix
 	bool			m_delA;	//!< delete A in destructor
+	bool			m_bcolored;	//!< use colored assembly
+	bool			m_bscatter;	//!< cache element scatter maps
+	bool			m_bincremental;	//!< update the dynamic profile incrementally
+	bool			m_breuse;		//!< reuse the matrix structure if the profile fits
+
+	std::map<const void*, std::vector<FEScatterMap> >	m_scatter;	//!< the scatter maps for each assembly source
 
 	// The following data structures are used to incrementally
 	// build the profile of the sparse matrix
@@ -170,4 +232,8 @@ protected:
 	SparseMatrixProfile		m_MPs;		//!< the "static" part of the matrix profile
 	vector< vector<int> >	m_LM;		//!< used for building the stiffness matrix
 	int	m_nlm;				//!< nr of elements in m_LM array
+
+	bool			m_btrack;		//!< record the columns of the elements that are added
+	bool			m_bdynValid;	//!< m_pMP is the static profile plus the columns in m_dynCols
+	vector<int>		m_dynCols;		//!< columns touched by the dynamic profile
 };
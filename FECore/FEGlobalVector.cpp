@@ -30,10 +30,22 @@ SOFTWARE.*/
 #include "FEGlobalVector.h"
 #include "vec3d.h"
 #include "FEModel.h"
+#include "FEAnalysis.h"
+#include "FENewtonSolver.h"
+#include <assert.h>
+#include <omp.h>
 
 //-----------------------------------------------------------------------------
 FEGlobalVector::FEGlobalVector(FEModel& fem, vector<double>& R, vector<double>& Fr) : m_fem(fem), m_R(R), m_Fr(Fr)
 {
+	m_part = nullptr;
+
+	// see if the solver requests buffered assembly. The solver also keeps the
+	// partial vectors, so that they keep their memory between residual evaluations.
+	FEAnalysis* step = fem.GetCurrentStep();
+	FENewtonSolver* solver = (step ? dynamic_cast<FENewtonSolver*>(step->GetFESolver()) : nullptr);
+	m_bbuffered = (solver ? solver->m_bbuffered_residual : false);
+	m_buf = (solver ? &solver->m_Rpart : nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -42,6 +54,53 @@ FEGlobalVector::~FEGlobalVector()
 
 }
 
+//-----------------------------------------------------------------------------
+void FEGlobalVector::BeginBufferedAssembly()
+{
+	assert(m_part == nullptr);
+	assert(m_buf);
+	vector< vector<double> >& part = *m_buf;
+	const int nsize = (int)(m_R.size() + m_Fr.size());
+	const int nt = omp_get_max_threads();
+	if ((int)part.size() < nt) part.resize(nt);
+
+	// each thread zeroes its own partial vector
+	#pragma omp parallel for schedule(static, 1)
+	for (int n = 0; n < nt; ++n) part[n].assign(nsize, 0.0);
+
+	m_part = m_buf;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalVector::EndBufferedAssembly()
+{
+	assert(m_part);
+	vector< vector<double> >& part = *m_part;
+	m_part = nullptr;
+
+	const int nt = omp_get_max_threads();
+	const int neq = (int)m_R.size();
+	const int nfr = (int)m_Fr.size();
+	double* R = (neq > 0 ? &m_R[0] : nullptr);
+	double* Fr = (nfr > 0 ? &m_Fr[0] : nullptr);
+
+	// sum the partial vectors (each entry is owned by one thread)
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < neq + nfr; ++i)
+	{
+		double s = 0.0;
+		for (int n = 0; n < nt; ++n) s += part[n][i];
+		if (i < neq) R[i] += s; else Fr[i - neq] += s;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double* FEGlobalVector::PartialVector()
+{
+	if (m_part == nullptr) return nullptr;
+	return (*m_part)[omp_get_thread_num()].data();
+}
+
 //-----------------------------------------------------------------------------
 void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
@@ -49,6 +108,19 @@ void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>&
 
 	// assemble the element residual into the global residual
 	int ndof = (int)fe.size();
+	double* pR = PartialVector();
+	if (pR)
+	{
+		double* pFr = pR + R.size();
+		for (int i = 0; i < ndof; ++i)
+		{
+			int I = elm[i];
+			if (I >= 0) pR[I] += fe[i];
+			else if (-I - 2 >= 0) pFr[-I - 2] -= fe[i];
+		}
+		return;
+	}
+
 	for (int i=0; i<ndof; ++i)
 	{
 		int I = elm[i];
@@ -70,12 +142,16 @@ void FEGlobalVector::Assemble(vector<int>& lm, vector<double>& fe)
 {
 	vector<double>& R = m_R;
 	const int n = (int) lm.size();
+	double* pR = PartialVector();
 	for (int i=0; i<n; ++i)
 	{
 		int nid = lm[i];
 		if (nid >= 0) {
+			if (pR) pR[nid] += fe[i];
+			else {
 #pragma omp atomic
-			R[nid] += fe[i];
+				R[nid] += fe[i];
+			}
 		}
 	}
 }
@@ -90,7 +166,11 @@ void FEGlobalVector::Assemble(int nodeId, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
+		double* pR = PartialVector();
+		if (pR) pR[n] += f;
+		else {
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 }
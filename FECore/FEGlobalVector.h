@@ -65,8 +65,37 @@ public:
 
 	operator std::vector<double>& () { return m_R; }
 
+public:
+	//! Turn assembly into per-thread partial vectors on or off. When on, the solver brackets
+	//! its force evaluations with Begin/EndBufferedAssembly, and the Assemble functions add to a private
+	//! copy of this vector for each thread, so that no atomic updates are needed.
+	//! The default is taken from the "buffered_residual" parameter of the current Newton solver,
+	//! which also owns the partial vectors. Without a Newton solver, buffering is not available.
+	void SetThreadBuffers(bool b) { m_bbuffered = b; }
+
+	//! see if per-thread partial vectors are used
+	bool ThreadBuffers() const { return (m_bbuffered && m_buf); }
+
+	//! Allocate and zero the partial vectors. Until EndBufferedAssembly is called, the 
+	//! Assemble functions add to the partial vector of the calling thread, so
+	//! the vector should not be read until then.
+	void BeginBufferedAssembly();
+
+	//! Add the partial vectors to the global vector and the reaction forces.
+	void EndBufferedAssembly();
+
+protected:
+	//! Returns the partial vector of the calling thread, or nullptr when the Assemble functions
+	//! have to update the global vector directly. The partial reaction forces are stored 
+	//! after the partial vector, i.e. starting at index Size().
+	double* PartialVector();
+
 protected:
 	FEModel&			m_fem;	//!< model
 	std::vector<double>&		m_R;	//!< residual
 	std::vector<double>&		m_Fr;	//!< nodal reaction forces \todo I want to remove this
+
+	bool	m_bbuffered;	//!< assemble into per-thread partial vectors
+	std::vector< std::vector<double> >*	m_buf;	//!< storage of the partial vectors (owned by the Newton solver)
+	std::vector< std::vector<double> >*	m_part;	//!< partial vectors (only set during buffered assembly)
 };
@@ -0,0 +1,88 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEMeshPartition.h"
+#include "FEElement.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! This class stores one value of type T for each integration point of a domain.
+//! The values are stored in a single contiguous array, ordered by element and then
+//! by integration point. This gives a structure-of-arrays layout for per-point
+//! quantities that are accessed in the hot loops of the assembly, as opposed to 
+//! the linked list of FEMaterialPointData objects that each point carries.
+template <class T> class FEIntegrationPointArray
+{
+public:
+	FEIntegrationPointArray() {}
+
+	//! allocate storage for all integration points of the domain
+	void Create(FEMeshPartition& dom, const T& v = T())
+	{
+		int NE = dom.Elements();
+		m_off.resize(NE + 1);
+		m_off[0] = 0;
+		for (int i = 0; i < NE; ++i) m_off[i + 1] = m_off[i] + dom.ElementRef(i).GaussPoints();
+		m_data.assign(m_off[NE], v);
+	}
+
+	//! release all storage
+	void Clear() { m_off.clear(); m_data.clear(); }
+
+	//! number of elements
+	int Elements() const { return (m_off.empty() ? 0 : (int)m_off.size() - 1); }
+
+	//! total number of integration points
+	int Size() const { return (int)m_data.size(); }
+
+	//! number of integration points of element iel
+	int Points(int iel) const { return m_off[iel + 1] - m_off[iel]; }
+
+	//! returns true if the layout matches the domain
+	bool IsValid(const FEMeshPartition& dom) const
+	{
+		int NE = dom.Elements();
+		if (Elements() != NE) return false;
+		for (int i = 0; i < NE; ++i)
+			if (Points(i) != dom.ElementRef(i).GaussPoints()) return false;
+		return true;
+	}
+
+	//! access value at integration point n of element iel
+	T& operator () (int iel, int n) { return m_data[m_off[iel] + n]; }
+	const T& operator () (int iel, int n) const { return m_data[m_off[iel] + n]; }
+
+	//! pointer to the values of element iel
+	T* data(int iel) { return &m_data[m_off[iel]]; }
+	const T* data(int iel) const { return &m_data[m_off[iel]]; }
+
+private:
+	std::vector<int>	m_off;		//!< offset of first point of each element
+	std::vector<T>		m_data;		//!< packed values
+};
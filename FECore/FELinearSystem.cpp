@@ -50,6 +50,17 @@ bool FELinearSystem::IsSymmetric() const
 	return m_bsymm;
 }
 
+//-----------------------------------------------------------------------------
+// see if the global matrix should be assembled by element colors.
+// Linear constraints add to the equations of their parent nodes, which may belong
+// to other elements of the same color, so these still need the atomic updates.
+bool FELinearSystem::ColoredAssembly() const
+{
+	if (m_K.ColoredAssembly() == false) return false;
+	if (m_fem && (m_fem->GetLinearConstraintManager().LinearConstraints() > 0)) return false;
+	return true;
+}
+
 //! assemble global stiffness matrix
 void FELinearSystem::Assemble(const FEElementMatrix& ke)
 {
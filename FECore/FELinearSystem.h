@@ -52,6 +52,15 @@ public:
 	// get symmetry flag
 	bool IsSymmetric() const;
 
+	// see if the global matrix should be assembled by element colors
+	bool ColoredAssembly() const;
+
+	// get the global matrix
+	FEGlobalMatrix& GetStiffnessMatrix() { return m_K; }
+
+	// get the cached scatter maps for an assembly source (returns null if not cached)
+	FEScatterMap* GetScatterMaps(const void* src, int n) { return m_K.GetScatterMaps(src, n); }
+
 public:
 	// Assembly routine
 	// This assembles the element stiffness matrix ke into the global matrix.
@@ -0,0 +1,238 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMeshReorder.h"
+#include <algorithm>
+#include <assert.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// number of bits per coordinate of the curve keys
+#define CURVE_BITS	21
+
+//-----------------------------------------------------------------------------
+// spread the lower 21 bits of v so that they occupy every third bit
+static uint64_t spreadBits(unsigned int v)
+{
+	uint64_t x = v & 0x1fffff;
+	x = (x | (x << 32)) & 0x1f00000000ffffULL;
+	x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+	x = (x | (x <<  8)) & 0x100f00f00f00f00fULL;
+	x = (x | (x <<  4)) & 0x10c30c30c30c30c3ULL;
+	x = (x | (x <<  2)) & 0x1249249249249249ULL;
+	return x;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t FEMeshReorder::MortonKey(unsigned int x, unsigned int y, unsigned int z)
+{
+	return (spreadBits(x) << 2) | (spreadBits(y) << 1) | spreadBits(z);
+}
+
+//-----------------------------------------------------------------------------
+// The coordinates are first converted to the "transposed" Hilbert index, using
+// the algorithm of J. Skilling ("Programming the Hilbert curve", 2004). 
+// Interleaving the bits of the transposed coordinates gives the Hilbert index.
+uint64_t FEMeshReorder::HilbertKey(unsigned int x, unsigned int y, unsigned int z)
+{
+	unsigned int X[3] = { x, y, z };
+	const unsigned int M = 1u << (CURVE_BITS - 1);
+
+	// inverse undo
+	for (unsigned int Q = M; Q > 1; Q >>= 1)
+	{
+		unsigned int P = Q - 1;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (X[i] & Q) X[0] ^= P;
+			else
+			{
+				unsigned int t = (X[0] ^ X[i]) & P;
+				X[0] ^= t;
+				X[i] ^= t;
+			}
+		}
+	}
+
+	// Gray encode
+	X[1] ^= X[0];
+	X[2] ^= X[1];
+	unsigned int t = 0;
+	for (unsigned int Q = M; Q > 1; Q >>= 1)
+	{
+		if (X[2] & Q) t ^= Q - 1;
+	}
+	for (int i = 0; i < 3; ++i) X[i] ^= t;
+
+	return MortonKey(X[0], X[1], X[2]);
+}
+
+//-----------------------------------------------------------------------------
+void FEMeshReorder::CurveOrder(int method, const vector<vec3d>& r, vector<int>& P)
+{
+	int N = (int)r.size();
+	P.resize(N);
+	for (int i = 0; i < N; ++i) P[i] = i;
+	if (N < 2) return;
+
+	// find the bounding box
+	vec3d r0 = r[0], r1 = r[0];
+	for (int i = 1; i < N; ++i)
+	{
+		const vec3d& ri = r[i];
+		if (ri.x < r0.x) r0.x = ri.x;
+		if (ri.y < r0.y) r0.y = ri.y;
+		if (ri.z < r0.z) r0.z = ri.z;
+		if (ri.x > r1.x) r1.x = ri.x;
+		if (ri.y > r1.y) r1.y = ri.y;
+		if (ri.z > r1.z) r1.z = ri.z;
+	}
+
+	// we use the same scale in all directions so the curve is not distorted
+	double L = r1.x - r0.x;
+	if (r1.y - r0.y > L) L = r1.y - r0.y;
+	if (r1.z - r0.z > L) L = r1.z - r0.z;
+	if (L <= 0.0) return;
+
+	const unsigned int M = (1u << CURVE_BITS) - 1;
+	double s = (double)M / L;
+
+	// calculate the keys
+	vector<uint64_t> key(N);
+#pragma omp parallel for
+	for (int i = 0; i < N; ++i)
+	{
+		unsigned int x = (unsigned int)((r[i].x - r0.x) * s); if (x > M) x = M;
+		unsigned int y = (unsigned int)((r[i].y - r0.y) * s); if (y > M) y = M;
+		unsigned int z = (unsigned int)((r[i].z - r0.z) * s); if (z > M) z = M;
+
+		key[i] = (method == REORDER_MORTON ? MortonKey(x, y, z) : HilbertKey(x, y, z));
+	}
+
+	// sort the points (a stable sort keeps coincident points in their original order)
+	stable_sort(P.begin(), P.end(), [&](int a, int b) { return key[a] < key[b]; });
+}
+
+//-----------------------------------------------------------------------------
+// Breadth-first search from node root. On return, last contains the nodes of the 
+// last level and the return value is the number of levels minus one. 
+static int levelSearch(int root, const vector<int>& ptr, const vector<int>& ind, vector<int>& tag, int stamp, vector<int>& queue, vector<int>& last)
+{
+	queue.clear();
+	queue.push_back(root);
+	tag[root] = stamp;
+
+	size_t l0 = 0;
+	int depth = 0;
+	while (true)
+	{
+		size_t l1 = queue.size();
+		for (size_t i = l0; i < l1; ++i)
+		{
+			int n = queue[i];
+			for (int j = ptr[n]; j < ptr[n + 1]; ++j)
+			{
+				int m = ind[j];
+				if (tag[m] != stamp) { tag[m] = stamp; queue.push_back(m); }
+			}
+		}
+
+		if (queue.size() == l1)
+		{
+			last.assign(queue.begin() + l0, queue.begin() + l1);
+			return depth;
+		}
+
+		l0 = l1;
+		depth++;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Each connected component is numbered by a breadth-first search that starts at
+//! a pseudo-peripheral node (found with the algorithm of George and Liu) and that
+//! visits the neighbors of a node in order of increasing degree. The final order
+//! is reversed, since this usually reduces the profile.
+void FEMeshReorder::RCMOrder(const vector<int>& ptr, const vector<int>& ind, vector<int>& P)
+{
+	int N = (int)ptr.size() - 1;
+	P.clear();
+	if (N <= 0) return;
+	P.reserve(N);
+
+	vector<int> deg(N);
+	for (int i = 0; i < N; ++i) deg[i] = ptr[i + 1] - ptr[i];
+	auto byDegree = [&](int a, int b) { return deg[a] < deg[b]; };
+
+	// candidate start nodes in order of increasing degree
+	vector<int> seed(N);
+	for (int i = 0; i < N; ++i) seed[i] = i;
+	stable_sort(seed.begin(), seed.end(), byDegree);
+
+	vector<int> tag(N, -1), queue, last, last2, nbr;
+	vector<bool> visited(N, false);
+	int stamp = 0;
+	for (int k = 0; k < N; ++k)
+	{
+		int root = seed[k];
+		if (visited[root]) continue;
+
+		// find a pseudo-peripheral node of this component
+		int ecc = levelSearch(root, ptr, ind, tag, stamp++, queue, last);
+		while (ecc > 0)
+		{
+			int c = *min_element(last.begin(), last.end(), byDegree);
+			int e = levelSearch(c, ptr, ind, tag, stamp++, queue, last2);
+			if (e <= ecc) break;
+			root = c;
+			ecc = e;
+			last.swap(last2);
+		}
+
+		// Cuthill-McKee numbering of the component
+		size_t head = P.size();
+		P.push_back(root);
+		visited[root] = true;
+		while (head < P.size())
+		{
+			int n = P[head++];
+			nbr.clear();
+			for (int j = ptr[n]; j < ptr[n + 1]; ++j)
+			{
+				int m = ind[j];
+				if (visited[m] == false) { visited[m] = true; nbr.push_back(m); }
+			}
+			stable_sort(nbr.begin(), nbr.end(), byDegree);
+			P.insert(P.end(), nbr.begin(), nbr.end());
+		}
+	}
+	assert((int)P.size() == N);
+
+	reverse(P.begin(), P.end());
+}
@@ -0,0 +1,64 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "vec3d.h"
+#include "fecore_api.h"
+#include <vector>
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+//! This class calculates orderings of mesh entities that improve the memory 
+//! locality of the assembly and the sparse matrix operations. Points can be sorted
+//! along a space-filling (Hilbert or Morton) curve and graphs can be ordered with
+//! the reverse Cuthill-McKee algorithm.
+//! All orderings are returned as a permutation vector P, where P[i] is the
+//! (old) index of the entity that is placed at position i.
+class FECORE_API FEMeshReorder
+{
+public:
+	enum Method {
+		REORDER_NONE,
+		REORDER_HILBERT,
+		REORDER_MORTON,
+		REORDER_RCM
+	};
+
+public:
+	//! sort points along a space-filling curve (method is REORDER_HILBERT or REORDER_MORTON)
+	static void CurveOrder(int method, const std::vector<vec3d>& r, std::vector<int>& P);
+
+	//! reverse Cuthill-McKee ordering of a graph, stored in compressed row format
+	static void RCMOrder(const std::vector<int>& ptr, const std::vector<int>& ind, std::vector<int>& P);
+
+	//! position of a point along the Morton curve (coordinates are 21-bit integers)
+	static uint64_t MortonKey(unsigned int x, unsigned int y, unsigned int z);
+
+	//! position of a point along the Hilbert curve (coordinates are 21-bit integers)
+	static uint64_t HilbertKey(unsigned int x, unsigned int y, unsigned int z);
+};
@@ -1470,6 +1470,14 @@ void FEModel::Reactivate()
 
 	// reactivate the linear constraints
 	GetLinearConstraintManager().Activate();
+
+	// the surface interactions may have moved reference nodes
+	FEMesh& mesh = GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FESolidDomain* solidDomain = dynamic_cast<FESolidDomain*>(&mesh.Domain(i));
+		if (solidDomain) solidDomain->UpdateReferenceGeometryCache();
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -2458,6 +2466,11 @@ void FEModel::SerializeGeometry(DumpStream& ar)
 	ar & m_imp->m_mesh;
 }
 
+//-----------------------------------------------------------------------------
+void FEModel::SerializeGeometryState(DumpStream& ar)
+{
+}
+
 //-----------------------------------------------------------------------------
 // This function serializes data to a stream.
 // This is used for running and cold restarts.
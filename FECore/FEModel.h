@@ -385,6 +385,11 @@ public:	// --- Miscellaneous routines ---
 	//! Derived classes can override this
 	virtual void SerializeGeometry(DumpStream& ar);
 
+	//! Serialize the shallow geometry data that is not stored in the mesh (e.g. rigid bodies).
+	//! This is used by FESolutionSnapshot, which stores the mesh data separately, so
+	//! derived classes that stream more than the mesh in SerializeGeometry must override this.
+	virtual void SerializeGeometryState(DumpStream& ar);
+
 	//! set the active module
 	void SetActiveModule(const std::string& moduleName);
 
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FENNQuery.h"
 #include "FESurface.h"
+#include "FESurfaceBVH.h"
 #include <stdlib.h>
 #include "FEMesh.h"
 using namespace std;
@@ -48,6 +49,8 @@ int cmp_node(const void* e1, const void* e2)
 FENNQuery::FENNQuery(FESurface* ps)
 {
 	m_ps = ps;
+	m_bvh = nullptr;
+	m_imin = 0;
 }
 
 FENNQuery::~FENNQuery()
@@ -61,55 +64,10 @@ void FENNQuery::Init()
 {
 	assert(m_ps);
 
-	int i;
-	vec3d r0, r;
-	int N = m_ps->Nodes();
-
-	// pick a random point as pivot
-	r0 = m_q1 = m_ps->Node(0).m_rt;
-
-	// find the farthest node of this node
-	double dmax = 0, d;
-	for (i=0; i<N; ++i)
-	{
-		r = m_ps->Node(i).m_rt;
-		d = (r - r0)*(r - r0);
-		if (d > dmax)
-		{
-			m_q1 = r;
-			dmax = d;
-		}
-	}
-
-	// let's find the farthest node of this node
-	r0 = m_q2 = m_q1;
-	dmax = 0;
-	for (i=0; i<N; ++i)
-	{
-		r = m_ps->Node(i).m_rt;
-		d = (r - r0)*(r - r0);
-		if (d > dmax)
-		{
-			m_q2 = r;
-			dmax = d;
-		}
-	}
-
-	// create the BK-"tree"
-	m_bk.resize(N);
-	for (i=0; i<N; ++i) 
-	{
-		r = m_ps->Node(i).m_rt;
-		m_bk[i].i = i;
-		m_bk[i].r = r;
-		m_bk[i].d1 = (m_q1 - r)*(m_q1 - r);
-		m_bk[i].d2 = (m_q2 - r)*(m_q2 - r);
-	}
-
-	// sort the tree
-	qsort(&m_bk[0], N, sizeof(NODE), cmp_node);
-
-	// set the initial search item
+	// The surface hierarchy is refit to the current nodal positions. This replaces
+	// the BK-tree, which had to be rebuilt (and sorted) every time.
+	m_ps->UpdateBVH();
+	m_bvh = &m_ps->GetBVH();
 	m_imin = 0;
 }
 
@@ -118,6 +76,7 @@ void FENNQuery::Init()
 void FENNQuery::InitReference()
 {
 	assert(m_ps);
+	m_bvh = nullptr;
 
 	int i;
 	vec3d r0, r;
@@ -175,6 +134,8 @@ void FENNQuery::InitReference()
 
 int FENNQuery::Find(vec3d x)
 {
+	if (m_bvh) return m_bvh->FindClosestNode(x);
+
 	int m_i0 = -1;
 	double rmin1, rmin2, rmax1, rmax2;
 	double rmin1s, rmin2s, rmax1s, rmax2s;
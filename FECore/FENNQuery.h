@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include "fecore_api.h"
 
 class FESurface;
+class FESurfaceBVH;
 
 //-----------------------------------------------------------------------------
 //! This class is a helper class to locate the nearest neighbour on a surface
@@ -52,9 +53,15 @@ public:
 	virtual ~FENNQuery();
 
 	//! initialize search structures
+	//! Init uses the surface's bounding volume hierarchy (current configuration),
+	//! InitReference builds a BK-tree for searches in the reference configuration.
+	//! These must be called outside parallel regions.
 	void Init();
 	void InitReference();
 
+	//! the hierarchy used by Find (valid after Init)
+	FESurfaceBVH* GetBVH() { return m_bvh; }
+
 	//! attach to a surface
 	void Attach(FESurface* ps) { m_ps = ps; }
 
@@ -73,6 +80,8 @@ protected:
 	vec3d	m_q2;	// pivot 2
 
 	int		m_imin;	// last found index
+
+	FESurfaceBVH*	m_bvh;	//!< search hierarchy in the current configuration
 };
 
 // function for finding the k closest neighbors
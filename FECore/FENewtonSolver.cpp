@@ -61,6 +61,11 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 //		ADD_PARAMETER(m_bdoreforms          , "do_reforms"  );
 		ADD_PARAMETER(m_Rmin, FE_RANGE_GREATER_OR_EQUAL(0.0), "min_residual");
 		ADD_PARAMETER(m_Rmax, FE_RANGE_GREATER_OR_EQUAL(0.0), "max_residual");
+		ADD_PARAMETER(m_bcolored_assembly   , "colored_assembly");
+		ADD_PARAMETER(m_bbuffered_residual  , "buffered_residual");
+		ADD_PARAMETER(m_bcache_scatter      , "cache_scatter_maps");
+		ADD_PARAMETER(m_bincremental_profile, "incremental_profile");
+		ADD_PARAMETER(m_breuse_pattern      , "reuse_matrix_pattern");
 	END_PARAM_GROUP();
 
 	ADD_PROPERTY(m_qnstrategy, "qn_method", FEProperty::Preferred)->SetDefaultType("BFGS").SetLongName("Quasi-Newton method");
@@ -100,6 +105,11 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_force_partition = 0;
 	m_breformtimestep = true;
 	m_breformAugment = false;
+	m_bcolored_assembly = false;
+	m_bbuffered_residual = false;
+	m_bcache_scatter = false;
+	m_bincremental_profile = false;
+	m_breuse_pattern = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -278,6 +288,21 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 {
 	{
 		TRACK_TIME(TimerID::Timer_Reform);
+
+		// See if the new profile still fits in the current matrix. If so, we keep 
+		// the matrix and the linear solver can keep its symbolic factorization.
+		bool bprofile = false;
+		if ((breset == false) && m_pK->ReusePattern())
+		{
+			m_pK->BuildProfile(GetFEModel(), m_neq, breset);
+			if (m_pK->ProfileFitsMatrix())
+			{
+				feLogDebug("===== reusing stiffness matrix structure\n");
+				return true;
+			}
+			bprofile = true;
+		}
+
 		// clean up the solver
 		m_plinsolve->Destroy();
 
@@ -285,8 +310,13 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 		m_pK->Clear();
 
 		// create the stiffness matrix
+		// (if we already have the profile, we only need to create the sparse matrix)
 		feLog("===== reforming stiffness matrix:\n");
-		if (m_pK->Create(GetFEModel(), m_neq, breset) == false)
+		bool bret = true;
+		if (bprofile) m_pK->build_end();
+		else bret = m_pK->Create(GetFEModel(), m_neq, breset);
+
+		if (bret == false)
 		{
 			feLogError("An error occured while building the stiffness matrix\n\n");
 			return false;
@@ -406,6 +436,10 @@ bool FENewtonSolver::AllocateLinearSystem()
 		feLogError("Failed allocating stiffness matrix.");
 		return false;
 	}
+	m_pK->SetColoredAssembly(m_bcolored_assembly);
+	m_pK->SetCacheScatterMaps(m_bcache_scatter);
+	m_pK->SetIncrementalProfile(m_bincremental_profile);
+	m_pK->SetReusePattern(m_breuse_pattern);
 
 	return true;
 }
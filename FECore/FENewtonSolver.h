@@ -236,6 +236,11 @@ public:
 	bool				m_bforceReform;		//!< forces a reform in QNInit
 	bool				m_bdivreform;		//!< reform when diverging
 	bool				m_bdoreforms;		//!< do reformations
+	bool				m_bcolored_assembly;	//!< assemble the stiffness matrix by element colors
+	bool				m_bbuffered_residual;	//!< assemble the residual into per-thread partial vectors
+	bool				m_bcache_scatter;		//!< cache the element scatter maps of the stiffness matrix
+	bool				m_bincremental_profile;	//!< only rebuild the dynamic part of the matrix profile
+	bool				m_breuse_pattern;		//!< keep the matrix structure (and symbolic factorization) if the new profile fits
 
 	// counters
 	int		m_nref;			//!< nr of stiffness retormations
@@ -259,6 +264,9 @@ public:
 	vector<double> m_up;	//!< solution increment of previous iteration
 	vector<double> m_Fd;	//!< residual correction due to prescribed degrees of freedom
 
+	// per-thread partial residual vectors (see FEGlobalVector::BeginBufferedAssembly)
+	vector< vector<double> > m_Rpart;
+
 private:
 	double	m_ls;	//!< line search factor calculated in last call to QNSolve
 
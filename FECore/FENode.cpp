@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FENode.h"
 #include "DumpStream.h"
+#include <string.h>
 
 //=============================================================================
 // FENode
@@ -128,6 +129,44 @@ void FENode::Serialize(DumpStream& ar)
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Number of doubles needed to store the solution state.
+//! NOTE: The solution state must contain the same data as a shallow Serialize.
+size_t FENode::StateSize() const
+{
+	return 21 + m_Fr.size() + m_val_t.size() + m_val_p.size();
+}
+
+//-----------------------------------------------------------------------------
+//! Copy the solution state to a flat buffer.
+double* FENode::SaveState(double* pd) const
+{
+	const vec3d* v[7] = { &m_rt, &m_at, &m_rp, &m_vp, &m_ap, &m_dt, &m_dp };
+	for (int i = 0; i < 7; ++i, pd += 3)
+	{
+		pd[0] = v[i]->x; pd[1] = v[i]->y; pd[2] = v[i]->z;
+	}
+	if (m_Fr.empty() == false) { memcpy(pd, &m_Fr[0], m_Fr.size() * sizeof(double)); pd += m_Fr.size(); }
+	if (m_val_t.empty() == false) { memcpy(pd, &m_val_t[0], m_val_t.size() * sizeof(double)); pd += m_val_t.size(); }
+	if (m_val_p.empty() == false) { memcpy(pd, &m_val_p[0], m_val_p.size() * sizeof(double)); pd += m_val_p.size(); }
+	return pd;
+}
+
+//-----------------------------------------------------------------------------
+//! Copy the solution state from a flat buffer.
+const double* FENode::RestoreState(const double* pd)
+{
+	vec3d* v[7] = { &m_rt, &m_at, &m_rp, &m_vp, &m_ap, &m_dt, &m_dp };
+	for (int i = 0; i < 7; ++i, pd += 3)
+	{
+		v[i]->x = pd[0]; v[i]->y = pd[1]; v[i]->z = pd[2];
+	}
+	if (m_Fr.empty() == false) { memcpy(&m_Fr[0], pd, m_Fr.size() * sizeof(double)); pd += m_Fr.size(); }
+	if (m_val_t.empty() == false) { memcpy(&m_val_t[0], pd, m_val_t.size() * sizeof(double)); pd += m_val_t.size(); }
+	if (m_val_p.empty() == false) { memcpy(&m_val_p[0], pd, m_val_p.size() * sizeof(double)); pd += m_val_p.size(); }
+	return pd;
+}
+
 //-----------------------------------------------------------------------------
 //! Update nodal values, which copies the current values to the previous array
 void FENode::UpdateValues()
@@ -93,6 +93,16 @@ public:
 	// Serialize
 	void Serialize(DumpStream& ar);
 
+	//! Number of doubles needed to store the solution state of this node
+	//! (i.e. the data that is streamed by a shallow Serialize)
+	size_t StateSize() const;
+
+	//! Copy the solution state to a flat buffer. Returns the position after the stored data.
+	double* SaveState(double* pd) const;
+
+	//! Copy the solution state from a flat buffer. Returns the position after the read data.
+	const double* RestoreState(const double* pd);
+
 	//! Update nodal values, which copies the current values to the previous array
 	void UpdateValues();
 
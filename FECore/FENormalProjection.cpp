@@ -35,13 +35,15 @@ FENormalProjection::FENormalProjection(FESurface& s) : m_surf(s)
 {
 	m_tol = 0.0;
 	m_rad = 0.0;
+	m_bvh = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 void FENormalProjection::Init()
 {
-	m_OT.Attach(&m_surf);
-	m_OT.Init(m_tol);
+	// the surface's hierarchy is refit to the current configuration
+	m_surf.UpdateBVH();
+	m_bvh = &m_surf.GetBVH();
 }
 
 //-----------------------------------------------------------------------------
@@ -53,18 +55,17 @@ void FENormalProjection::Init()
 FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	vector<int> selist;
+	m_bvh->FindRayCandidates(r, n, m_rad, m_tol, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
-	for (it=selist.begin(); it!=selist.end(); ++it) {
+	for (size_t i=0; i<selist.size(); ++i) {
 		// get the surface element
-		int j = *it;
+		int j = selist[i];
 		// project the node on the element
 		FESurfaceElement* pe = &m_surf.Element(j);
 		if (pe->isActive())
@@ -101,18 +102,17 @@ FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	vector<int> selist;
+	m_bvh->FindRayCandidates(r, n, m_rad, m_tol, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
-	for (it=selist.begin(); it!=selist.end(); ++it) {
+	for (size_t i=0; i<selist.size(); ++i) {
 		// get the surface element
-		int j = *it;
+		int j = selist[i];
 		FESurfaceElement* pe = &m_surf.Element(j);
 		// project the node on the element
 		if (m_surf.Intersect(*pe, r, n, rsl, gl, m_tol)) {
@@ -144,18 +144,17 @@ FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, double rs[2], int* pei)
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	vector<int> selist;
+	m_bvh->FindRayCandidates(r, n, m_rad, m_tol, selist);
 
 	double g, gmax = -1e99, r2[2] = {rs[0], rs[1]};
 	int imin = -1;
 	FESurfaceElement* pme = 0;
 
 	// loop over all surface element
-	set<int>::iterator it;
-	for (it = selist.begin(); it != selist.end(); ++it)
+	for (size_t i = 0; i < selist.size(); ++i)
 	{
-		FESurfaceElement& el = m_surf.Element(*it);
+		FESurfaceElement& el = m_surf.Element(selist[i]);
 
 		// see if the ray intersects this element
 		if (m_surf.Intersect(el, r, n, r2, g, m_tol))
@@ -170,7 +169,7 @@ FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, d
 				pme = &el;
 //				gmin = g;
 				gmax = g;
-				imin = *it;
+				imin = selist[i];
 				rs[0] = r2[0];
 				rs[1] = r2[1];
 			}
@@ -216,3 +215,21 @@ vec3d FENormalProjection::Project2(const vec3d& x, const vec3d& N)
 	}
 	else return x;
 }
+
+//-----------------------------------------------------------------------------
+//! Projects a batch of rays (r[i], n[i]) onto the surface. This returns the same
+//! as calling Project(r[i], n[i], rs) for each ray, but evaluates them in parallel.
+void FENormalProjection::Project(const std::vector<vec3d>& r, const std::vector<vec3d>& n, std::vector<FESurfaceElement*>& pe, std::vector<vec2d>& rs)
+{
+	int N = (int)r.size();
+	assert(n.size() == r.size());
+	pe.resize(N);
+	rs.resize(N);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < N; ++i)
+	{
+		double q[2] = { 0, 0 };
+		pe[i] = Project(r[i], n[i], q);
+		rs[i] = vec2d(q[0], q[1]);
+	}
+}
@@ -28,7 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "FESurface.h"
-#include "FEOctree.h"
+#include "FESurfaceBVH.h"
 
 //-----------------------------------------------------------------------------
 //! This class calculates the normal projection on to a surface.
@@ -39,7 +39,7 @@ public:
 	//! constructor
 	FENormalProjection(FESurface& s);
 
-	// initialization
+	// initialization (must be called outside parallel regions)
 	void Init();
 
 	void SetTolerance(double tol) { m_tol = tol; }
@@ -54,11 +54,14 @@ public:
 	vec3d Project(const vec3d& r, const vec3d& N);
 	vec3d Project2(const vec3d& r, const vec3d& N);
 
+	//! batched version of Project (rays are projected in parallel)
+	void Project(const std::vector<vec3d>& r, const std::vector<vec3d>& n, std::vector<FESurfaceElement*>& pe, std::vector<vec2d>& rs);
+
 private:
 	double	m_tol;	//!< projection tolerance
 	double	m_rad;	//!< search radius
 
 private:
 	FESurface&	m_surf;	//!< the target surface
-	FEOctree	m_OT;	//!< used to optimize ray-surface intersections
+	FESurfaceBVH*	m_bvh;	//!< used to optimize ray-surface intersections
 };
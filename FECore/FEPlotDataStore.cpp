@@ -66,6 +66,7 @@ FEPlotDataStore::FEPlotDataStore()
 	m_splot_type = "febio";
     m_plot.clear();
     m_nplot_compression = 0;
+    m_bplot_async = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -73,6 +74,7 @@ FEPlotDataStore::FEPlotDataStore(const FEPlotDataStore& plt)
 {
     m_splot_type = plt.m_splot_type;
     m_nplot_compression = plt.m_nplot_compression;
+    m_bplot_async = plt.m_bplot_async;
     m_plot = plt.m_plot;
 }
 
@@ -81,6 +83,7 @@ void FEPlotDataStore::operator = (const FEPlotDataStore& plt)
 {
     m_splot_type = plt.m_splot_type;
     m_nplot_compression = plt.m_nplot_compression;
+    m_bplot_async = plt.m_bplot_async;
     m_plot = plt.m_plot;
 }
 
@@ -103,6 +106,18 @@ void FEPlotDataStore::SetPlotCompression(int n)
     m_nplot_compression = n;
 }
 
+//-----------------------------------------------------------------------------
+bool FEPlotDataStore::GetPlotAsyncWrite() const
+{
+    return m_bplot_async;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotAsyncWrite(bool b)
+{
+    m_bplot_async = b;
+}
+
 //-----------------------------------------------------------------------------
 void FEPlotDataStore::SetPlotFileType(const std::string& fileType)
 {
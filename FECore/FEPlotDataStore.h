@@ -62,6 +62,9 @@ public:
 	int GetPlotCompression() const;
 	void SetPlotCompression(int n);
 
+	bool GetPlotAsyncWrite() const;
+	void SetPlotAsyncWrite(bool b);
+
 	void SetPlotFileType(const std::string& fileType);
 	std::string GetPlotFileType();
 
@@ -74,4 +77,5 @@ private:
 	std::string					m_splot_type;
 	std::vector<FEPlotVariable>	m_plot;
 	int							m_nplot_compression;
+	bool						m_bplot_async;		//!< write plot file on background thread
 };
@@ -117,7 +117,13 @@ void FEMathExpression::operator = (const FEMathExpression& me)
 
 double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
 {
-	std::vector<double> var(4 + m_vars.size());
+	// most expressions only have a few variables, so we try to avoid allocating memory
+	const int nvar = 4 + (int)m_vars.size();
+	double tmp[16];
+	std::vector<double> buf;
+	double* var = tmp;
+	if (nvar > 16) { buf.resize(nvar); var = buf.data(); }
+
 	var[0] = pt.m_r0.x;
 	var[1] = pt.m_r0.y;
 	var[2] = pt.m_r0.z;
@@ -0,0 +1,152 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEGlobalMatrix.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Counts how often a scratch object had to allocate memory, i.e. when it was 
+// created or when it had to grow. In the steady state of the element loops this
+// count should not change. Note that this only covers the scratch objects. Other 
+// allocations in the loops are not counted (the assembly benchmark counts those).
+class FECORE_API FEScratchCounter
+{
+public:
+	// nr of allocations since the last reset
+	static size_t Allocations();
+
+	// reset the counter
+	static void Reset();
+
+	// register an allocation
+	static void Add();
+};
+
+//-----------------------------------------------------------------------------
+// The scratch_reset functions bring a recycled object back to its initial state 
+// without releasing its memory. The scratch_footprint functions return a value that
+// changes when the object allocates memory, which is used to count allocations.
+template <typename T> inline void scratch_reset(std::vector<T>& v) { v.clear(); }
+template <typename T> inline size_t scratch_footprint(const std::vector<T>& v) { return v.capacity(); }
+
+// A matrix keeps its values, since they are usually initialized with zero() anyway.
+inline void scratch_reset(matrix& m) {}
+
+// a matrix is reallocated when its dimensions change
+inline size_t scratch_footprint(const matrix& m) { return (size_t)m.rows() * 65536 + (size_t)m.columns(); }
+
+inline void scratch_reset(FEElementMatrix& ke)
+{
+	ke.SetNodes(std::vector<int>());
+	ke.RowIndices().clear();
+	ke.ColumnsIndices().clear();
+	ke.SetScatterMap(nullptr);
+}
+
+inline size_t scratch_footprint(const FEElementMatrix& ke)
+{
+	// the index vectors only reallocate when they grow
+	size_t h = scratch_footprint((const matrix&)ke);
+	h = h * 31 + ke.RowIndices().capacity();
+	h = h * 31 + ke.ColumnsIndices().capacity();
+	h = h * 31 + ke.Nodes().capacity();
+	return h;
+}
+
+//-----------------------------------------------------------------------------
+// Per-thread pool of scratch objects. The pool owns its objects and 
+// releases them when the thread ends. 
+template <class T> class FEScratchPool
+{
+public:
+	~FEScratchPool() { for (size_t i = 0; i < m_free.size(); ++i) delete m_free[i]; }
+
+	T* Acquire()
+	{
+		if (m_free.empty()) { FEScratchCounter::Add(); return new T; }
+		T* p = m_free.back();
+		m_free.pop_back();
+		return p;
+	}
+
+	void Release(T* p) { m_free.push_back(p); }
+
+	// the pool of the calling thread
+	static FEScratchPool<T>& ThreadPool()
+	{
+		static thread_local FEScratchPool<T> pool;
+		return pool;
+	}
+
+private:
+	std::vector<T*>	m_free;
+};
+
+//-----------------------------------------------------------------------------
+// A scratch object for the element loops (e.g. an element vector, an LM vector or an
+// element matrix). It takes an object from the pool of the calling thread and returns it
+// when it goes out of scope. Since the objects keep their memory, the scratch objects
+// stop allocating memory once each thread has processed the largest element.
+// Scratch objects can be nested, since each one takes its own object from the pool.
+// A scratch vector starts out empty and a scratch element matrix has no indices, but
+// the values of a scratch (element) matrix must be initialized before it is used.
+//
+// Example:
+//	FEScratch< std::vector<double> > pfe;
+//	std::vector<double>& fe = pfe;
+//	fe.assign(ndof, 0.0);
+template <class T> class FEScratch
+{
+public:
+	FEScratch() : m_pool(FEScratchPool<T>::ThreadPool())
+	{
+		m_p = m_pool.Acquire();
+		scratch_reset(*m_p);
+		m_footprint = scratch_footprint(*m_p);
+	}
+
+	~FEScratch()
+	{
+		if (scratch_footprint(*m_p) != m_footprint) FEScratchCounter::Add();
+		m_pool.Release(m_p);
+	}
+
+	T& operator * () { return *m_p; }
+	T* operator -> () { return m_p; }
+	operator T& () { return *m_p; }
+
+private:
+	FEScratch(const FEScratch& s) : m_pool(s.m_pool) {}
+	void operator = (const FEScratch&) {}
+
+private:
+	FEScratchPool<T>&	m_pool;
+	T*					m_p;
+	size_t				m_footprint;
+};
@@ -32,6 +32,7 @@ SOFTWARE.*/
 #include "tools.h"
 #include "log.h"
 #include "FEModel.h"
+#include "FEScratch.h"
 
 BEGIN_FECORE_CLASS(FESolidDomain, FEDomain)
 	ADD_PROPERTY(m_matAxis, "mat_axis", FEProperty::Optional);
@@ -49,6 +50,9 @@ FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m
 		m_dofSU.AddDof(pfem->GetDOFIndex("sy"));
 		m_dofSU.AddDof(pfem->GetDOFIndex("sz"));
 	}
+
+	m_refCache = REF_CACHE_NONE;
+	m_refValid = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -69,6 +73,9 @@ bool FESolidDomain::Create(int nsize, FE_Element_Spec espec)
 
 	m_elemSpec = espec;
 
+	// the elements changed, so the reference geometry has to be recomputed
+	m_refValid = false;
+
 	return true;
 }
 
@@ -100,6 +107,8 @@ void FESolidDomain::CopyFrom(FEMeshPartition* pd)
 	FESolidDomain* psd = dynamic_cast<FESolidDomain*>(pd);
     m_Elem = psd->m_Elem;
 	ForEachElement([=](FEElement& el) { el.SetMeshPartition(this); });
+	m_refCache = psd->m_refCache;
+	m_refValid = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -149,13 +158,107 @@ bool FESolidDomain::Init()
 		return false;
 	}
 
+	// the Jacobians are valid, so we can build the reference geometry cache
+	UpdateReferenceGeometryCache();
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void FESolidDomain::SetReferenceGeometryCache(int level)
+{
+	// always rebuild, since the reference configuration may have changed
+	m_refCache = level;
+	UpdateReferenceGeometryCache();
+}
+
+//-----------------------------------------------------------------------------
+// The reference geometry is evaluated from the current reference nodal coordinates, so this
+// also picks up nodes that were moved after Init (e.g. by contact interfaces). If a reference
+// Jacobian is not positive, the cache is not used and the error is reported where the geometry
+// is evaluated.
+void FESolidDomain::UpdateReferenceGeometryCache()
+{
+	// make sure the functions below evaluate the geometry
+	m_refValid = false;
+
+	if (m_refCache == REF_CACHE_NONE)
+	{
+		m_refPt.clear(); m_refPt.shrink_to_fit();
+		m_refGrad.clear(); m_refGrad.shrink_to_fit();
+		m_refJ0i.clear(); m_refJ0i.shrink_to_fit();
+		m_refDetJ0.clear(); m_refDetJ0.shrink_to_fit();
+		m_refGradN0.clear(); m_refGradN0.shrink_to_fit();
+		return;
+	}
+	const bool bgrad = (m_refCache == REF_CACHE_SHAPE_GRADIENTS);
+
+	// figure out the offsets
+	const int NE = Elements();
+	m_refPt.resize(NE + 1);
+	m_refGrad.resize(NE + 1);
+	m_refPt[0] = m_refGrad[0] = 0;
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = m_Elem[i];
+		m_refPt[i + 1] = m_refPt[i] + el.GaussPoints();
+		m_refGrad[i + 1] = m_refGrad[i] + (bgrad ? el.GaussPoints()*el.Nodes() : 0);
+	}
+	m_refJ0i.resize(m_refPt[NE]);
+	m_refDetJ0.resize(m_refPt[NE]);
+	m_refGradN0.resize(m_refGrad[NE]);
+
+	// evaluate the reference geometry
+	int nerr = 0;
+	#pragma omp parallel for reduction(+:nerr)
+	for (int i = 0; i < NE; ++i)
+	{
+		FESolidElement& el = m_Elem[i];
+		const int nint = el.GaussPoints();
+		const int neln = el.Nodes();
+		for (int n = 0; n < nint; ++n)
+		{
+			double Ji[3][3];
+			double detJ = 0.0;
+			try {
+				detJ = invjac0(el, Ji, n);
+			}
+			catch (NegativeJacobian)
+			{
+				nerr++;
+				break;
+			}
+
+			mat3d& J = m_refJ0i[m_refPt[i] + n];
+			J = mat3d(Ji);
+			m_refDetJ0[m_refPt[i] + n] = detJ;
+
+			if (bgrad)
+			{
+				double* Gr = el.Gr(n);
+				double* Gs = el.Gs(n);
+				double* Gt = el.Gt(n);
+				vec3d* G = &m_refGradN0[m_refGrad[i] + n*neln];
+				for (int j = 0; j < neln; ++j)
+				{
+					G[j].x = J(0, 0) * Gr[j] + J(1, 0) * Gs[j] + J(2, 0) * Gt[j];
+					G[j].y = J(0, 1) * Gr[j] + J(1, 1) * Gs[j] + J(2, 1) * Gt[j];
+					G[j].z = J(0, 2) * Gr[j] + J(1, 2) * Gs[j] + J(2, 2) * Gt[j];
+				}
+			}
+		}
+	}
+
+	m_refValid = (nerr == 0);
+}
+
 //-----------------------------------------------------------------------------
 // Reset data
 void FESolidDomain::Reset()
 {
+	// the reference geometry is re-evaluated below
+	m_refValid = false;
+
 	// re-evaluate the material points initial position and jacobian
 	ForEachSolidElement([=](FESolidElement& el) {
 
@@ -190,6 +293,8 @@ void FESolidDomain::Reset()
 	ForEachMaterialPoint([](FEMaterialPoint& mp) {
 		mp.Init();
 	});
+
+	UpdateReferenceGeometryCache();
 }
 
 //-----------------------------------------------------------------------------
@@ -1074,6 +1179,16 @@ double FESolidDomain::defgradp(FESolidElement &el, mat3d &F, int n)
 //! The return value is the determinant of the Jacobian (not the inverse!)
 double FESolidDomain::invjac0(const FESolidElement& el, double Ji[3][3], int n)
 {
+	// see if we can use the cached values
+	if (UseReferenceCache(el))
+	{
+		const int k = m_refPt[el.GetLocalID()] + n;
+		const mat3d& J0i = m_refJ0i[k];
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j) Ji[i][j] = J0i(i, j);
+		return m_refDetJ0[k];
+	}
+
     // nodal coordinates
     vec3d r0[FEElement::MAX_NODES];
 	GetReferenceNodalCoordinates(el, r0);
@@ -1895,6 +2010,9 @@ double FESolidDomain::detJt(FESolidElement &el, int n, const double alpha)
 //! Calculate jacobian with respect to reference frame
 double FESolidDomain::detJ0(FESolidElement &el, int n)
 {
+	// see if we can use the cached value
+	if (UseReferenceCache(el)) return m_refDetJ0[m_refPt[el.GetLocalID()] + n];
+
     // nodal coordinates
     vec3d r0[FEElement::MAX_NODES];
 	GetReferenceNodalCoordinates(el, r0);
@@ -2383,6 +2501,16 @@ double FESolidDomain::ShapeGradient(FESolidElement& el, int n, vec3d* GradH, con
 //-----------------------------------------------------------------------------
 double FESolidDomain::ShapeGradient0(FESolidElement& el, int n, vec3d* GradH)
 {
+	// see if we can use the cached values
+	if (UseReferenceCache(el) && (m_refCache == REF_CACHE_SHAPE_GRADIENTS))
+	{
+		const int iel = el.GetLocalID();
+		const int ne = el.Nodes();
+		const vec3d* G = &m_refGradN0[m_refGrad[iel] + n*ne];
+		for (int i = 0; i < ne; ++i) GradH[i] = G[i];
+		return m_refDetJ0[m_refPt[iel] + n];
+	}
+
     // calculate jacobian
     double Ji[3][3];
     double detJ0 = invjac0(el, Ji, n);
@@ -2571,67 +2699,66 @@ void FESolidDomain::LoadVector(
 	// degrees of freedom per node
 	int dofPerNode = dofList.Size();
 
-	// loop over all the elements
-	int NE = Elements();
-	#pragma omp parallel for 
-	for (int i = 0; i<NE; ++i)
-	{
+	// loop over all the active elements
+	AssembleElements(R, [&](int i) {
+
 		// get the next element
 		FESolidElement& el = Element(i);
 		int neln = el.Nodes();
 
-		// only consider active elements
-		if (el.isActive()) 
-		{
-			std::vector<double> val(dofPerNode, 0.0);
+		FEScratch< vector<double> > pval;
+		vector<double>& val = pval;
+		val.assign(dofPerNode, 0.0);
 
-			// total size of the element vector
-			int ndof = dofPerNode * el.Nodes();
+		// total size of the element vector
+		int ndof = dofPerNode * el.Nodes();
 
-			// setup the element vector
-			vector<double> fe;
-			fe.assign(ndof, 0);
+		// setup the element vector
+		FEScratch< vector<double> > pfe;
+		vector<double>& fe = pfe;
+		fe.assign(ndof, 0);
 
-			// loop over integration points
-			double* w = el.GaussWeights();
-			int nint = el.GaussPoints();
-			for (int n = 0; n<nint; ++n)
-			{
-				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		// loop over integration points
+		double* w = el.GaussWeights();
+		int nint = el.GaussPoints();
+		for (int n = 0; n<nint; ++n)
+		{
+			FEMaterialPoint& mp = *el.GetMaterialPoint(n);
 
-				mp.m_Jt = detJt(el, n);
-				mp.m_shape = el.H(n);
+			mp.m_Jt = detJt(el, n);
+			mp.m_shape = el.H(n);
 
-				// loop over all nodes
-				for (int j = 0; j<neln; ++j)
-				{
-					// get the value of the integrand for this node
-					f(mp, j, val);
+			// loop over all nodes
+			for (int j = 0; j<neln; ++j)
+			{
+				// get the value of the integrand for this node
+				f(mp, j, val);
 
-					// add it all up
-					for (int k=0; k<dofPerNode; ++k)
-					{
-						fe[dofPerNode*j + k] += val[k] * w[n];
-					}
+				// add it all up
+				for (int k=0; k<dofPerNode; ++k)
+				{
+					fe[dofPerNode*j + k] += val[k] * w[n];
 				}
 			}
+		}
 
-			// get the element's LM vector
-			vector<int> lm(ndof, -1);
-			for (int j = 0; j < neln; ++j)
+		// get the element's LM vector
+		FEScratch< vector<int> > plm;
+		vector<int>& lm = plm;
+		lm.assign(ndof, -1);
+		for (int j = 0; j < neln; ++j)
+		{
+			FENode& node = mesh.Node(el.m_node[j]);
+			vector<int>& ID = node.m_ID;
+			for (int k = 0; k < dofPerNode; ++k)
 			{
-				FENode& node = mesh.Node(el.m_node[j]);
-				vector<int>& ID = node.m_ID;
-				for (int k = 0; k < dofPerNode; ++k)
-				{
-					lm[dofPerNode*j + k] = ID[dofList[k]];
-				}
+				lm[dofPerNode*j + k] = ID[dofList[k]];
 			}
-
-			// Assemble into global vector
-			R.Assemble(el.m_node, lm, fe);
 		}
-	}
+
+		// Assemble into global vector
+		R.Assemble(el.m_node, lm, fe);
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -2639,7 +2766,8 @@ void FESolidDomain::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a
 {
 #pragma omp parallel shared(f)
 	{
-	FEElementMatrix ke;
+	FEScratch<FEElementMatrix> pke;
+	FEElementMatrix& ke = pke;
 
 	int dofPerNode_a = dofList_a.Size();
 	int dofPerNode_b = dofList_b.Size();
@@ -2647,7 +2775,9 @@ void FESolidDomain::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a
 	FEMesh& mesh = *GetMesh();
 	vec3d rt[FEElement::MAX_NODES];
 
-	matrix kab(dofPerNode_a, dofPerNode_b);
+	FEScratch<matrix> pkab;
+	matrix& kab = pkab;
+	kab.resize(dofPerNode_a, dofPerNode_b);
 
 	int NE = Elements();
 	#pragma omp for nowait
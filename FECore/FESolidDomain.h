@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEDofList.h"
 #include "FELinearSystem.h"
 #include "FESolidElement.h"
+#include "FEAlignedAllocator.h"
 
 //-----------------------------------------------------------------------------
 // This typedef defines a surface integrand. 
@@ -261,6 +262,27 @@ public:
 	//! get the nodal coordinates at previous state
 	void GetPreviousNodalCoordinates(const FESolidElement& el, vec3d* rp);
 
+public:
+	//! levels of the reference geometry cache
+	enum RefGeometryCache {
+		REF_CACHE_NONE,				//!< recompute the reference geometry when needed
+		REF_CACHE_JACOBIANS,		//!< store the reference Jacobians at the integration points
+		REF_CACHE_SHAPE_GRADIENTS	//!< also store the reference shape function gradients
+	};
+
+	//! Set the level of the reference geometry cache and (re)build it. The cache trades memory for
+	//! the time of recomputing the reference Jacobians (invjac0, detJ0) and shape gradients (ShapeGradient0).
+	//! Since model components (e.g. contact interfaces) may move the reference nodes when they are
+	//! activated, this should be called after all model components are activated.
+	void SetReferenceGeometryCache(int level);
+
+	//! get the level of the reference geometry cache
+	int ReferenceGeometryCache() const { return m_refCache; }
+
+	//! Rebuild the reference geometry cache. This must be called when the reference
+	//! configuration changes. (Init and Reset call this.)
+	void UpdateReferenceGeometryCache();
+
 public:
 	//! loop over elements
 	void ForEachSolidElement(std::function<void(FESolidElement& el)> f);
@@ -291,5 +313,20 @@ protected:
 	FEDofList	m_dofU;
 	FEDofList	m_dofSU;
 
+private:
+	// see if the cached reference geometry can be used for this element
+	bool UseReferenceCache(const FESolidElement& el) const { return m_refValid && (el.GetMeshPartition() == this); }
+
+private:
+	// The reference geometry cache. The values of all integration points are stored
+	// contiguously, element by element, in cache-line aligned arrays.
+	int						m_refCache;		//!< cache level (see RefGeometryCache)
+	bool					m_refValid;		//!< cache is up to date
+	std::vector<int>		m_refPt;		//!< index of the first integration point of each element
+	std::vector<int>		m_refGrad;		//!< index of the first shape gradient of each element
+	FEAlignedVector<mat3d>	m_refJ0i;		//!< inverse reference Jacobians
+	FEAlignedVector<double>	m_refDetJ0;		//!< reference Jacobian determinants
+	FEAlignedVector<vec3d>	m_refGradN0;	//!< reference shape gradients (for each integration point, all nodes)
+
 	DECLARE_FECORE_CLASS();
 };
@@ -0,0 +1,258 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FESolutionSnapshot.h"
+#include "FEModel.h"
+#include "FEMesh.h"
+#include "FEDomain.h"
+#include "FESurfacePairConstraint.h"
+#include "FENLConstraint.h"
+#include "FEAnalysis.h"
+#include "DumpStream.h"
+#include "Callback.h"
+#include "Timer.h"
+#include <string.h>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+// Max. number of elements whose material points are stored in one block
+#define SNAPSHOT_BLOCK_SIZE	1024
+
+//-----------------------------------------------------------------------------
+// A (shallow) dump stream that writes to a flat buffer. Contrary to the 
+// DumpMemStream, the buffer grows in small steps and is retained when 
+// the stream is cleared.
+class FESnapshotStream : public DumpStream
+{
+public:
+	FESnapshotStream(FEModel& fem) : DumpStream(fem) { m_pos = 0; Open(true, true); }
+
+	size_t write(const void* pd, size_t size, size_t count) override
+	{
+		size_t nsize = size*count;
+		const char* pc = (const char*)pd;
+		m_buf.insert(m_buf.end(), pc, pc + nsize);
+		return nsize;
+	}
+
+	size_t read(void* pd, size_t size, size_t count) override
+	{
+		size_t nsize = size*count;
+		if (nsize == 0) return 0;
+		assert(m_pos + nsize <= m_buf.size());
+		memcpy(pd, &m_buf[0] + m_pos, nsize);
+		m_pos += nsize;
+		return nsize;
+	}
+
+	bool EndOfStream() const override { return (m_pos >= m_buf.size()); }
+
+	void clear() override
+	{
+		m_buf.clear();
+		m_pos = 0;
+		Open(true, true);
+	}
+
+	void rewind()
+	{
+		m_pos = 0;
+		Open(false, true);
+	}
+
+	size_t size() const { return m_buf.size(); }
+
+private:
+	std::vector<char>	m_buf;
+	size_t				m_pos;
+};
+
+//-----------------------------------------------------------------------------
+FESolutionSnapshot::FESolutionSnapshot(FEModel* fem) : m_fem(fem)
+{
+	m_bvalid = false;
+	m_model = new FESnapshotStream(*fem);
+}
+
+//-----------------------------------------------------------------------------
+FESolutionSnapshot::~FESolutionSnapshot()
+{
+	ClearBlocks();
+	delete m_model;
+}
+
+//-----------------------------------------------------------------------------
+void FESolutionSnapshot::ClearBlocks()
+{
+	for (size_t i = 0; i < m_block.size(); ++i) delete m_block[i].ar;
+	m_block.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FESolutionSnapshot::UpdateBlocks()
+{
+	FEMesh& mesh = m_fem->GetMesh();
+
+	// figure out the block layout for the current mesh
+	std::vector<Block> blocks;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		int NE = dom.Elements();
+		blocks.push_back({ i, -1, -1, nullptr });
+		for (int n0 = 0; n0 < NE; n0 += SNAPSHOT_BLOCK_SIZE)
+		{
+			int n1 = n0 + SNAPSHOT_BLOCK_SIZE;
+			if (n1 > NE) n1 = NE;
+			blocks.push_back({ i, n0, n1, nullptr });
+		}
+	}
+
+	// if nothing changed, we can keep the buffers
+	bool bsame = (blocks.size() == m_block.size());
+	for (size_t i = 0; bsame && (i < blocks.size()); ++i)
+	{
+		const Block& a = blocks[i];
+		const Block& b = m_block[i];
+		bsame = ((a.dom == b.dom) && (a.n0 == b.n0) && (a.n1 == b.n1));
+	}
+	if (bsame) return;
+
+	ClearBlocks();
+	m_block = blocks;
+	for (size_t i = 0; i < m_block.size(); ++i) m_block[i].ar = new FESnapshotStream(*m_fem);
+}
+
+//-----------------------------------------------------------------------------
+void FESolutionSnapshot::Save()
+{
+	TRACK_TIME(TimerID::Timer_Serialize);
+
+	FEModel& fem = *m_fem;
+	FEMesh& mesh = fem.GetMesh();
+
+	// time info
+	m_time = fem.GetTime();
+
+	// nodal values
+	int NN = mesh.Nodes();
+	m_nodePos.resize(NN + 1);
+	m_nodePos[0] = 0;
+	for (int i = 0; i < NN; ++i) m_nodePos[i + 1] = m_nodePos[i] + mesh.Node(i).StateSize();
+	m_nodeData.resize(m_nodePos[NN]);
+	if (NN > 0)
+	{
+		double* pd = &m_nodeData[0];
+#pragma omp parallel for
+		for (int i = 0; i < NN; ++i) mesh.Node(i).SaveState(pd + m_nodePos[i]);
+	}
+
+	// domain data
+	UpdateBlocks();
+	int NB = (int)m_block.size();
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < NB; ++i)
+	{
+		Block& b = m_block[i];
+		FEDomain& dom = mesh.Domain(b.dom);
+		FESnapshotStream& ar = *b.ar;
+		ar.clear();
+		if (b.n0 < 0) dom.SerializeState(ar);
+		else dom.SerializeMaterialPoints(ar, b.n0, b.n1);
+	}
+
+	// geometry data that is not in the mesh (e.g. rigid bodies), contact, nonlinear constraints, and step data
+	// (this is done in the same order as in the shallow serialization of the model)
+	DumpStream& ar = *m_model;
+	m_model->clear();
+	fem.SerializeGeometryState(ar);
+	for (int i = 0; i < fem.SurfacePairConstraints(); ++i) fem.SurfacePairConstraint(i)->Serialize(ar);
+	for (int i = 0; i < fem.NonlinearConstraints(); ++i) fem.NonlinearConstraint(i)->Serialize(ar);
+	for (int i = 0; i < fem.Steps(); ++i) fem.GetStep(i)->Serialize(ar);
+
+	m_bvalid = true;
+
+	fem.DoCallback(CB_SERIALIZE_SAVE);
+}
+
+//-----------------------------------------------------------------------------
+void FESolutionSnapshot::Restore()
+{
+	assert(m_bvalid);
+	if (m_bvalid == false) return;
+
+	TRACK_TIME(TimerID::Timer_Serialize);
+
+	FEModel& fem = *m_fem;
+	FEMesh& mesh = fem.GetMesh();
+
+	// time info
+	fem.GetTime() = m_time;
+
+	// nodal values
+	int NN = mesh.Nodes();
+	assert(m_nodePos.size() == NN + 1);
+	if (NN > 0)
+	{
+		const double* pd = &m_nodeData[0];
+#pragma omp parallel for
+		for (int i = 0; i < NN; ++i) mesh.Node(i).RestoreState(pd + m_nodePos[i]);
+	}
+
+	// domain data
+	int NB = (int)m_block.size();
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < NB; ++i)
+	{
+		Block& b = m_block[i];
+		FEDomain& dom = mesh.Domain(b.dom);
+		FESnapshotStream& ar = *b.ar;
+		ar.rewind();
+		if (b.n0 < 0) dom.SerializeState(ar);
+		else dom.SerializeMaterialPoints(ar, b.n0, b.n1);
+	}
+
+	// geometry data that is not in the mesh, contact, nonlinear constraints, and step data
+	DumpStream& ar = *m_model;
+	m_model->rewind();
+	fem.SerializeGeometryState(ar);
+	for (int i = 0; i < fem.SurfacePairConstraints(); ++i) fem.SurfacePairConstraint(i)->Serialize(ar);
+	for (int i = 0; i < fem.NonlinearConstraints(); ++i) fem.NonlinearConstraint(i)->Serialize(ar);
+	for (int i = 0; i < fem.Steps(); ++i) fem.GetStep(i)->Serialize(ar);
+
+	fem.DoCallback(CB_SERIALIZE_LOAD);
+}
+
+//-----------------------------------------------------------------------------
+size_t FESolutionSnapshot::Size() const
+{
+	size_t n = m_nodeData.size() * sizeof(double) + m_model->size();
+	for (size_t i = 0; i < m_block.size(); ++i) n += m_block[i].ar->size();
+	return n;
+}
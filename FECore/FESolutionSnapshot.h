@@ -0,0 +1,94 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FETimeInfo.h"
+#include <vector>
+
+class FEModel;
+class FESnapshotStream;
+
+//-----------------------------------------------------------------------------
+//! A snapshot of the solution state of a model, which is used to roll back 
+//! a time step that failed to converge.
+//!
+//! It stores the same data as a shallow serialization of the model, but only 
+//! the mutable solution state is copied: the nodal values go into one flat 
+//! buffer and the material point data is streamed in element blocks that are 
+//! processed in parallel. All buffers are kept between snapshots, so that after
+//! the first time step no memory needs to be allocated.
+class FECORE_API FESolutionSnapshot
+{
+	// a block of elements of a domain whose material points are stored together
+	struct Block
+	{
+		int		dom;	//!< domain index
+		int		n0, n1;	//!< element range (n0 < 0 for the domain data)
+		FESnapshotStream*	ar;	//!< the data
+	};
+
+public:
+	FESolutionSnapshot(FEModel* fem);
+	~FESolutionSnapshot();
+
+	//! store the current solution state
+	void Save();
+
+	//! restore the state of the last call to Save
+	void Restore();
+
+	//! see if a state was stored
+	bool IsValid() const { return m_bvalid; }
+
+	//! size of the stored data (in bytes)
+	size_t Size() const;
+
+	//! get the model
+	FEModel* GetFEModel() { return m_fem; }
+
+private:
+	//! setup the element blocks (only done when the mesh changed)
+	void UpdateBlocks();
+
+	//! release all element blocks
+	void ClearBlocks();
+
+private:
+	FESolutionSnapshot(const FESolutionSnapshot&) {}
+	void operator = (const FESolutionSnapshot&) {}
+
+private:
+	FEModel*	m_fem;
+	bool		m_bvalid;
+
+	FETimeInfo				m_time;		//!< time info
+	std::vector<double>		m_nodeData;	//!< nodal values
+	std::vector<size_t>		m_nodePos;	//!< offsets of each node into m_nodeData
+	std::vector<Block>		m_block;	//!< domain data
+	FESnapshotStream*		m_model;	//!< non-mesh geometry (e.g. rigid bodies), contact, nonlinear constraints, and step data
+};
@@ -35,6 +35,7 @@ SOFTWARE.*/
 #include "matrix.h"
 #include <FECore/log.h>
 #include "FEModelParam.h"
+#include "FESurfaceBVH.h"
 #include "FEMesh.h"
 
 //-----------------------------------------------------------------------------
@@ -44,12 +45,27 @@ FESurface::FESurface(FEModel* fem) : FEMeshPartition(FE_DOMAIN_SURFACE, fem)
 	m_bitfc = false;
 	m_alpha = 1;
 	m_bshellb = false;
+	m_bvh = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 FESurface::~FESurface()
 {
+	delete m_bvh;
+}
 
+//-----------------------------------------------------------------------------
+void FESurface::UpdateBVH()
+{
+	if (m_bvh == nullptr) m_bvh = new FESurfaceBVH(this);
+	m_bvh->Update();
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH& FESurface::GetBVH()
+{
+	assert(m_bvh);
+	return *m_bvh;
 }
 
 //-----------------------------------------------------------------------------
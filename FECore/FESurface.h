@@ -38,6 +38,7 @@ SOFTWARE.*/
 
 //-----------------------------------------------------------------------------
 class FEMesh;
+class FESurfaceBVH;
 class FENodeSet;
 class FEFacetSet;
 class FELinearSystem;
@@ -278,6 +279,14 @@ public:
 	//! Get the facet set that created this surface
 	FEFacetSet* GetFacetSet() { return m_surf; }
 
+	//! Build the bounding volume hierarchy of this surface, or refit it to the current nodal positions.
+	//! This is not thread safe and must be called outside parallel regions, before the hierarchy is used.
+	void UpdateBVH();
+
+	//! Get the bounding volume hierarchy of this surface (UpdateBVH must be called first).
+	//! This does not modify the hierarchy, so it can be used inside parallel loops.
+	FESurfaceBVH& GetBVH();
+
 public:
 	// Get nodal reference coordinates 
 	void GetReferenceNodalCoordinates(FESurfaceElement& el, vec3d* r0);
@@ -325,6 +334,7 @@ protected:
     bool                        m_bitfc;    //!< interface status
     double                      m_alpha;    //!< intermediate time fraction
 	bool						m_bshellb;	//!< true if this surface is the bottom of a shell domain
+	FESurfaceBVH*				m_bvh;		//!< search structure for projections (created on demand)
 };
 
 // Calculates the volume inside a (closed) surface. 
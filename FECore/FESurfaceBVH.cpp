@@ -0,0 +1,411 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FESurfaceBVH.h"
+#include "FESurface.h"
+#include "FEMesh.h"
+#include <algorithm>
+using namespace std;
+
+// max number of facets in a leaf
+#define BVH_LEAF_SIZE 4
+
+// max depth of the traversal stack. The tree is split at the median, so its depth is log2(N).
+#define BVH_STACK_SIZE 64
+
+//-----------------------------------------------------------------------------
+// surface area of a box
+static double box_area(const vec3d& a, const vec3d& b)
+{
+	vec3d d = b - a;
+	return 2.0*(d.x*d.y + d.y*d.z + d.z*d.x);
+}
+
+//-----------------------------------------------------------------------------
+// squared distance of a point to a box
+static double box_dist2(const vec3d& a, const vec3d& b, const vec3d& p)
+{
+	double dx = (p.x < a.x ? a.x - p.x : (p.x > b.x ? p.x - b.x : 0.0));
+	double dy = (p.y < a.y ? a.y - p.y : (p.y > b.y ? p.y - b.y : 0.0));
+	double dz = (p.z < a.z ? a.z - p.z : (p.z > b.z ? p.z - b.z : 0.0));
+	return dx*dx + dy*dy + dz*dz;
+}
+
+//-----------------------------------------------------------------------------
+// Check if the line through p with direction n intersects the box [a,b].
+// Note that, like the octree, this tests the entire line and not just the ray.
+static bool line_intersects_box(const vec3d& a, const vec3d& b, const vec3d& p, const vec3d& n)
+{
+	double tmin = -1e99, tmax = 1e99;
+	const double pa[3] = { p.x, p.y, p.z }, na[3] = { n.x, n.y, n.z };
+	const double ba[3] = { a.x, a.y, a.z }, bb[3] = { b.x, b.y, b.z };
+	for (int i = 0; i < 3; ++i)
+	{
+		if (na[i] == 0.0)
+		{
+			if ((pa[i] < ba[i]) || (pa[i] > bb[i])) return false;
+		}
+		else
+		{
+			double t1 = (ba[i] - pa[i]) / na[i];
+			double t2 = (bb[i] - pa[i]) / na[i];
+			if (t1 > t2) { double t = t1; t1 = t2; t2 = t; }
+			if (t1 > tmin) tmin = t1;
+			if (t2 < tmax) tmax = t2;
+			if (tmin > tmax) return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::FESurfaceBVH(FESurface* ps)
+{
+	m_ps = ps;
+	m_area0 = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Build()
+{
+	assert(m_ps);
+	m_node.clear();
+	m_facet.clear();
+
+	int NF = m_ps->Elements();
+	if (NF == 0) return;
+
+	// get the facet boxes
+	m_fmin.resize(NF);
+	m_fmax.resize(NF);
+	m_facet.resize(NF);
+	for (int i = 0; i < NF; ++i) m_facet[i] = i;
+	Refit();
+
+	// the facets are sorted by the center of their boxes
+	vector<vec3d> centroid(NF);
+	for (int i = 0; i < NF; ++i) centroid[i] = (m_fmin[i] + m_fmax[i])*0.5;
+
+	// build the tree
+	m_node.reserve(2 * (NF / BVH_LEAF_SIZE + 1));
+	m_node.push_back(NODE());
+	BuildNode(0, 0, NF, centroid);
+
+	m_area0 = box_area(m_node[0].bmin, m_node[0].bmax);
+}
+
+//-----------------------------------------------------------------------------
+// Builds the subtree of node inode, which holds the facets [first, first+count).
+void FESurfaceBVH::BuildNode(int inode, int first, int count, vector<vec3d>& centroid)
+{
+	// find the node box and the bounding box of the centroids
+	vec3d bmin = m_fmin[m_facet[first]], bmax = m_fmax[m_facet[first]];
+	vec3d cmin = centroid[m_facet[first]], cmax = cmin;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		int n = m_facet[i];
+		const vec3d& a = m_fmin[n];
+		const vec3d& b = m_fmax[n];
+		const vec3d& c = centroid[n];
+		if (a.x < bmin.x) bmin.x = a.x;
+		if (b.x > bmax.x) bmax.x = b.x;
+		if (a.y < bmin.y) bmin.y = a.y;
+		if (b.y > bmax.y) bmax.y = b.y;
+		if (a.z < bmin.z) bmin.z = a.z;
+		if (b.z > bmax.z) bmax.z = b.z;
+		if (c.x < cmin.x) cmin.x = c.x;
+		if (c.x > cmax.x) cmax.x = c.x;
+		if (c.y < cmin.y) cmin.y = c.y;
+		if (c.y > cmax.y) cmax.y = c.y;
+		if (c.z < cmin.z) cmin.z = c.z;
+		if (c.z > cmax.z) cmax.z = c.z;
+	}
+
+	NODE& node = m_node[inode];
+	node.bmin = bmin;
+	node.bmax = bmax;
+	node.child = -1;
+	node.first = first;
+	node.count = count;
+
+	// split along the longest axis of the centroid box
+	vec3d d = cmax - cmin;
+	int axis = 0;
+	if ((d.y >= d.x) && (d.y >= d.z)) axis = 1;
+	else if ((d.z >= d.x) && (d.z >= d.y)) axis = 2;
+	double ext = (axis == 0 ? d.x : (axis == 1 ? d.y : d.z));
+
+	// see if this should be a leaf
+	if ((count <= BVH_LEAF_SIZE) || (ext <= 0.0)) return;
+
+	// split at the median
+	int nl = count / 2;
+	vector<int>::iterator it0 = m_facet.begin() + first;
+	switch (axis)
+	{
+	case 0: nth_element(it0, it0 + nl, it0 + count, [&](int a, int b) { return centroid[a].x < centroid[b].x; }); break;
+	case 1: nth_element(it0, it0 + nl, it0 + count, [&](int a, int b) { return centroid[a].y < centroid[b].y; }); break;
+	case 2: nth_element(it0, it0 + nl, it0 + count, [&](int a, int b) { return centroid[a].z < centroid[b].z; }); break;
+	}
+
+	// create the two children. They are stored next to each other and always after their parent.
+	// (note that we can't use the node reference after this point)
+	int child = (int)m_node.size();
+	m_node[inode].child = child;
+	m_node[inode].count = 0;
+	m_node.push_back(NODE());
+	m_node.push_back(NODE());
+
+	BuildNode(child    , first     , nl        , centroid);
+	BuildNode(child + 1, first + nl, count - nl, centroid);
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Refit()
+{
+	assert(m_ps);
+	FEMesh& mesh = *m_ps->GetMesh();
+
+	// update the facet boxes
+	int NF = (int)m_fmin.size();
+#pragma omp parallel for
+	for (int i = 0; i < NF; ++i)
+	{
+		FESurfaceElement& el = m_ps->Element(i);
+		vec3d a = mesh.Node(el.m_node[0]).m_rt, b = a;
+		int ne = el.Nodes();
+		for (int j = 1; j < ne; ++j)
+		{
+			const vec3d& r = mesh.Node(el.m_node[j]).m_rt;
+			if (r.x < a.x) a.x = r.x;
+			if (r.x > b.x) b.x = r.x;
+			if (r.y < a.y) a.y = r.y;
+			if (r.y > b.y) b.y = r.y;
+			if (r.z < a.z) a.z = r.z;
+			if (r.z > b.z) b.z = r.z;
+		}
+		m_fmin[i] = a;
+		m_fmax[i] = b;
+	}
+
+	// update the node boxes bottom-up. Since children are always stored
+	// after their parent, a reverse loop visits all children first.
+	for (int i = (int)m_node.size() - 1; i >= 0; --i)
+	{
+		NODE& node = m_node[i];
+		vec3d a, b;
+		if (node.child < 0)
+		{
+			a = m_fmin[m_facet[node.first]];
+			b = m_fmax[m_facet[node.first]];
+			for (int j = 1; j < node.count; ++j)
+			{
+				const vec3d& fa = m_fmin[m_facet[node.first + j]];
+				const vec3d& fb = m_fmax[m_facet[node.first + j]];
+				if (fa.x < a.x) a.x = fa.x;
+				if (fb.x > b.x) b.x = fb.x;
+				if (fa.y < a.y) a.y = fa.y;
+				if (fb.y > b.y) b.y = fb.y;
+				if (fa.z < a.z) a.z = fa.z;
+				if (fb.z > b.z) b.z = fb.z;
+			}
+		}
+		else
+		{
+			const NODE& c0 = m_node[node.child];
+			const NODE& c1 = m_node[node.child + 1];
+			a = c0.bmin; b = c0.bmax;
+			if (c1.bmin.x < a.x) a.x = c1.bmin.x;
+			if (c1.bmax.x > b.x) b.x = c1.bmax.x;
+			if (c1.bmin.y < a.y) a.y = c1.bmin.y;
+			if (c1.bmax.y > b.y) b.y = c1.bmax.y;
+			if (c1.bmin.z < a.z) a.z = c1.bmin.z;
+			if (c1.bmax.z > b.z) b.z = c1.bmax.z;
+		}
+		node.bmin = a;
+		node.bmax = b;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Update()
+{
+	assert(m_ps);
+
+	// rebuild if the surface changed
+	if ((IsValid() == false) || ((int)m_facet.size() != m_ps->Elements()))
+	{
+		Build();
+		return;
+	}
+
+	Refit();
+
+	// A refit keeps the tree topology, so large deformations will degrade the
+	// quality of the tree. When the root box has grown too much, we rebuild.
+	double area = box_area(m_node[0].bmin, m_node[0].bmax);
+	if (area > 4.0*m_area0) Build();
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindRayCandidates(const vec3d& p, const vec3d& n, double srad, double tol, vector<int>& sel) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	int stack[BVH_STACK_SIZE];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const NODE& node = m_node[stack[--ns]];
+
+		// Inflate the box by the projection tolerance, relative to the size of the box.
+		// Note that this must be the same in all directions, since the box of a flat facet
+		// has no thickness along its normal.
+		double h = (node.bmax - node.bmin).norm()*tol;
+		vec3d a = node.bmin - vec3d(h, h, h);
+		vec3d b = node.bmax + vec3d(h, h, h);
+
+		// check if the box is within the search radius of p
+		if (srad > 0.0)
+		{
+			if ((p.x < a.x - srad) || (p.x > b.x + srad)) continue;
+			if ((p.y < a.y - srad) || (p.y > b.y + srad)) continue;
+			if ((p.z < a.z - srad) || (p.z > b.z + srad)) continue;
+		}
+
+		if (line_intersects_box(a, b, p, n) == false) continue;
+
+		if (node.child < 0)
+		{
+			for (int i = 0; i < node.count; ++i) sel.push_back(m_facet[node.first + i]);
+		}
+		else
+		{
+			stack[ns++] = node.child;
+			stack[ns++] = node.child + 1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindCandidates(const vec3d& p, double d, vector<int>& sel) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	double d2 = d*d;
+	int stack[BVH_STACK_SIZE];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const NODE& node = m_node[stack[--ns]];
+		if (box_dist2(node.bmin, node.bmax, p) > d2) continue;
+
+		if (node.child < 0)
+		{
+			for (int i = 0; i < node.count; ++i) sel.push_back(m_facet[node.first + i]);
+		}
+		else
+		{
+			stack[ns++] = node.child;
+			stack[ns++] = node.child + 1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+int FESurfaceBVH::FindClosestNode(const vec3d& x) const
+{
+	if (m_node.empty()) return -1;
+
+	FEMesh& mesh = *m_ps->GetMesh();
+
+	int imin = -1;
+	double d2min = 1e99;
+
+	int stack[BVH_STACK_SIZE];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const NODE& node = m_node[stack[--ns]];
+		if (box_dist2(node.bmin, node.bmax, x) >= d2min) continue;
+
+		if (node.child < 0)
+		{
+			for (int i = 0; i < node.count; ++i)
+			{
+				FESurfaceElement& el = m_ps->Element(m_facet[node.first + i]);
+				int ne = el.Nodes();
+				for (int j = 0; j < ne; ++j)
+				{
+					double d2 = (mesh.Node(el.m_node[j]).m_rt - x).norm2();
+					if ((d2 < d2min) || ((d2 == d2min) && (el.m_lnode[j] < imin)))
+					{
+						d2min = d2;
+						imin = el.m_lnode[j];
+					}
+				}
+			}
+		}
+		else
+		{
+			// visit the closest child first (it is pushed last)
+			int c0 = node.child, c1 = node.child + 1;
+			double d0 = box_dist2(m_node[c0].bmin, m_node[c0].bmax, x);
+			double d1 = box_dist2(m_node[c1].bmin, m_node[c1].bmax, x);
+			if (d0 < d1) { stack[ns++] = c1; stack[ns++] = c0; }
+			else { stack[ns++] = c0; stack[ns++] = c1; }
+		}
+	}
+
+	return imin;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindRayCandidates(const vector<vec3d>& p, const vector<vec3d>& n, double srad, double tol, vector< vector<int> >& sel) const
+{
+	int N = (int)p.size();
+	assert(n.size() == p.size());
+	sel.resize(N);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < N; ++i) FindRayCandidates(p[i], n[i], srad, tol, sel[i]);
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindClosestNodes(const vector<vec3d>& x, vector<int>& nodes) const
+{
+	int N = (int)x.size();
+	nodes.resize(N);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < N; ++i) nodes[i] = FindClosestNode(x[i]);
+}
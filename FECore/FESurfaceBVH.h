@@ -0,0 +1,98 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "vec3d.h"
+#include <vector>
+#include "fecore_api.h"
+
+class FESurface;
+
+//-----------------------------------------------------------------------------
+//! Bounding volume hierarchy of the facets of a surface.
+//! The hierarchy is built once from the facet centroids. As the nodes move, the
+//! boxes are refit to the current nodal positions while the tree topology is
+//! kept, which is much cheaper than rebuilding a search structure every time.
+//! All queries are const and can be called concurrently from multiple threads.
+class FECORE_API FESurfaceBVH
+{
+public:
+	struct NODE
+	{
+		vec3d	bmin, bmax;	//!< bounding box of this node
+		int		child;		//!< index of first child (second child is child+1), -1 for leaves
+		int		first;		//!< index of first facet in the facet list (leaves only)
+		int		count;		//!< number of facets (leaves only)
+	};
+
+public:
+	FESurfaceBVH(FESurface* ps = nullptr);
+
+	//! attach to a surface
+	void Attach(FESurface* ps) { m_ps = ps; }
+
+	//! build the hierarchy for the current configuration
+	void Build();
+
+	//! update the boxes to the current nodal positions, keeping the tree topology
+	void Refit();
+
+	//! Refit the hierarchy, or rebuild it if the surface changed or the tree degraded too much
+	void Update();
+
+	//! return true if the hierarchy was built
+	bool IsValid() const { return (m_node.empty() == false); }
+
+public:
+	//! Find all facets whose (inflated) box is intersected by the line through p along n
+	//! and lies within the search radius srad of p (srad <= 0 disables the radius test).
+	//! The boxes are inflated in all directions by tol times their diagonal, so that flat facets
+	//! still have a finite thickness. Each facet is returned once.
+	void FindRayCandidates(const vec3d& p, const vec3d& n, double srad, double tol, std::vector<int>& sel) const;
+
+	//! Find the facets whose box lies within distance d of p
+	void FindCandidates(const vec3d& p, double d, std::vector<int>& sel) const;
+
+	//! Find the surface node (local index) closest to x in the current configuration
+	int FindClosestNode(const vec3d& x) const;
+
+	//! batched versions of the queries above (evaluated in parallel)
+	void FindRayCandidates(const std::vector<vec3d>& p, const std::vector<vec3d>& n, double srad, double tol, std::vector< std::vector<int> >& sel) const;
+	void FindClosestNodes(const std::vector<vec3d>& x, std::vector<int>& nodes) const;
+
+private:
+	void BuildNode(int inode, int first, int count, std::vector<vec3d>& centroid);
+
+private:
+	FESurface*			m_ps;		//!< the surface
+	std::vector<NODE>	m_node;		//!< the tree nodes (root is first, children always follow their parent)
+	std::vector<int>	m_facet;	//!< facet list, ordered such that each leaf references a contiguous range
+	std::vector<vec3d>	m_fmin;		//!< facet box (min corner)
+	std::vector<vec3d>	m_fmax;		//!< facet box (max corner)
+	double				m_area0;	//!< surface area of the root box at the last build
+};
@@ -0,0 +1,316 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "MBytecode.h"
+#include "MItem.h"
+#include <math.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// max number of registers that are allocated on the stack
+#define MAX_STACK_REGS	32
+
+// number of points that are evaluated together in a batch
+#define BATCH_SIZE		64
+
+//-----------------------------------------------------------------------------
+MBytecode::MBytecode()
+{
+	m_nreg = 0;
+	m_valid = false;
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::Clear()
+{
+	m_code.clear();
+	m_nreg = 0;
+	m_valid = false;
+}
+
+//-----------------------------------------------------------------------------
+bool MBytecode::Compile(const MItem* pi)
+{
+	Clear();
+	if (pi == nullptr) return false;
+
+	double c = 0.0;
+	int ret = compile(pi, 0, c);
+	if (ret < 0)
+	{
+		Clear();
+		return false;
+	}
+
+	// the entire expression is constant
+	if (ret == 1) emit(OP_CONST, 0, 0, c);
+
+	m_valid = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::emit(int op, int reg, int arg, double c)
+{
+	Instruction ins;
+	ins.op = op;
+	ins.reg = reg;
+	ins.arg = arg;
+	ins.c = c;
+	ins.fn = nullptr;
+	m_code.push_back(ins);
+
+	// binary operators also read the next register
+	int nreg = reg + 1;
+	if (((op >= OP_ADD) && (op <= OP_POW)) || (op == OP_F2D)) nreg = reg + 2;
+	if (op == OP_FND) nreg = reg + arg;
+	if (nreg > m_nreg) m_nreg = nreg;
+}
+
+//-----------------------------------------------------------------------------
+// Generate the code that evaluates the item pi and stores the result in register r.
+// The code only uses registers r and up. The return value is:
+//  1 : the item is constant. No code was generated and the value is returned in c.
+//  0 : code was generated.
+// -1 : the item cannot be compiled.
+int MBytecode::compile(const MItem* pi, int r, double& c)
+{
+	switch (pi->Type())
+	{
+	case MCONST:
+	case MFRAC:
+	case MNAMED:
+		c = mnumber(pi)->value();
+		return 1;
+	case MVAR:
+		emit(OP_VAR, r, mvar(pi)->index());
+		return 0;
+	case MNEG:
+	case MF1D:
+	{
+		double a = 0.0;
+		int k = compile(munary(pi)->Item(), r, a);
+		if (k < 0) return -1;
+		if (k == 1)
+		{
+			c = (pi->Type() == MNEG ? -a : (mfnc1d(pi)->funcptr())(a));
+			return 1;
+		}
+		if (pi->Type() == MNEG) emit(OP_NEG, r);
+		else
+		{
+			emit(OP_F1D, r);
+			m_code.back().f1 = mfnc1d(pi)->funcptr();
+		}
+		return 0;
+	}
+	case MADD:
+	case MSUB:
+	case MMUL:
+	case MDIV:
+	case MPOW:
+	case MF2D:
+	{
+		double a = 0.0, b = 0.0;
+		int kl = compile(mbinary(pi)->LeftItem(), r, a);
+		if (kl < 0) return -1;
+		int kr = compile(mbinary(pi)->RightItem(), r + 1, b);
+		if (kr < 0) return -1;
+
+		// fold constants
+		if ((kl == 1) && (kr == 1))
+		{
+			switch (pi->Type())
+			{
+			case MADD: c = a + b; break;
+			case MSUB: c = a - b; break;
+			case MMUL: c = a * b; break;
+			case MDIV: c = a / b; break;
+			case MPOW: c = pow(a, b); break;
+			case MF2D: c = (mfnc2d(pi)->funcptr())(a, b); break;
+			default:
+				assert(false);
+				break;
+			}
+			return 1;
+		}
+
+		// The code of the right operand only touches registers r+1 and up,
+		// so the constants can be loaded after it.
+		if (kl == 1) emit(OP_CONST, r, 0, a);
+		if (kr == 1) emit(OP_CONST, r + 1, 0, b);
+
+		switch (pi->Type())
+		{
+		case MADD: emit(OP_ADD, r); break;
+		case MSUB: emit(OP_SUB, r); break;
+		case MMUL: emit(OP_MUL, r); break;
+		case MDIV: emit(OP_DIV, r); break;
+		case MPOW: emit(OP_POW, r); break;
+		case MF2D:
+			emit(OP_F2D, r);
+			m_code.back().f2 = mfnc2d(pi)->funcptr();
+			break;
+		default:
+			assert(false);
+			break;
+		}
+		return 0;
+	}
+	case MSFNC:
+		return compile(msfncnd(pi)->Value(), r, c);
+	case MFND:
+	{
+		const MFuncND* f = mfncnd(pi);
+		int n = f->Params();
+		if (n <= 0) return -1;
+
+		vector<double> p(n, 0.0);
+		vector<int> k(n, 0);
+		bool allConst = true;
+		for (int i = 0; i < n; ++i)
+		{
+			k[i] = compile(f->Param(i), r + i, p[i]);
+			if (k[i] < 0) return -1;
+			if (k[i] == 0) allConst = false;
+		}
+
+		if (allConst)
+		{
+			c = (f->funcptr())(p.data(), n);
+			return 1;
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			if (k[i] == 1) emit(OP_CONST, r + i, 0, p[i]);
+		}
+		emit(OP_FND, r, n);
+		m_code.back().fn = f->funcptr();
+		return 0;
+	}
+	default:
+		return -1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double MBytecode::value(const double* var) const
+{
+	assert(m_valid);
+	double buf[MAX_STACK_REGS];
+	vector<double> tmp;
+	double* R = buf;
+	if (m_nreg > MAX_STACK_REGS)
+	{
+		tmp.resize(m_nreg);
+		R = tmp.data();
+	}
+
+	const int N = (int)m_code.size();
+	for (int i = 0; i < N; ++i)
+	{
+		const Instruction& ins = m_code[i];
+		double* r = R + ins.reg;
+		switch (ins.op)
+		{
+		case OP_CONST: r[0] = ins.c; break;
+		case OP_VAR  : r[0] = var[ins.arg]; break;
+		case OP_NEG  : r[0] = -r[0]; break;
+		case OP_ADD  : r[0] += r[1]; break;
+		case OP_SUB  : r[0] -= r[1]; break;
+		case OP_MUL  : r[0] *= r[1]; break;
+		case OP_DIV  : r[0] /= r[1]; break;
+		case OP_POW  : r[0] = pow(r[0], r[1]); break;
+		case OP_F1D  : r[0] = ins.f1(r[0]); break;
+		case OP_F2D  : r[0] = ins.f2(r[0], r[1]); break;
+		case OP_FND  : r[0] = ins.fn(r, ins.arg); break;
+		default:
+			assert(false);
+		}
+	}
+	return R[0];
+}
+
+//-----------------------------------------------------------------------------
+// The points are processed in batches. Each register stores the values of all
+// the points of the batch, so that each instruction is applied to the entire
+// batch at once.
+void MBytecode::values(int npts, const double* var, int nvar, double* result) const
+{
+	assert(m_valid);
+	if (npts <= 0) return;
+
+	const int B = BATCH_SIZE;
+	vector<double> R(m_nreg * B, 0.0);
+	vector<double> prm;
+
+	const int N = (int)m_code.size();
+	for (int p0 = 0; p0 < npts; p0 += B)
+	{
+		int nb = (npts - p0 < B ? npts - p0 : B);
+		const double* v = var + p0 * nvar;
+
+		for (int i = 0; i < N; ++i)
+		{
+			const Instruction& ins = m_code[i];
+			double* r = &R[ins.reg * B];
+			double* s = r + B;
+			switch (ins.op)
+			{
+			case OP_CONST: for (int k = 0; k < nb; ++k) r[k] = ins.c; break;
+			case OP_VAR  : for (int k = 0; k < nb; ++k) r[k] = v[k * nvar + ins.arg]; break;
+			case OP_NEG  : for (int k = 0; k < nb; ++k) r[k] = -r[k]; break;
+			case OP_ADD  : for (int k = 0; k < nb; ++k) r[k] += s[k]; break;
+			case OP_SUB  : for (int k = 0; k < nb; ++k) r[k] -= s[k]; break;
+			case OP_MUL  : for (int k = 0; k < nb; ++k) r[k] *= s[k]; break;
+			case OP_DIV  : for (int k = 0; k < nb; ++k) r[k] /= s[k]; break;
+			case OP_POW  : for (int k = 0; k < nb; ++k) r[k] = pow(r[k], s[k]); break;
+			case OP_F1D  : for (int k = 0; k < nb; ++k) r[k] = ins.f1(r[k]); break;
+			case OP_F2D  : for (int k = 0; k < nb; ++k) r[k] = ins.f2(r[k], s[k]); break;
+			case OP_FND:
+			{
+				// the parameters of a point are not contiguous, so we need to gather them
+				int n = ins.arg;
+				prm.resize(n);
+				for (int k = 0; k < nb; ++k)
+				{
+					for (int j = 0; j < n; ++j) prm[j] = r[j * B + k];
+					r[k] = ins.fn(prm.data(), n);
+				}
+			}
+			break;
+			default:
+				assert(false);
+			}
+		}
+
+		for (int k = 0; k < nb; ++k) result[p0 + k] = R[k];
+	}
+}
@@ -0,0 +1,104 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "MFunctions.h"
+#include "fecore_api.h"
+#include <vector>
+
+class MItem;
+
+//-----------------------------------------------------------------------------
+// This class stores a math expression as a flat list of register instructions.
+// It is compiled once from the expression tree, where sub-expressions that do
+// not depend on any variables are folded into constants. The result of the
+// expression ends up in register 0.
+class FECORE_API MBytecode
+{
+public:
+	enum OpCode {
+		OP_CONST,	// r[n] = c
+		OP_VAR,		// r[n] = var[arg]
+		OP_NEG,		// r[n] = -r[n]
+		OP_ADD,		// r[n] = r[n] + r[n+1]
+		OP_SUB,		// r[n] = r[n] - r[n+1]
+		OP_MUL,		// r[n] = r[n] * r[n+1]
+		OP_DIV,		// r[n] = r[n] / r[n+1]
+		OP_POW,		// r[n] = pow(r[n], r[n+1])
+		OP_F1D,		// r[n] = f(r[n])
+		OP_F2D,		// r[n] = f(r[n], r[n+1])
+		OP_FND		// r[n] = f(r[n], ..., r[n+arg-1])
+	};
+
+	struct Instruction
+	{
+		int		op;		// op code
+		int		reg;	// destination register (and first operand)
+		int		arg;	// variable index, or number of parameters
+		double	c;		// constant value
+		union {
+			FUNCPTR		f1;
+			FUNC2PTR	f2;
+			FUNCNPTR	fn;
+		};
+	};
+
+public:
+	MBytecode();
+
+	// compile the expression tree. Returns false if the expression contains
+	// items that cannot be compiled, in which case the tree has to be evaluated.
+	bool Compile(const MItem* pi);
+
+	// clear the code
+	void Clear();
+
+	// see if the code is valid
+	bool IsValid() const { return m_valid; }
+
+	// number of instructions
+	int Instructions() const { return (int)m_code.size(); }
+
+	// evaluate the expression for the variable values in var.
+	// This function is thread safe.
+	double value(const double* var) const;
+
+	// Evaluate the expression for npts points. The variable values of point i
+	// are stored in var[i*nvar], ..., var[i*nvar + nvar - 1].
+	// This function is thread safe.
+	void values(int npts, const double* var, int nvar, double* result) const;
+
+private:
+	int compile(const MItem* pi, int r, double& c);
+	void emit(int op, int reg, int arg = 0, double c = 0.0);
+
+private:
+	std::vector<Instruction>	m_code;		//!< the instructions
+	int							m_nreg;		//!< number of registers
+	bool						m_valid;	//!< code is valid
+};
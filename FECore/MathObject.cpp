@@ -133,6 +133,43 @@ double MSimpleExpression::value(const std::string& s)
 	return value();
 }
 
+//-----------------------------------------------------------------------------
+void MSimpleExpression::SetExpression(MITEM& e)
+{
+	m_item = e;
+
+	// compile the expression for the thread safe evaluation functions
+	m_code.Compile(m_item.ItemPtr());
+}
+
+//-----------------------------------------------------------------------------
+double MSimpleExpression::value_s(const double* var) const
+{
+	if (m_code.IsValid()) return m_code.value(var);
+
+	vector<double> v(var, var + m_Var.size());
+	return value(m_item.ItemPtr(), v);
+}
+
+//-----------------------------------------------------------------------------
+void MSimpleExpression::values_s(int npts, const double* var, double* result) const
+{
+	int nvar = (int)m_Var.size();
+	if (m_code.IsValid())
+	{
+		m_code.values(npts, var, nvar, result);
+		return;
+	}
+
+	// fall back to evaluating the tree
+	vector<double> v(nvar);
+	for (int i = 0; i < npts; ++i)
+	{
+		v.assign(var + i*nvar, var + (i + 1)*nvar);
+		result[i] = value(m_item.ItemPtr(), v);
+	}
+}
+
 //-----------------------------------------------------------------------------
 double MSimpleExpression::value(const MItem* pi) const
 {
@@ -230,7 +267,7 @@ double MSimpleExpression::value(const MItem* pi, const std::vector<double>& var)
 }
 
 //-----------------------------------------------------------------------------
-MSimpleExpression::MSimpleExpression(const MSimpleExpression& mo) : MathObject(mo), m_item(mo.m_item)
+MSimpleExpression::MSimpleExpression(const MSimpleExpression& mo) : MathObject(mo), m_item(mo.m_item), m_code(mo.m_code)
 {
 	// The copy c'tor of MathObject copied the variables, but any MVarRefs still point to the mo object, not this object's var list.
 	// Calling the following function fixes this
@@ -245,6 +282,7 @@ void MSimpleExpression::operator=(const MSimpleExpression& mo)
 
 	// copy the item
 	m_item = mo.m_item;
+	m_code = mo.m_code;
 
 	// The = operator of MathObject copied the variables, but any MVarRefs still point to the mo object, not this object's var list.
 	// Calling the following function fixes this
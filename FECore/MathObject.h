@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "MItem.h"
+#include "MBytecode.h"
 #include <vector>
 #include "fecore_api.h"
 
@@ -76,7 +77,7 @@ public:
 	MSimpleExpression(const MSimpleExpression& mo);
 	void operator = (const MSimpleExpression& mo);
 
-	void SetExpression(MITEM& e) { m_item = e; }
+	void SetExpression(MITEM& e);
 	MITEM& GetExpression() { return m_item; }
 	const MITEM& GetExpression() const { return m_item; }
 
@@ -100,9 +101,17 @@ public:
 	double value_s(const std::vector<double>& var) const
 	{ 
 		assert(var.size() == m_Var.size());
-		return value(m_item.ItemPtr(), var); 
+		return (m_code.IsValid() ? m_code.value(var.data()) : value(m_item.ItemPtr(), var));
 	}
 
+	// Same as above, but the variable values are passed as a raw array
+	double value_s(const double* var) const;
+
+	// Thread safe evaluation of the expression for an array of npts points. 
+	// The variable values of point i are stored in var[i*n], ..., var[i*n + n - 1], 
+	// where n is the number of variables.
+	void values_s(int npts, const double* var, double* result) const;
+
 	int Items();
 
 protected:
@@ -113,5 +122,6 @@ protected:
 	void fixVariableRefs(MItem* pi);
 
 protected:
-	MITEM	m_item;
+	MITEM		m_item;
+	MBytecode	m_code;		//!< compiled expression
 };
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "MatrixProfile.h"
 #include <assert.h>
+#include <algorithm>
 using namespace std;
 
 SparseMatrixProfile::ColumnProfile::ColumnProfile(const SparseMatrixProfile::ColumnProfile& a)
@@ -153,6 +154,31 @@ void SparseMatrixProfile::ColumnProfile::insertRow(int row)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// The rows are merged with the existing entries in one pass, which is much cheaper
+// than inserting the rows one by one when many rows are added.
+void SparseMatrixProfile::ColumnProfile::insertRows(const std::vector<int>& rows, std::vector<RowEntry>& buf)
+{
+	if (rows.empty()) return;
+
+	buf.clear();
+	const int N = (int)m_data.size();
+	const int M = (int)rows.size();
+	int i = 0, j = 0;
+	while ((i < N) || (j < M))
+	{
+		// pick the entry that starts first
+		RowEntry re;
+		if ((j >= M) || ((i < N) && (m_data[i].start <= rows[j]))) re = m_data[i++];
+		else { re.start = re.end = rows[j++]; }
+
+		// append it, merging it with the last entry if they overlap or touch
+		if (buf.empty() || (re.start > buf.back().end + 1)) buf.push_back(re);
+		else if (re.end > buf.back().end) buf.back().end = re.end;
+	}
+	m_data.swap(buf);
+}
+
 //-----------------------------------------------------------------------------
 //! MatrixProfile constructor. Takes the nr of equations as input argument.
 //! If n is larger than zero a default profile is constructor for a diagonal
@@ -285,27 +311,35 @@ void SparseMatrixProfile::UpdateProfile(vector< vector<int> >& LM, int M)
 	for (int i = 1; i<nc; ++i) ppelc[i] = ppelc[i - 1] + pval[i - 1];
 
 	// loop over all columns
-#pragma omp parallel for schedule(dynamic)
-	for (int i = 0; i<nc; ++i)
+	// Each thread collects the rows of a column in its own buffer, which is then 
+	// sorted and merged with the column profile.
+#pragma omp parallel
 	{
-		if (pval[i] > 0)
-		{
-			// get the column
-			ColumnProfile& a = m_prof[i];
+		vector<int> rows;
+		vector<RowEntry> buf;
 
-			// loop over all elements in the plec
-			for (int j = 0; j<pval[i]; ++j)
+#pragma omp for schedule(dynamic, 64)
+		for (int i = 0; i<nc; ++i)
+		{
+			if (pval[i] > 0)
 			{
-				int iel = (ppelc[i])[j];
-				int* lm = &(LM[iel])[0];
-				int N = (int)LM[iel].size();
-				for (int k = 0; k<N; ++k)
+				// collect the rows of all elements in the plec
+				rows.clear();
+				for (int j = 0; j<pval[i]; ++j)
 				{
-					if (lm[k] >= 0)
-					{ 
-						a.insertRow(lm[k]);
+					int iel = (ppelc[i])[j];
+					int* lm = &(LM[iel])[0];
+					int N = (int)LM[iel].size();
+					for (int k = 0; k<N; ++k)
+					{
+						if (lm[k] >= 0) rows.push_back(lm[k]);
 					}
 				}
+				sort(rows.begin(), rows.end());
+				rows.erase(unique(rows.begin(), rows.end()), rows.end());
+
+				// add them to the column
+				m_prof[i].insertRows(rows, buf);
 			}
 		}
 	}
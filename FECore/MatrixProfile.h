@@ -85,6 +85,10 @@ public:
 		// add row index to column profile
 		void insertRow(int row);
 
+		// add a sorted list of (unique) row indices to the column profile.
+		// The buffer is used as temporary storage.
+		void insertRows(const std::vector<int>& rows, std::vector<RowEntry>& buf);
+
 	private:
 		std::vector<RowEntry>	m_data;	// the column profile data
 	};
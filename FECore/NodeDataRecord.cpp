@@ -80,7 +80,7 @@ void NodeDataRecord::SetData(const char* szexpr)
 double NodeDataRecord::Evaluate(int item, int ndata)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	int nnode = item - 1;
+	int nnode = mesh.FindNodeIndexFromID(item);
 	assert((nnode>=0)&&(nnode<mesh.Nodes()));
 	if ((nnode < 0) || (nnode >= mesh.Nodes())) return 0;
 
@@ -91,9 +91,10 @@ double NodeDataRecord::Evaluate(int item, int ndata)
 //-----------------------------------------------------------------------------
 void NodeDataRecord::SelectAllItems()
 {
-	int n = GetFEModel()->GetMesh().Nodes();
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	int n = mesh.Nodes();
 	m_item.resize(n);
-	for (int i=0; i<n; ++i) m_item[i] = i+1;
+	for (int i=0; i<n; ++i) m_item[i] = mesh.Node(i).GetID();
 }
 
 //-----------------------------------------------------------------------------
@@ -102,9 +103,10 @@ void NodeDataRecord::SetItemList(FEItemList* items, const std::vector<int>& sele
 	// TODO: We don't support using a selection of a node set yet. 
 	assert(selection.empty());
 	FENodeSet* pns = dynamic_cast<FENodeSet*>(items); assert(pns);
+	FEMesh& mesh = GetFEModel()->GetMesh();
 	int n = pns->Size();
 	m_item.resize(n);
-	for (int i = 0; i < n; ++i) m_item[i] = (*pns)[i] + 1;
+	for (int i = 0; i < n; ++i) m_item[i] = mesh.Node((*pns)[i]).GetID();
 }
 
 //-----------------------------------------------------------------------------
@@ -48,19 +48,17 @@ bool DiagonalPreconditioner::Factor()
 	if (A->Columns() != N) return false;
 
 	m_D.resize(N);
+	int nerr = 0;
+#pragma omp parallel for reduction(+:nerr)
 	for (int i=0; i<N; ++i)
 	{
 		double dii = A->diag(i);
-		if (dii == 0.0) return false;
-		if (m_bsqr)
-		{
-			if (dii < 0) return false;
-			dii = sqrt(dii);
-		}
-		m_D[i] = 1.0 / dii;
+		if (m_bsqr) dii = (dii > 0 ? sqrt(dii) : 0.0);
+		if (dii == 0.0) nerr++;
+		else m_D[i] = 1.0 / dii;
 	}
 
-	return true;
+	return (nerr == 0);
 }
 
 // apply to vector P x = y
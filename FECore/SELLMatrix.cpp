@@ -0,0 +1,206 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SELLMatrix.h"
+#include "CompactMatrix.h"
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+SELLMatrix::SELLMatrix(int sigma)
+{
+	m_A = nullptr;
+	m_nrows = 0;
+	m_nnz = 0;
+
+	// the sorting window should be a multiple of the chunk height
+	if (sigma < C) sigma = C;
+	m_sigma = ((sigma + C - 1) / C) * C;
+}
+
+//-----------------------------------------------------------------------------
+void SELLMatrix::Clear()
+{
+	m_A = nullptr;
+	m_nrows = 0;
+	m_nnz = 0;
+	m_chunkPtr.clear();
+	m_row.clear();
+	m_col.clear();
+	m_src.clear();
+	m_val.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool SELLMatrix::Create(SparseMatrix* A)
+{
+	Clear();
+
+	CompactMatrix* K = dynamic_cast<CompactMatrix*>(A);
+	if ((K == nullptr) || (K->Rows() != K->Columns())) return false;
+
+	const int N = K->Rows();
+	const int* ptr = K->Pointers();
+	const int* ind = K->Indices();
+	const int offset = K->Offset();
+	const bool bsymm = K->isSymmetric();
+	const bool brow = K->isRowBased();
+
+	// Collect the (column, source) pairs of each row. For the symmetric format
+	// the mirrored entries of the off-diagonal elements are added as well.
+	vector<int> rowPtr(N + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = ptr[j] - offset; k < ptr[j + 1] - offset; ++k)
+		{
+			int i = ind[k] - offset;
+			if (brow) rowPtr[j + 1]++; else rowPtr[i + 1]++;
+			if (bsymm && (i != j)) rowPtr[j + 1]++;
+		}
+	}
+	for (int i = 0; i < N; ++i) rowPtr[i + 1] += rowPtr[i];
+
+	const int nnz = rowPtr[N];
+	vector<int> col(nnz), src(nnz);
+	vector<int> tag(rowPtr.begin(), rowPtr.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = ptr[j] - offset; k < ptr[j + 1] - offset; ++k)
+		{
+			int i = ind[k] - offset;
+			int r = (brow ? j : i);
+			int c = (brow ? i : j);
+			int l = tag[r]++;
+			col[l] = c; src[l] = k;
+			if (bsymm && (i != j))
+			{
+				l = tag[c]++;
+				col[l] = r; src[l] = k;
+			}
+		}
+	}
+
+	// sort the rows by decreasing length within each window of sigma rows
+	const int nchunks = (N + C - 1) / C;
+	m_row.assign(nchunks * C, -1);
+	for (int i = 0; i < N; ++i) m_row[i] = i;
+	for (int i0 = 0; i0 < N; i0 += m_sigma)
+	{
+		int i1 = min(i0 + m_sigma, N);
+		stable_sort(m_row.begin() + i0, m_row.begin() + i1, [&](int a, int b) {
+			return (rowPtr[a + 1] - rowPtr[a]) > (rowPtr[b + 1] - rowPtr[b]);
+		});
+	}
+
+	// determine the width of each chunk
+	m_chunkPtr.assign(nchunks + 1, 0);
+	for (int c = 0; c < nchunks; ++c)
+	{
+		int w = 0;
+		for (int l = 0; l < C; ++l)
+		{
+			int i = m_row[c*C + l];
+			if ((i >= 0) && (rowPtr[i + 1] - rowPtr[i] > w)) w = rowPtr[i + 1] - rowPtr[i];
+		}
+		m_chunkPtr[c + 1] = m_chunkPtr[c] + w * C;
+	}
+
+	// fill the chunks. Padding entries point to the row itself (or to row 0
+	// for the padding rows of the last chunk) so that they only read valid data.
+	const int nsize = m_chunkPtr[nchunks];
+	m_col.assign(nsize, 0);
+	m_src.assign(nsize, -1);
+	for (int c = 0; c < nchunks; ++c)
+	{
+		const int w = (m_chunkPtr[c + 1] - m_chunkPtr[c]) / C;
+		for (int l = 0; l < C; ++l)
+		{
+			const int i = m_row[c*C + l];
+			const int n = (i >= 0 ? rowPtr[i + 1] - rowPtr[i] : 0);
+			for (int k = 0; k < w; ++k)
+			{
+				int m = m_chunkPtr[c] + k*C + l;
+				if (k < n)
+				{
+					m_col[m] = col[rowPtr[i] + k];
+					m_src[m] = src[rowPtr[i] + k];
+				}
+				else m_col[m] = (i >= 0 ? i : 0);
+			}
+		}
+	}
+
+	m_A = A;
+	m_nrows = N;
+	m_nnz = nnz;
+	m_val.assign(nsize, 0.0);
+	Update();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SELLMatrix::Update()
+{
+	if (m_A == nullptr) return;
+	const double* pv = m_A->Values();
+	const int nsize = (int)m_val.size();
+	#pragma omp parallel for
+	for (int i = 0; i < nsize; ++i)
+	{
+		m_val[i] = (m_src[i] >= 0 ? pv[m_src[i]] : 0.0);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool SELLMatrix::mult_vector(double* x, double* y)
+{
+	const int nchunks = (int)m_chunkPtr.size() - 1;
+
+	#pragma omp parallel for schedule(guided)
+	for (int c = 0; c < nchunks; ++c)
+	{
+		double sum[C] = { 0.0 };
+		const double* pv = m_val.data() + m_chunkPtr[c];
+		const int* pc = m_col.data() + m_chunkPtr[c];
+		const int w = (m_chunkPtr[c + 1] - m_chunkPtr[c]) / C;
+		for (int k = 0; k < w; ++k, pv += C, pc += C)
+		{
+			for (int l = 0; l < C; ++l) sum[l] += pv[l] * x[pc[l]];
+		}
+
+		const int* pr = m_row.data() + c*C;
+		for (int l = 0; l < C; ++l)
+		{
+			if (pr[l] >= 0) y[pr[l]] = sum[l];
+		}
+	}
+
+	return true;
+}
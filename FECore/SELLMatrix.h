@@ -0,0 +1,85 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "MatrixOperator.h"
+#include <vector>
+
+class SparseMatrix;
+
+//-----------------------------------------------------------------------------
+// This class stores a copy of a sparse matrix in the sliced ELLPACK format (SELL-C-sigma).
+// The rows are grouped in chunks of C rows, and each chunk is padded to the length of
+// its longest row and stored column by column. This way the inner loop of the product
+// runs over C consecutive rows, which the compiler can vectorize. In order to reduce
+// the padding, the rows are sorted by length within windows of sigma rows.
+// The matrix can be created from a CompactSymmMatrix (both halves are stored),
+// a CRSSparseMatrix or a CCSSparseMatrix. After the values of the source matrix have
+// changed, call Update to copy the new values.
+class FECORE_API SELLMatrix : public MatrixOperator
+{
+public:
+	enum { C = 8 };		// chunk height
+
+public:
+	SELLMatrix(int sigma = 256);
+
+	// create the SELL structure from a sparse matrix and copy its values
+	bool Create(SparseMatrix* A);
+
+	// copy the values of the source matrix
+	void Update();
+
+	// release all data
+	void Clear();
+
+	// calculate the product y = Ax
+	bool mult_vector(double* x, double* y) override;
+
+public:
+	// number of rows
+	int Rows() const { return m_nrows; }
+
+	// number of nonzeroes (excluding the padding)
+	size_t NonZeroes() const { return m_nnz; }
+
+	// number of stored values (including the padding)
+	size_t StoredValues() const { return m_val.size(); }
+
+private:
+	SparseMatrix*	m_A;		// source matrix
+	int				m_nrows;	// number of rows
+	int				m_sigma;	// sorting window
+	size_t			m_nnz;		// number of nonzeroes
+
+	std::vector<int>	m_chunkPtr;	// start of each chunk in the value array
+	std::vector<int>	m_row;		// row of each slot (-1 for padding rows)
+	std::vector<int>	m_col;		// column index of each stored value
+	std::vector<int>	m_src;		// position in the source value array (-1 for padding)
+	std::vector<double>	m_val;		// stored values
+};
@@ -168,8 +168,12 @@ void SkylineMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const vec
 
 bool SkylineMatrix::check(int i, int j)
 {
-	assert(false);
-	return true;
+	// only the upper triangular part is stored
+	if (i > j) { i ^= j; j ^= i; i ^= j; }
+
+	// the entry is allocated if it lies within the column height
+	int l = m_ppointers[j + 1] - m_ppointers[j];
+	return (j - i < l);
 }
 
 void SkylineMatrix::add(int i, int j, double v)
@@ -36,6 +36,7 @@ SparseMatrix::SparseMatrix()
 {
 	m_nrow = m_ncol = 0;
 	m_nsize = 0;
+	m_batomic = true;
 }
 
 SparseMatrix::~SparseMatrix()
@@ -48,8 +49,50 @@ void SparseMatrix::Clear()
 	m_nsize = 0;
 }
 
+//-----------------------------------------------------------------------------
+//! The default implementation checks each entry of the column profile.
+bool SparseMatrix::checkColumn(int j, const SparseMatrixProfile::ColumnProfile& col)
+{
+	for (int k = 0; k < col.size(); ++k)
+	{
+		for (int i = col[k].start; i <= col[k].end; ++i)
+		{
+			if (check(i, j) == false) return false;
+		}
+	}
+	return true;
+}
+
 //! scale matrix
 void SparseMatrix::scale(const vector<double>& L, const vector<double>& R)
 {
 	assert(false);
 }
+
+//-----------------------------------------------------------------------------
+//! assemble an element matrix using a scatter map
+void SparseMatrix::AssembleScatter(const matrix& ke, const vector<int>& map)
+{
+	double* pv = Values();
+	const int N = ke.rows();
+	const int M = ke.columns();
+	assert(map.size() == N*M);
+	const int* pm = &map[0];
+	for (int i = 0; i < N; ++i, pm += M)
+	{
+		const double* ki = ke[i];
+		for (int j = 0; j < M; ++j)
+		{
+			int k = pm[j];
+			if (k >= 0)
+			{
+				if (m_batomic)
+				{
+					#pragma omp atomic
+					pv[k] += ki[j];
+				}
+				else pv[k] += ki[j];
+			}
+		}
+	}
+}
@@ -77,6 +77,9 @@ public: // functions to be overwritten in derived classes
 	//! check if an entry was allocated
 	virtual bool check(int i, int j) = 0;
 
+	//! check if all entries of column j of a (symmetric) matrix profile were allocated
+	virtual bool checkColumn(int j, const SparseMatrixProfile::ColumnProfile& col);
+
 	//! set entry to value
 	virtual void set(int i, int j, double v) = 0;
 
@@ -95,6 +98,22 @@ public: // functions to be overwritten in derived classes
 	//! scale matrix
 	virtual void scale(const std::vector<double>& L, const std::vector<double>& R);
 
+public:
+	//! Turn atomic updates in the Assemble functions on or off. Turning them off is only safe
+	//! when concurrent calls to Assemble never touch the same matrix entries (e.g. colored assembly).
+	void SetAtomicAssembly(bool b) { m_batomic = b; }
+
+	//! see if atomic updates are used during assembly
+	bool AtomicAssembly() const { return m_batomic; }
+
+	//! Build a scatter map for an nr x nc element matrix with row indices lmi and column indices lmj.
+	//! The map stores the offset into the Values() array for each entry of the element matrix 
+	//! (or -1 if the entry is not stored). Returns false if the matrix format does not support this.
+	virtual bool BuildScatterMap(int nr, int nc, const std::vector<int>& lmi, const std::vector<int>& lmj, std::vector<int>& map) { return false; }
+
+	//! assemble an element matrix using a scatter map
+	void AssembleScatter(const matrix& ke, const std::vector<int>& map);
+
 public:
 	//! multiply with vector
 	bool mult_vector(double* x, double* r) override { assert(false); return false; }
@@ -111,4 +130,5 @@ protected:
 	// NOTE: These values are set by derived classes
 	int	m_nrow, m_ncol;		//!< dimension of matrix
 	size_t m_nsize;			//!< number of nonzeroes (i.e. matrix elements actually allocated)
+	bool	m_batomic;		//!< use atomic updates during assembly (default = true)
 };
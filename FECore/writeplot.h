@@ -116,55 +116,82 @@ template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStr
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<T(FEElement& el, int ip)> fnc)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	std::vector<T> v(NE);
+#pragma omp parallel for shared(v)
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		T s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(el, j);
-		ar << s / (double) el.GaussPoints();
+		v[i] = s / (double) el.GaussPoints();
 	}
+
+	for (int i = 0; i < NE; ++i)
+		ar << v[i];
 }
 
 //=================================================================================================
 template <class Tin, class Tout> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<Tin(const FEMaterialPoint&)> fnc, std::function<Tout(const Tin& m)> flt)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	std::vector<Tout> v(NE);
+#pragma omp parallel for shared(v)
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		Tin s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(*el.GetMaterialPoint(j));
-		ar << flt(s / (double) el.GaussPoints());
+		v[i] = flt(s / (double) el.GaussPoints());
 	}
+
+	for (int i = 0; i < NE; ++i)
+		ar << v[i];
 }
 
 //=================================================================================================
 template <class Tin, class Tout> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<Tin(FEElement& el, int ip)> fnc, std::function<Tout(const Tin& m)> flt)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	std::vector<Tout> v(NE);
+#pragma omp parallel for shared(v)
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		Tin s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(el, j);
-		ar << flt(s / (double)el.GaussPoints());
+		v[i] = flt(s / (double)el.GaussPoints());
 	}
+
+	for (int i = 0; i < NE; ++i)
+		ar << v[i];
 }
 
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, FEDomainParameter* var)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	std::vector<T> v(NE);
+#pragma omp parallel for shared(v)
+	for (int i = 0; i<NE; ++i) {
 		FEElement& el = dom.ElementRef(i);
 		T s(0.0);
 		for (int j = 0; j < el.GaussPoints(); ++j)
 		{
-			FEParamValue v = var->value(*el.GetMaterialPoint(j));
-			s += v.value<T>();
+			FEParamValue pv = var->value(*el.GetMaterialPoint(j));
+			s += pv.value<T>();
 		}
-		ar << s / (double)el.GaussPoints();
+		v[i] = s / (double)el.GaussPoints();
 	}
+
+	for (int i = 0; i < NE; ++i)
+		ar << v[i];
 }
 
 //=================================================================================================
 template <class T> void writeIntegratedElementValue(FESolidDomain& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint& mp)> fnc)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
+	int NE = dom.Elements();
+	std::vector<T> v(NE);
+#pragma omp parallel for shared(v)
+	for (int i = 0; i<NE; ++i) {
 		FESolidElement& el = dom.Element(i);
 		double* gw = el.GaussWeights();
 
@@ -174,23 +201,30 @@ template <class T> void writeIntegratedElementValue(FESolidDomain& dom, FEDataSt
 			FEMaterialPoint& mp = *el.GetMaterialPoint(j);
 			ew += fnc(mp)*dom.detJ0(el, j)*gw[j];
 		}
-		ar << ew;
+		v[i] = ew;
 	}
+
+	for (int i = 0; i < NE; ++i)
+		ar << v[i];
 }
 
 //=================================================================================================
 template <class T> void writeNodalProjectedElementValues(FEMeshPartition& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint&)> var)
 {
-	// temp storage 
-	T si[FEElement::MAX_INTPOINTS];
-	T sn[FEElement::MAX_NODES];
+	// each element writes its nodal values to its own slice of the output buffer
+	int NE = dom.Elements();
+	std::vector<int> off(NE + 1, 0);
+	for (int i = 0; i < NE; ++i) off[i + 1] = off[i] + dom.ElementRef(i).Nodes();
+	std::vector<T> v(off[NE]);
 
 	// loop over all elements
-	int NE = dom.Elements();
+#pragma omp parallel for shared(v, off)
 	for (int i = 0; i<NE; ++i)
 	{
+		// temp storage 
+		T si[FEElement::MAX_INTPOINTS];
+
 		FEElement& e = dom.ElementRef(i);
-		int ne = e.Nodes();
 		int ni = e.GaussPoints();
 
 		// get the integration point values
@@ -202,11 +236,11 @@ template <class T> void writeNodalProjectedElementValues(FEMeshPartition& dom, F
 		}
 
 		// project to nodes
-		e.project_to_nodes(si, sn);
-
-		// push data to archive
-		for (int j = 0; j<ne; ++j) ar << sn[j];
+		e.project_to_nodes(si, &v[off[i]]);
 	}
+
+	// push data to archive
+	for (int j = 0; j < off[NE]; ++j) ar << v[j];
 }
 
 //=================================================================================================
@@ -0,0 +1,903 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "AMGPreconditioner.h"
+#include "SparseKernels.h"
+#include "SupernodalSolver.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/log.h>
+#include <algorithm>
+#include <math.h>
+using namespace NumCore;
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Data of one level of the multigrid hierarchy. The transfer operators map
+// between this level and the next (coarser) level.
+struct AMGPreconditioner::Level
+{
+	CSRView		A;			// level operator
+	CSRView		T;			// tentative prolongator
+	CSRView		P;			// smoothed prolongator
+	CSRView		R;			// restriction (= P^T)
+
+	vector<int>		nodePtr;	// start of each node in nodeEq
+	vector<int>		nodeEq;		// equations of each node
+	int				nns;		// nr of near-nullspace vectors
+	vector<double>	B;			// near-nullspace (row major, neq x nns)
+
+	vector<double>	Dinv;		// inverse of diagonal
+	double			lmax;		// largest eigenvalue of D^-1*A (est.)
+
+	vector<double>	b, x;		// right-hand side and solution (coarse levels only)
+	vector<double>	r, d, t;	// work vectors
+};
+
+//-----------------------------------------------------------------------------
+// sparse matrix product C = A*B, where B has ncols columns
+static void spgemm(const CSRView& A, const CSRView& B, int ncols, vector<int>& ptr, vector<int>& col, vector<double>& val)
+{
+	int n = A.Rows();
+	ptr.assign(n + 1, 0);
+
+	// count the nonzeroes of each row
+#pragma omp parallel
+	{
+		vector<int> mark(ncols, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < n; ++i)
+		{
+			int nnz = 0;
+			for (int k = A.m_ptr[i]; k < A.m_ptr[i + 1]; ++k)
+			{
+				int j = A.m_col[k];
+				for (int m = B.m_ptr[j]; m < B.m_ptr[j + 1]; ++m)
+				{
+					int c = B.m_col[m];
+					if (mark[c] != i) { mark[c] = i; nnz++; }
+				}
+			}
+			ptr[i + 1] = nnz;
+		}
+	}
+	for (int i = 0; i < n; ++i) ptr[i + 1] += ptr[i];
+
+	// calculate the values
+	col.resize(ptr[n]);
+	val.resize(ptr[n]);
+#pragma omp parallel
+	{
+		vector<int> mark(ncols, -1), pos(ncols);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < n; ++i)
+		{
+			int nnz = ptr[i];
+			for (int k = A.m_ptr[i]; k < A.m_ptr[i + 1]; ++k)
+			{
+				int j = A.m_col[k];
+				double aij = A.m_val[k];
+				for (int m = B.m_ptr[j]; m < B.m_ptr[j + 1]; ++m)
+				{
+					int c = B.m_col[m];
+					if (mark[c] != i)
+					{
+						mark[c] = i;
+						pos[c] = nnz;
+						col[nnz] = c;
+						val[nnz] = aij*B.m_val[m];
+						nnz++;
+					}
+					else val[pos[c]] += aij*B.m_val[m];
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// transpose of A, which has ncols columns
+static void transpose(const CSRView& A, int ncols, vector<int>& ptr, vector<int>& col, vector<double>& val)
+{
+	int n = A.Rows();
+	int nnz = A.NonZeroes();
+	ptr.assign(ncols + 1, 0);
+	for (int k = 0; k < nnz; ++k) ptr[A.m_col[k] + 1]++;
+	for (int i = 0; i < ncols; ++i) ptr[i + 1] += ptr[i];
+
+	col.resize(nnz);
+	val.resize(nnz);
+	vector<int> pos(ptr.begin(), ptr.end() - 1);
+	for (int i = 0; i < n; ++i)
+	{
+		for (int k = A.m_ptr[i]; k < A.m_ptr[i + 1]; ++k)
+		{
+			int m = pos[A.m_col[k]]++;
+			col[m] = i;
+			val[m] = A.m_val[k];
+		}
+	}
+}
+
+//=============================================================================
+BEGIN_FECORE_CLASS(AMGPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_maxLevels  , FE_RANGE_GREATER(0), "max_levels");
+	ADD_PARAMETER(m_coarseSize , FE_RANGE_GREATER(0), "coarse_size");
+	ADD_PARAMETER(m_theta      , FE_RANGE_GREATER_OR_EQUAL(0.0), "strength");
+	ADD_PARAMETER(m_smoother   , "smoother")->setEnums("Jacobi\0Chebyshev\0");
+	ADD_PARAMETER(m_smoothSteps, FE_RANGE_GREATER(0), "smoothing_steps");
+	ADD_PARAMETER(m_blockSize  , FE_RANGE_GREATER(0), "block_size");
+	ADD_PARAMETER(m_rbm        , "rigid_body_modes");
+	ADD_PARAMETER(m_printLevel , "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+AMGPreconditioner::AMGPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_maxLevels = 10;
+	m_coarseSize = 2000;
+	m_theta = 0.0;
+	m_smoother = 1;
+	m_smoothSteps = 2;
+	m_blockSize = 3;
+	m_rbm = true;
+	m_printLevel = 0;
+
+	m_hierarchyValid = false;
+	m_symmetric = false;
+	m_coarse = nullptr;
+	m_Ac = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+AMGPreconditioner::~AMGPreconditioner()
+{
+	Destroy();
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Destroy()
+{
+	for (Level* L : m_level) delete L;
+	m_level.clear();
+	m_hierarchyValid = false;
+
+	delete m_coarse; m_coarse = nullptr;
+	delete m_Ac; m_Ac = nullptr;
+	m_LU.clear(); m_LU.shrink_to_fit();
+	m_piv.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::PreProcess()
+{
+	// the sparsity pattern (may have) changed, so start over
+	Destroy();
+
+	SparseMatrix* A = GetSparseMatrix();
+	Level* L = new Level;
+	m_level.push_back(L);
+	if (L->A.Create(A) == false) return false;
+	m_symmetric = (dynamic_cast<CompactSymmMatrix*>(A) != nullptr);
+
+	BuildFineNodes(*L);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The nodes of the fine level are the mesh nodes. The near-nullspace consists of 
+// the rigid body modes for the displacement degrees of freedom and a constant
+// mode for each of the other degrees of freedom.
+void AMGPreconditioner::BuildFineNodes(Level& L)
+{
+	int neq = L.A.Rows();
+	L.nodePtr.assign(1, 0);
+	L.nodeEq.clear();
+
+	FEModel* fem = GetFEModel();
+	if (fem == nullptr)
+	{
+		// no model, so use nodes of fixed size with constant modes
+		int bs = m_blockSize;
+		L.nns = bs;
+		L.B.assign((size_t)neq*bs, 0.0);
+		for (int i = 0; i < neq; ++i)
+		{
+			L.nodeEq.push_back(i);
+			if (((i + 1) % bs == 0) || (i == neq - 1)) L.nodePtr.push_back(i + 1);
+			L.B[(size_t)i*bs + i%bs] = 1.0;
+		}
+		return;
+	}
+
+	FEMesh& mesh = fem->GetMesh();
+	int dofX = fem->GetDOFIndex("x");
+	int dofY = fem->GetDOFIndex("y");
+	int dofZ = fem->GetDOFIndex("z");
+	bool hasDisp = (dofX >= 0) && (dofY >= 0) && (dofZ >= 0);
+
+	// assign a near-nullspace vector to each degree of freedom
+	int ndofs = 0;
+	for (int i = 0; i < mesh.Nodes(); ++i) ndofs = max(ndofs, mesh.Node(i).dofs());
+	vector<int> dofCol(ndofs, -1);
+	int nns = 0;
+	if (hasDisp)
+	{
+		dofCol[dofX] = 0;
+		dofCol[dofY] = 1;
+		dofCol[dofZ] = 2;
+		nns = (m_rbm ? 6 : 3);
+	}
+	vector<int> tag(neq, 0);
+	for (int i = 0; i < mesh.Nodes(); ++i)
+	{
+		FENode& node = mesh.Node(i);
+		for (int j = 0; j < node.dofs(); ++j)
+		{
+			int n = node.m_ID[j];
+			if ((n >= 0) && (n < neq) && (dofCol[j] < 0)) dofCol[j] = nns++;
+		}
+	}
+	int miscCol = nns++;	// for equations that don't belong to a node
+
+	// rotations are taken about the center of the mesh, to keep the modes well-scaled
+	vec3d c(0, 0, 0);
+	for (int i = 0; i < mesh.Nodes(); ++i) c += mesh.Node(i).m_rt;
+	if (mesh.Nodes() > 0) c /= (double)mesh.Nodes();
+
+	L.nns = nns;
+	L.B.assign((size_t)neq*nns, 0.0);
+	for (int i = 0; i < mesh.Nodes(); ++i)
+	{
+		FENode& node = mesh.Node(i);
+		vec3d r = node.m_rt - c;
+		for (int j = 0; j < node.dofs(); ++j)
+		{
+			int n = node.m_ID[j];
+			if ((n < 0) || (n >= neq) || tag[n]) continue;
+			tag[n] = 1;
+			L.nodeEq.push_back(n);
+
+			double* b = &L.B[(size_t)n*nns];
+			b[dofCol[j]] = 1.0;
+			if (hasDisp && m_rbm)
+			{
+				if      (j == dofX) { b[4] =  r.z; b[5] = -r.y; }
+				else if (j == dofY) { b[3] = -r.z; b[5] =  r.x; }
+				else if (j == dofZ) { b[3] =  r.y; b[4] = -r.x; }
+			}
+		}
+		if ((int)L.nodeEq.size() > L.nodePtr.back()) L.nodePtr.push_back((int)L.nodeEq.size());
+	}
+
+	// all remaining equations are nodes of their own
+	for (int i = 0; i < neq; ++i)
+	{
+		if (tag[i] == 0)
+		{
+			L.nodeEq.push_back(i);
+			L.nodePtr.push_back((int)L.nodeEq.size());
+			L.B[(size_t)i*nns + miscCol] = 1.0;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Aggregate the nodes of level l, using the strength of the connections between 
+// the nodal blocks. The tentative prolongator interpolates the near-nullspace of 
+// each aggregate exactly. Returns false if the level cannot be coarsened further.
+bool AMGPreconditioner::Aggregate(int l)
+{
+	Level& L = *m_level[l];
+	const CSRView& A = L.A;
+	int neq = A.Rows();
+	int nn = (int)L.nodePtr.size() - 1;
+	const int* nodePtr = L.nodePtr.data();
+	const int* nodeEq = L.nodeEq.data();
+
+	vector<int> node(neq, -1);
+	for (int I = 0; I < nn; ++I)
+		for (int k = nodePtr[I]; k < nodePtr[I + 1]; ++k) node[nodeEq[k]] = I;
+
+	// Frobenius norms of the diagonal blocks
+	vector<double> dnorm(nn, 0.0);
+#pragma omp parallel for schedule(static)
+	for (int I = 0; I < nn; ++I)
+	{
+		double s = 0.0;
+		for (int n = nodePtr[I]; n < nodePtr[I + 1]; ++n)
+		{
+			int e = nodeEq[n];
+			for (int k = A.m_ptr[e]; k < A.m_ptr[e + 1]; ++k)
+			{
+				if (node[A.m_col[k]] == I) s += A.m_val[k] * A.m_val[k];
+			}
+		}
+		dnorm[I] = sqrt(s);
+	}
+
+	// Build the graph of strong connections: |A_IJ| >= theta*sqrt(|A_II|*|A_JJ|).
+	// The threshold is relaxed on the coarser levels.
+	double theta = m_theta*pow(0.5, l);
+	vector<int> gptr(nn + 1, 0), gadj;
+	for (int pass = 0; pass < 2; ++pass)
+	{
+#pragma omp parallel
+		{
+			vector<double> acc(nn, 0.0);
+			vector<int> mark(nn, -1), list;
+#pragma omp for schedule(dynamic, 256)
+			for (int I = 0; I < nn; ++I)
+			{
+				list.clear();
+				for (int n = nodePtr[I]; n < nodePtr[I + 1]; ++n)
+				{
+					int e = nodeEq[n];
+					for (int k = A.m_ptr[e]; k < A.m_ptr[e + 1]; ++k)
+					{
+						int J = node[A.m_col[k]];
+						if (J == I) continue;
+						if (mark[J] != I) { mark[J] = I; acc[J] = 0.0; list.push_back(J); }
+						acc[J] += A.m_val[k] * A.m_val[k];
+					}
+				}
+
+				int m = (pass == 0 ? 0 : gptr[I]);
+				for (int J : list)
+				{
+					if (sqrt(acc[J]) >= theta*sqrt(dnorm[I] * dnorm[J]))
+					{
+						if (pass == 1) gadj[m] = J;
+						m++;
+					}
+				}
+				if (pass == 0) gptr[I + 1] = m;
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (int I = 0; I < nn; ++I) gptr[I + 1] += gptr[I];
+			gadj.resize(gptr[nn]);
+		}
+	}
+
+	// phase 1: nodes whose neighbors are all free form an aggregate with their neighbors
+	vector<int> agg(nn, -1);
+	int naggs = 0;
+	for (int I = 0; I < nn; ++I)
+	{
+		if ((agg[I] != -1) || (gptr[I + 1] == gptr[I])) continue;
+		bool bfree = true;
+		for (int k = gptr[I]; k < gptr[I + 1]; ++k)
+		{
+			if (agg[gadj[k]] != -1) { bfree = false; break; }
+		}
+		if (bfree)
+		{
+			agg[I] = naggs;
+			for (int k = gptr[I]; k < gptr[I + 1]; ++k) agg[gadj[k]] = naggs;
+			naggs++;
+		}
+	}
+
+	// phase 2: attach the remaining nodes to a neighboring aggregate
+	vector<int> agg1(agg);
+	for (int I = 0; I < nn; ++I)
+	{
+		if (agg[I] != -1) continue;
+		for (int k = gptr[I]; k < gptr[I + 1]; ++k)
+		{
+			if (agg1[gadj[k]] != -1) { agg[I] = agg1[gadj[k]]; break; }
+		}
+	}
+
+	// phase 3: whatever is left forms new aggregates
+	for (int I = 0; I < nn; ++I)
+	{
+		if (agg[I] != -1) continue;
+		agg[I] = naggs;
+		for (int k = gptr[I]; k < gptr[I + 1]; ++k)
+		{
+			if (agg[gadj[k]] == -1) agg[gadj[k]] = naggs;
+		}
+		naggs++;
+	}
+
+	// equations of each aggregate
+	vector<int> aptr(naggs + 1, 0), aeq(neq);
+	for (int I = 0; I < nn; ++I) aptr[agg[I] + 1] += nodePtr[I + 1] - nodePtr[I];
+	for (int a = 0; a < naggs; ++a) aptr[a + 1] += aptr[a];
+	{
+		vector<int> pos(aptr.begin(), aptr.end() - 1);
+		for (int I = 0; I < nn; ++I)
+			for (int n = nodePtr[I]; n < nodePtr[I + 1]; ++n) aeq[pos[agg[I]]++] = nodeEq[n];
+	}
+
+	// Orthonormalize the near-nullspace of each aggregate (B = Q*R). 
+	// Q becomes the block of the tentative prolongator and R the coarse near-nullspace.
+	int k = L.nns;
+	vector<double> Q((size_t)neq*k, 0.0), R((size_t)naggs*k*k, 0.0);
+	vector<int> kdof(naggs, 0);
+#pragma omp parallel
+	{
+		vector<double> v;
+#pragma omp for schedule(dynamic, 64)
+		for (int a = 0; a < naggs; ++a)
+		{
+			int m = aptr[a + 1] - aptr[a];
+			double* Qa = &Q[(size_t)aptr[a] * k];	// column major, m x k
+			double* Ra = &R[(size_t)a*k*k];		// row major, k x k
+			v.resize(m);
+			int kp = 0;
+			for (int c = 0; c < k; ++c)
+			{
+				double nrm0 = 0.0;
+				for (int i = 0; i < m; ++i)
+				{
+					v[i] = L.B[(size_t)aeq[aptr[a] + i] * k + c];
+					nrm0 += v[i] * v[i];
+				}
+				nrm0 = sqrt(nrm0);
+				if (nrm0 == 0.0) continue;
+
+				// modified Gram-Schmidt with one reorthogonalization
+				for (int it = 0; it < 2; ++it)
+				{
+					for (int q = 0; q < kp; ++q)
+					{
+						double* qv = Qa + (size_t)q*m;
+						double r = 0.0;
+						for (int i = 0; i < m; ++i) r += qv[i] * v[i];
+						for (int i = 0; i < m; ++i) v[i] -= r*qv[i];
+						Ra[q*k + c] += r;
+					}
+				}
+				double nrm = 0.0;
+				for (int i = 0; i < m; ++i) nrm += v[i] * v[i];
+				nrm = sqrt(nrm);
+				if ((nrm > 1e-10*nrm0) && (kp < m))
+				{
+					double* qv = Qa + (size_t)kp*m;
+					for (int i = 0; i < m; ++i) qv[i] = v[i] / nrm;
+					Ra[kp*k + c] = nrm;
+					kp++;
+				}
+			}
+			kdof[a] = kp;
+		}
+	}
+
+	// coarse equation numbering
+	vector<int> cptr(naggs + 1, 0);
+	for (int a = 0; a < naggs; ++a) cptr[a + 1] = cptr[a] + kdof[a];
+	int nc = cptr[naggs];
+	if ((nc == 0) || (nc > 0.8*neq)) return false;
+
+	// build the tentative prolongator
+	vector<int> tptr(neq + 1, 0), tcol;
+	vector<double> tval;
+	for (int a = 0; a < naggs; ++a)
+		for (int i = aptr[a]; i < aptr[a + 1]; ++i) tptr[aeq[i] + 1] = kdof[a];
+	for (int i = 0; i < neq; ++i) tptr[i + 1] += tptr[i];
+	tcol.resize(tptr[neq]);
+	tval.resize(tptr[neq]);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int a = 0; a < naggs; ++a)
+	{
+		int m = aptr[a + 1] - aptr[a];
+		const double* Qa = &Q[(size_t)aptr[a] * k];
+		for (int i = 0; i < m; ++i)
+		{
+			int e = aeq[aptr[a] + i];
+			for (int c = 0; c < kdof[a]; ++c)
+			{
+				tcol[tptr[e] + c] = cptr[a] + c;
+				tval[tptr[e] + c] = Qa[(size_t)c*m + i];
+			}
+		}
+	}
+	L.T.Assign(neq, tptr, tcol, tval);
+
+	// set up the nodes and near-nullspace of the next level
+	Level* C = new Level;
+	C->nodePtr = cptr;
+	C->nodeEq.resize(nc);
+	for (int i = 0; i < nc; ++i) C->nodeEq[i] = i;
+	C->nns = k;
+	C->B.assign((size_t)nc*k, 0.0);
+	for (int a = 0; a < naggs; ++a)
+	{
+		for (int c = 0; c < kdof[a]; ++c)
+			for (int j = 0; j < k; ++j) C->B[(size_t)(cptr[a] + c)*k + j] = R[(size_t)a*k*k + c*k + j];
+	}
+	m_level.push_back(C);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The prolongator is smoothed with one damped Jacobi step, P = (I - w*D^-1*A)*T,
+// and the coarse operator is the Galerkin product Ac = P^T*A*P.
+void AMGPreconditioner::BuildCoarseOperator(int l)
+{
+	Level& L = *m_level[l];
+	Level& C = *m_level[l + 1];
+	int n = L.A.Rows();
+	int nc = (int)C.nodeEq.size();
+
+	vector<int> ptr, col;
+	vector<double> val;
+	spgemm(L.A, L.T, nc, ptr, col, val);
+
+	double w = 4.0 / (3.0*L.lmax);
+#pragma omp parallel
+	{
+		vector<int> mark(nc, -1), pos(nc);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < n; ++i)
+		{
+			double s = -w*L.Dinv[i];
+			for (int k = ptr[i]; k < ptr[i + 1]; ++k)
+			{
+				mark[col[k]] = i;
+				pos[col[k]] = k;
+				val[k] *= s;
+			}
+			for (int k = L.T.m_ptr[i]; k < L.T.m_ptr[i + 1]; ++k)
+			{
+				int c = L.T.m_col[k];
+				if (mark[c] == i) val[pos[c]] += L.T.m_val[k];
+			}
+		}
+	}
+	L.P.Assign(n, ptr, col, val);
+
+	transpose(L.P, nc, ptr, col, val);
+	L.R.Assign(nc, ptr, col, val);
+
+	CSRView AP;
+	spgemm(L.A, L.P, nc, ptr, col, val);
+	AP.Assign(n, ptr, col, val);
+
+	spgemm(L.R, AP, nc, ptr, col, val);
+	C.A.Assign(nc, ptr, col, val);
+}
+
+//-----------------------------------------------------------------------------
+// The smoothers need the inverse diagonal and an estimate of the largest 
+// eigenvalue of D^-1*A, which is found with a few power iterations.
+void AMGPreconditioner::SetupSmoother(int l)
+{
+	Level& L = *m_level[l];
+	int n = L.A.Rows();
+
+	L.Dinv.resize(n);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		int k = L.A.m_diag[i];
+		double d = (k >= 0 ? L.A.m_val[k] : 0.0);
+		L.Dinv[i] = (d != 0.0 ? 1.0 / d : 0.0);
+	}
+
+	L.r.resize(n);
+	L.d.resize(n);
+	L.t.resize(n);
+	if (l > 0)
+	{
+		L.b.resize(n);
+		L.x.resize(n);
+	}
+
+	double* v = L.d.data();
+	double* w = L.t.data();
+	for (int i = 0; i < n; ++i) v[i] = 1.0 + 0.1*(i % 7);
+	double lam = norm2(n, v);
+	for (int it = 0; it < 10; ++it)
+	{
+		double s = 1.0 / lam;
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i) v[i] *= s;
+		L.A.Multiply(v, w);
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i) v[i] = L.Dinv[i] * w[i];
+		lam = norm2(n, v);
+		if (lam == 0.0) { lam = 1.0; break; }
+	}
+	L.lmax = lam;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::SetupCoarseSolver()
+{
+	Level& L = *m_level.back();
+	const CSRView& A = L.A;
+	int n = A.Rows();
+
+	if (m_symmetric)
+	{
+		// convert to lower triangular column storage for the supernodal solver
+		int nnz = 0;
+		for (int j = 0; j < n; ++j)
+		{
+			if (A.m_diag[j] < 0)
+			{
+				feLogError("AMG preconditioner: zero diagonal on coarsest level.");
+				return false;
+			}
+			for (int k = A.m_ptr[j]; k < A.m_ptr[j + 1]; ++k) if (A.m_col[k] >= j) nnz++;
+		}
+
+		double* pv = new double[nnz];
+		int* pi = new int[nnz];
+		int* pp = new int[n + 1];
+		vector<pair<int, double> > colj;
+		pp[0] = 0;
+		for (int j = 0; j < n; ++j)
+		{
+			colj.clear();
+			for (int k = A.m_ptr[j]; k < A.m_ptr[j + 1]; ++k)
+			{
+				if (A.m_col[k] >= j) colj.push_back(pair<int, double>(A.m_col[k], A.m_val[k]));
+			}
+			sort(colj.begin(), colj.end());
+			pp[j + 1] = pp[j] + (int)colj.size();
+			for (int k = 0; k < (int)colj.size(); ++k)
+			{
+				pi[pp[j] + k] = colj[k].first;
+				pv[pp[j] + k] = colj[k].second;
+			}
+		}
+
+		CompactSymmMatrix* Ac = new CompactSymmMatrix(0);
+		Ac->alloc(n, n, nnz, pv, pi, pp);
+
+		if (m_coarse == nullptr) m_coarse = new SupernodalSolver(GetFEModel());
+		m_coarse->SetSparseMatrix(Ac);
+		delete m_Ac;
+		m_Ac = Ac;
+
+		if (m_coarse->PreProcess() == false) return false;
+		return m_coarse->Factor();
+	}
+
+	// dense LU factorization with partial pivoting
+	m_LU.assign((size_t)n*n, 0.0);
+	m_piv.resize(n);
+	double* a = m_LU.data();
+	for (int i = 0; i < n; ++i)
+		for (int k = A.m_ptr[i]; k < A.m_ptr[i + 1]; ++k) a[(size_t)i*n + A.m_col[k]] = A.m_val[k];
+
+	for (int k = 0; k < n; ++k)
+	{
+		int p = k;
+		for (int i = k + 1; i < n; ++i) if (fabs(a[(size_t)i*n + k]) > fabs(a[(size_t)p*n + k])) p = i;
+		m_piv[k] = p;
+		if (a[(size_t)p*n + k] == 0.0)
+		{
+			feLogError("AMG preconditioner: coarsest level is singular.");
+			return false;
+		}
+		if (p != k)
+		{
+			for (int j = 0; j < n; ++j) swap(a[(size_t)k*n + j], a[(size_t)p*n + j]);
+		}
+
+		double* ak = a + (size_t)k*n;
+#pragma omp parallel for schedule(static) if (n - k > 128)
+		for (int i = k + 1; i < n; ++i)
+		{
+			double* ai = a + (size_t)i*n;
+			double lik = ai[k] / ak[k];
+			ai[k] = lik;
+			if (lik != 0.0)
+			{
+				for (int j = k + 1; j < n; ++j) ai[j] -= lik*ak[j];
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::Factor()
+{
+	if (m_level.empty()) return false;
+
+	// copy the new values of the fine level matrix
+	m_level[0]->A.Update();
+
+	int l = 0;
+	while (true)
+	{
+		SetupSmoother(l);
+
+		bool coarsest = (l == (int)m_level.size() - 1);
+		if (m_hierarchyValid == false)
+		{
+			// Aggregate() adds the next level (unless the coarsening stalled)
+			coarsest = (m_level[l]->A.Rows() <= m_coarseSize) || (l + 1 >= m_maxLevels) || (Aggregate(l) == false);
+		}
+		if (coarsest) break;
+
+		BuildCoarseOperator(l);
+		l++;
+	}
+	m_hierarchyValid = true;
+
+	if (m_printLevel > 0)
+	{
+		double nnz0 = (double)m_level[0]->A.NonZeroes(), nnz = 0.0;
+		feLog("\tAMG hierarchy:\n");
+		for (int i = 0; i < (int)m_level.size(); ++i)
+		{
+			Level& L = *m_level[i];
+			feLog("\t\tlevel %d: equations = %d, nonzeroes = %d\n", i, L.A.Rows(), L.A.NonZeroes());
+			nnz += L.A.NonZeroes();
+		}
+		feLog("\t\toperator complexity = %lg\n", nnz / nnz0);
+	}
+
+	return SetupCoarseSolver();
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::BackSolve(double* x, double* y)
+{
+	if (m_level.empty() || (m_hierarchyValid == false)) return false;
+	Cycle(0, y, x);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Cycle(int l, const double* b, double* x)
+{
+	if (l == (int)m_level.size() - 1)
+	{
+		CoarseSolve(b, x);
+		return;
+	}
+
+	Level& L = *m_level[l];
+	Level& C = *m_level[l + 1];
+	int n = L.A.Rows();
+
+	// pre-smoothing
+	Smooth(l, b, x, true);
+
+	// restrict the residual
+	L.A.Residual(x, b, L.r.data());
+	L.R.Multiply(L.r.data(), C.b.data());
+
+	// coarse grid correction
+	Cycle(l + 1, C.b.data(), C.x.data());
+	L.P.Multiply(C.x.data(), L.t.data());
+	axpy(n, 1.0, L.t.data(), x);
+
+	// post-smoothing
+	Smooth(l, b, x, false);
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Smooth(int l, const double* b, double* x, bool zeroGuess)
+{
+	Level& L = *m_level[l];
+	int n = L.A.Rows();
+	double* r = L.r.data();
+	double* d = L.d.data();
+	double* t = L.t.data();
+	const double* Dinv = L.Dinv.data();
+
+	// initial residual
+	if (zeroGuess)
+	{
+		for (int i = 0; i < n; ++i) x[i] = 0.0;
+		copyVector(n, b, r);
+	}
+	else L.A.Residual(x, b, r);
+
+	if (m_smoother == 0)
+	{
+		// damped Jacobi
+		double w = 4.0 / (3.0*L.lmax);
+		for (int k = 0; k < m_smoothSteps; ++k)
+		{
+			if (k > 0) L.A.Residual(x, b, r);
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < n; ++i) x[i] += w*Dinv[i] * r[i];
+		}
+	}
+	else
+	{
+		// Chebyshev polynomial for D^-1*A, targeting the upper part of the spectrum
+		double lmax = 1.1*L.lmax;
+		double lmin = lmax / 30.0;
+		double theta = 0.5*(lmax + lmin);
+		double delta = 0.5*(lmax - lmin);
+		double sigma = theta / delta;
+		double rho = 1.0 / sigma;
+
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i) d[i] = Dinv[i] * r[i] / theta;
+
+		for (int k = 0; k < m_smoothSteps; ++k)
+		{
+			axpy(n, 1.0, d, x);
+			if (k == m_smoothSteps - 1) break;
+
+			// r = r - A*d
+			L.A.Multiply(d, t);
+			axpy(n, -1.0, t, r);
+
+			double rho1 = 1.0 / (2.0*sigma - rho);
+			double c1 = rho1*rho;
+			double c2 = 2.0*rho1 / delta;
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < n; ++i) d[i] = c1*d[i] + c2*Dinv[i] * r[i];
+			rho = rho1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::CoarseSolve(const double* b, double* x)
+{
+	Level& L = *m_level.back();
+	int n = L.A.Rows();
+
+	if (m_coarse)
+	{
+		copyVector(n, b, L.r.data());
+		m_coarse->BackSolve(x, L.r.data());
+		return;
+	}
+
+	// dense LU
+	const double* a = m_LU.data();
+	for (int i = 0; i < n; ++i) x[i] = b[i];
+	for (int k = 0; k < n; ++k) if (m_piv[k] != k) swap(x[k], x[m_piv[k]]);
+	for (int i = 1; i < n; ++i)
+	{
+		const double* ai = a + (size_t)i*n;
+		double xi = x[i];
+		for (int j = 0; j < i; ++j) xi -= ai[j] * x[j];
+		x[i] = xi;
+	}
+	for (int i = n - 1; i >= 0; --i)
+	{
+		const double* ai = a + (size_t)i*n;
+		double xi = x[i];
+		for (int j = i + 1; j < n; ++j) xi -= ai[j] * x[j];
+		x[i] = xi / ai[i];
+	}
+}
@@ -0,0 +1,115 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+
+class CompactSymmMatrix;
+class SupernodalSolver;
+
+//-----------------------------------------------------------------------------
+//! Smoothed aggregation algebraic multigrid preconditioner.
+
+//! The equations are aggregated by node, using the nodal equation numbers (FENode::m_ID),
+//! and the rigid body modes that follow from the nodal coordinates are used as the 
+//! near-nullspace. (If no model is available, blocks of fixed size are used instead, 
+//! with constant modes.) The tentative prolongator of each aggregate interpolates these
+//! modes exactly, and is smoothed with a damped Jacobi step. The smoothers (Chebyshev 
+//! or damped Jacobi) only need matrix-vector products, so they run fully in parallel. 
+//! The coarsest level is solved with the supernodal solver (or a dense LU factorization
+//! for unsymmetric matrices).
+//! The aggregates only depend on the sparsity pattern and are reused until PreProcess
+//! is called again. The Galerkin operators are recomputed each time the matrix is factored.
+class AMGPreconditioner : public Preconditioner
+{
+	struct Level;
+
+public:
+	AMGPreconditioner(FEModel* fem);
+	~AMGPreconditioner();
+
+	// set up the fine level
+	bool PreProcess() override;
+
+	// build the multigrid hierarchy
+	bool Factor() override;
+
+	// apply one V-cycle to the vector y
+	bool BackSolve(double* x, double* y) override;
+
+	// clean up
+	void Destroy() override;
+
+private:
+	// determine the nodes and near-nullspace of the fine level
+	void BuildFineNodes(Level& L);
+
+	// aggregate the nodes of level l and create the tentative prolongator
+	bool Aggregate(int l);
+
+	// calculate the smoothed prolongator and coarse grid operator of level l
+	void BuildCoarseOperator(int l);
+
+	// set up the smoother of level l
+	void SetupSmoother(int l);
+
+	// set up the coarse grid solver
+	bool SetupCoarseSolver();
+
+	// multigrid cycle on level l
+	void Cycle(int l, const double* b, double* x);
+
+	// apply the smoother to level l. 
+	void Smooth(int l, const double* b, double* x, bool zeroGuess);
+
+	// solve the coarsest level
+	void CoarseSolve(const double* b, double* x);
+
+private:
+	int		m_maxLevels;	//!< max nr of levels
+	int		m_coarseSize;	//!< max nr of equations on the coarsest level
+	double	m_theta;		//!< strength of connection threshold
+	int		m_smoother;		//!< 0 = Jacobi, 1 = Chebyshev
+	int		m_smoothSteps;	//!< nr of smoothing steps (or polynomial degree)
+	int		m_blockSize;	//!< node size if no model is available
+	bool	m_rbm;			//!< use rotations in the near-nullspace
+	int		m_printLevel;	//!< print level
+
+private:
+	std::vector<Level*>	m_level;
+	bool				m_hierarchyValid;	//!< the aggregates can be reused
+	bool				m_symmetric;
+
+	// coarse grid solver
+	SupernodalSolver*	m_coarse;
+	CompactSymmMatrix*	m_Ac;
+	std::vector<double>	m_LU;	// dense LU factorization (unsymmetric case)
+	std::vector<int>	m_piv;
+
+	DECLARE_FECORE_CLASS();
+};
@@ -26,6 +26,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "BiCGStabSolver.h"
 #include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BSRMatrix.h>
 #include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
@@ -34,6 +35,7 @@ BEGIN_FECORE_CLASS(BiCGStabSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_tol, "tol");
 	ADD_PARAMETER(m_maxiter, "max_iter");
 	ADD_PARAMETER(m_fail_max_iter, "fail_max_iters");
+	ADD_PARAMETER(m_bsr, "bsr");
 	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
 END_FECORE_CLASS();
 
@@ -45,6 +47,7 @@ BiCGStabSolver::BiCGStabSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(
 	m_abstol = 0.0;
 	m_print_level = 0;
 	m_fail_max_iter = true;
+	m_bsr = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -57,11 +60,17 @@ SparseMatrix* BiCGStabSolver::CreateSparseMatrix(Matrix_Type ntype)
 		m_P->SetPartitions(m_part);
 		m_pA = m_P->CreateSparseMatrix(ntype);
 	}
-	else
+
+	// if the preconditioner doesn't care, allocate a matrix ourselves
+	if (m_pA == nullptr)
 	{
-		if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
+		if (m_bsr) m_pA = new BSRMatrix(ntype == REAL_SYMMETRIC, GetFEModel());
+		else if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
 		else m_pA = new CRSSparseMatrix(1);
 	}
+
+	if (m_P) m_P->SetSparseMatrix(m_pA);
+
 	return m_pA;
 }
 
@@ -69,6 +78,7 @@ SparseMatrix* BiCGStabSolver::CreateSparseMatrix(Matrix_Type ntype)
 bool BiCGStabSolver::SetSparseMatrix(SparseMatrix* A)
 {
 	m_pA = A;
+	if (m_P) m_P->SetSparseMatrix(A);
 	return (m_pA != 0);
 }
 
@@ -93,6 +103,9 @@ bool BiCGStabSolver::HasPreconditioner() const
 //-----------------------------------------------------------------------------
 bool BiCGStabSolver::PreProcess()
 {
+	// the structure of the matrix is known at this point
+	if (m_K.Create(m_pA, true) == false) return false;
+	if (m_P && (m_P->PreProcess() == false)) return false;
 	return true;
 }
 
@@ -100,34 +113,30 @@ bool BiCGStabSolver::PreProcess()
 bool BiCGStabSolver::Factor()
 {
 	if (m_pA == 0) return false;
-	if (m_P)
-	{
-		if (m_P->PreProcess() == false) return false;
-		if (m_P->Factor() == false) return false;
-	}
+
+	// copy the new matrix values
+	m_K.Update();
+
+	if (m_P && (m_P->Factor() == false)) return false;
+
 	return true;
 }
 
 //-----------------------------------------------------------------------------
 bool BiCGStabSolver::BackSolve(double* x, double* b)
 {
-	if (m_pA == nullptr) return false;
+	using namespace NumCore;
 
-	SparseMatrix& A = *m_pA;
-	int neq = A.Rows();
+	int neq = m_K.Rows();
+	if (neq == 0) return false;
 
 	// assume initial guess is zero
 	for (int i = 0; i < neq; ++i) x[i] = 0.0;
 
 	// calculate initial norm
 	// r0 = b - A*x0
-	vector<double> r_i(neq); double norm0 = 0.0, normi = 0.0;
-	for (int j = 0; j < neq; ++j)
-	{
-		r_i[j] = b[j];
-		norm0 += r_i[j] * r_i[j];
-	}
-	norm0 = sqrt(norm0);
+	vector<double> r_i(b, b + neq);
+	double norm0 = norm2(neq, b), normi = 0.0;
 
 	// if the norm is zero, there is nothing to do
 	if (norm0 == 0.0) return true;
@@ -137,7 +146,7 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 
 	// initialize some stuff
 	double rho_p = 1, alpha = 1, w_p = 1;
-	vector<double> v_p(neq, 0.0), p_p(neq, 0.0), p_i(neq), y(neq, 0.0), h(neq), s(neq), z(neq), t(neq), q(neq);
+	vector<double> v_p(neq, 0.0), p_i(neq, 0.0), y(neq, 0.0), s(neq), z(neq), t(neq), q(neq);
 
 	int max_iter = m_maxiter;
 	if (max_iter == 0) max_iter = (neq < 150 ? neq : 150);
@@ -145,53 +154,49 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 	bool converged = false;
 	do
 	{
-		double rho_i = rt*r_i;
+		double rho_i = dotProduct(neq, &rt[0], &r_i[0]);
 
 		double beta = (rho_i / rho_p)*(alpha / w_p);
 
-		for (int j = 0; j < neq; ++j) p_i[j] = r_i[j] + beta*(p_p[j] - w_p*v_p[j]);
+		// p_i = r_i + beta*(p_(i-1) - w*v)
+#pragma omp parallel for schedule(static)
+		for (int j = 0; j < neq; ++j) p_i[j] = r_i[j] + beta*(p_i[j] - w_p*v_p[j]);
 
 		// apply preconditioner
-		if (m_P)
-		{
-			m_P->BackSolve(y, p_i);
-		}
-		else y = p_i;
+		if (m_P) m_P->BackSolve(&y[0], &p_i[0]);
+		else copyVector(neq, &p_i[0], &y[0]);
 
-		A.mult_vector(&y[0], &v_p[0]);
+		m_K.Multiply(&y[0], &v_p[0]);
 
-		alpha = rho_i / (rt*v_p);
+		alpha = rho_i / dotProduct(neq, &rt[0], &v_p[0]);
 
-		for (int j = 0; j < neq; ++j) h[j] = x[j] + alpha*y[j];
+		// h = x + alpha*y is stored in x
+		axpy(neq, alpha, &y[0], x);
 
+		// s = r_i - alpha*v
+#pragma omp parallel for schedule(static)
 		for (int j = 0; j < neq; ++j) s[j] = r_i[j] - alpha*v_p[j];
-//		If h is accurate enough then xi = h and quit
 
-		if (m_P)
-		{
-			m_P->BackSolve(z, s);
-		}
-		else z = s;
+		if (m_P) m_P->BackSolve(&z[0], &s[0]);
+		else copyVector(neq, &s[0], &z[0]);
 
-		A.mult_vector(&z[0], &t[0]);
+		m_K.Multiply(&z[0], &t[0]);
 
-		if (m_P)
-		{
-			m_P->BackSolve(q, t);
-		}
-		else q = t;
+		if (m_P) m_P->BackSolve(&q[0], &t[0]);
+		else copyVector(neq, &t[0], &q[0]);
 
-		w_p = (q*z) / (q*q);
+		w_p = dotProduct(neq, &q[0], &z[0]) / dotProduct(neq, &q[0], &q[0]);
 
-		for (int j = 0; j < neq; ++j) x[j] = h[j] + w_p*z[j];
-		
-		normi = 0.0;
+		// x = h + w*z, r_i = s - w*t
+		double rr = 0.0;
+#pragma omp parallel for reduction(+:rr) schedule(static)
 		for (int j = 0; j < neq; ++j)
 		{
+			x[j] += w_p*z[j];
 			r_i[j] = s[j] - w_p*t[j];
-			normi += r_i[j] * r_i[j];
+			rr += r_i[j] * r_i[j];
 		}
-		normi = sqrt(normi);
+		normi = sqrt(rr);
 
 		// see if we have converged
 		double tol = norm0*m_tol + m_abstol;
@@ -200,7 +205,6 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 		{
 			// prepare for next iteration
 			rho_p = rho_i;
-			p_p = p_i;
 		}
 
 		// check max iterations
@@ -227,4 +231,5 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 //-----------------------------------------------------------------------------
 void BiCGStabSolver::Destroy()
 {
+	m_K.Clear();
 }
@@ -26,6 +26,7 @@ SOFTWARE.*/
 #pragma once
 #include <FECore/Preconditioner.h>
 #include <FECore/CompactSymmMatrix.h>
+#include "SparseKernels.h"
 
 class BiCGStabSolver : public IterativeLinearSolver
 {
@@ -53,12 +54,14 @@ public:
 protected:
 	SparseMatrix*		m_pA;
 	Preconditioner*		m_P;
+	NumCore::CSRView	m_K;	// row view of the matrix used for the matrix-vector products
 
 	int		m_maxiter;		// max nr of iterations
 	double	m_tol;			// residual relative tolerance
 	double	m_abstol;		// absolute residual tolerance
 	int		m_print_level;	// output level
 	double	m_fail_max_iter;
+	bool	m_bsr;			// store the matrix in 3x3 block format
 
 	DECLARE_FECORE_CLASS();
 };
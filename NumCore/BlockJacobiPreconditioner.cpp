@@ -0,0 +1,222 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "BlockJacobiPreconditioner.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/log.h>
+#include <math.h>
+
+BEGIN_FECORE_CLASS(BlockJacobiPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_nodalBlocks, "nodal_blocks");
+	ADD_PARAMETER(m_blockSize  , FE_RANGE_GREATER(0), "block_size");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+// invert a dense n x n matrix a (row major) using Gauss-Jordan elimination 
+// with partial pivoting. The inverse is returned in ai.
+static bool invertBlock(int n, double* a, double* ai)
+{
+	for (int i = 0; i < n; ++i)
+		for (int j = 0; j < n; ++j) ai[i*n + j] = (i == j ? 1.0 : 0.0);
+
+	for (int k = 0; k < n; ++k)
+	{
+		// find the pivot
+		int p = k;
+		double amax = fabs(a[k*n + k]);
+		for (int i = k + 1; i < n; ++i)
+		{
+			if (fabs(a[i*n + k]) > amax) { amax = fabs(a[i*n + k]); p = i; }
+		}
+		if (amax == 0.0) return false;
+
+		if (p != k)
+		{
+			for (int j = 0; j < n; ++j)
+			{
+				double t = a[k*n + j]; a[k*n + j] = a[p*n + j]; a[p*n + j] = t;
+				t = ai[k*n + j]; ai[k*n + j] = ai[p*n + j]; ai[p*n + j] = t;
+			}
+		}
+
+		double d = 1.0 / a[k*n + k];
+		for (int j = 0; j < n; ++j) { a[k*n + j] *= d; ai[k*n + j] *= d; }
+
+		for (int i = 0; i < n; ++i)
+		{
+			double f = a[i*n + k];
+			if ((i != k) && (f != 0.0))
+			{
+				for (int j = 0; j < n; ++j)
+				{
+					a[i*n + j] -= f*a[k*n + j];
+					ai[i*n + j] -= f*ai[k*n + j];
+				}
+			}
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_blockSize = 3;
+	m_nodalBlocks = true;
+}
+
+//-----------------------------------------------------------------------------
+bool BlockJacobiPreconditioner::PreProcess()
+{
+	SparseMatrix* A = GetSparseMatrix();
+	if ((A == nullptr) || (A->Rows() != A->Columns())) return false;
+	int neq = A->Rows();
+
+	m_bptr.clear();
+	m_beq.clear();
+	m_bptr.push_back(0);
+
+	vector<bool> tag(neq, false);
+	FEModel* fem = GetFEModel();
+	if (m_nodalBlocks && fem)
+	{
+		FEMesh& mesh = fem->GetMesh();
+		for (int i = 0; i < mesh.Nodes(); ++i)
+		{
+			FENode& node = mesh.Node(i);
+			for (int j = 0; j < node.dofs(); ++j)
+			{
+				int n = node.m_ID[j];
+				if ((n >= 0) && (n < neq) && !tag[n])
+				{
+					m_beq.push_back(n);
+					tag[n] = true;
+				}
+			}
+			if ((int)m_beq.size() > m_bptr.back()) m_bptr.push_back((int)m_beq.size());
+		}
+
+		// all remaining equations are blocks of their own
+		for (int i = 0; i < neq; ++i)
+		{
+			if (tag[i] == false)
+			{
+				m_beq.push_back(i);
+				m_bptr.push_back((int)m_beq.size());
+			}
+		}
+	}
+	else
+	{
+		for (int i = 0; i < neq; ++i) m_beq.push_back(i);
+		for (int i = m_blockSize; i < neq; i += m_blockSize) m_bptr.push_back(i);
+		if (neq > 0) m_bptr.push_back(neq);
+	}
+
+	int nblocks = (int)m_bptr.size() - 1;
+	m_boff.resize(nblocks + 1);
+	m_boff[0] = 0;
+	for (int b = 0; b < nblocks; ++b)
+	{
+		int nb = m_bptr[b + 1] - m_bptr[b];
+		m_boff[b + 1] = m_boff[b] + nb*nb;
+	}
+	m_inv.resize(m_boff[nblocks]);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool BlockJacobiPreconditioner::Factor()
+{
+	SparseMatrix* A = GetSparseMatrix();
+	if (A == nullptr) return false;
+
+	int nblocks = (int)m_bptr.size() - 1;
+	if (nblocks <= 0) return false;
+
+	int failBlock = -1;
+#pragma omp parallel
+	{
+		vector<double> B;
+		int myFailBlock = -1;
+
+#pragma omp for schedule(dynamic, 64)
+		for (int b = 0; b < nblocks; ++b)
+		{
+			int nb = m_bptr[b + 1] - m_bptr[b];
+			const int* eq = &m_beq[m_bptr[b]];
+
+			// extract the diagonal block
+			B.resize(nb*nb);
+			for (int i = 0; i < nb; ++i)
+				for (int j = 0; j < nb; ++j) B[i*nb + j] = A->get(eq[i], eq[j]);
+
+			if (invertBlock(nb, B.data(), &m_inv[m_boff[b]]) == false) myFailBlock = b;
+		}
+
+		if (myFailBlock >= 0)
+		{
+#pragma omp critical
+			failBlock = myFailBlock;
+		}
+	}
+
+	if (failBlock >= 0)
+	{
+		feLogError("Block Jacobi preconditioner: singular diagonal block at equation %d.", m_beq[m_bptr[failBlock]]);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool BlockJacobiPreconditioner::BackSolve(double* x, double* y)
+{
+	int nblocks = (int)m_bptr.size() - 1;
+	if (nblocks <= 0) return false;
+
+#pragma omp parallel for schedule(static, 256)
+	for (int b = 0; b < nblocks; ++b)
+	{
+		int nb = m_bptr[b + 1] - m_bptr[b];
+		const int* eq = &m_beq[m_bptr[b]];
+		const double* Ai = &m_inv[m_boff[b]];
+		for (int i = 0; i < nb; ++i)
+		{
+			double xi = 0.0;
+			for (int j = 0; j < nb; ++j) xi += Ai[i*nb + j] * y[eq[j]];
+			x[eq[i]] = xi;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,66 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+
+//-----------------------------------------------------------------------------
+//! Block Jacobi preconditioner. 
+
+//! The diagonal blocks are formed by the equations of each node of the mesh 
+//! (i.e. 3x3 blocks for solid mechanics). Equations that do not belong to a node
+//! (e.g. rigid body degrees of freedom) form their own blocks. If no model is
+//! available, blocks of fixed size are used instead. The blocks are inverted 
+//! with a dense factorization during Factor().
+class BlockJacobiPreconditioner : public Preconditioner
+{
+public:
+	BlockJacobiPreconditioner(FEModel* fem);
+
+	// determine the blocks
+	bool PreProcess() override;
+
+	// invert the diagonal blocks
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+private:
+private:
+	int		m_blockSize;	//!< block size when no nodal blocks are used
+	bool	m_nodalBlocks;	//!< use the nodal equations as blocks
+
+private:
+	vector<int>		m_bptr;	//!< start of each block in m_beq
+	vector<int>		m_beq;	//!< equations of each block
+	vector<int>		m_boff;	//!< start of each block in m_inv
+	vector<double>	m_inv;	//!< the inverted blocks (row major)
+
+	DECLARE_FECORE_CLASS();
+};
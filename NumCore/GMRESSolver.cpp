@@ -0,0 +1,284 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "GMRESSolver.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BSRMatrix.h>
+#include <FECore/log.h>
+using namespace NumCore;
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(GMRESSolver, IterativeLinearSolver)
+	ADD_PARAMETER(m_maxiter       , "max_iter");
+	ADD_PARAMETER(m_print_level   , "print_level");
+	ADD_PARAMETER(m_nrestart      , "max_restart");
+	ADD_PARAMETER(m_tol           , "tol");
+	ADD_PARAMETER(m_abstol        , "abs_tol");
+	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_bsr           , "bsr");
+	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+GMRESSolver::GMRESSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(nullptr), m_P(nullptr)
+{
+	m_maxiter = 0; // use default min(N, 150)
+	m_nrestart = 0; // use default = maxiter
+	m_tol = 1e-6;
+	m_abstol = 0.0;
+	m_print_level = 0;
+	m_fail_max_iters = true;
+	m_bsr = false;
+}
+
+//-----------------------------------------------------------------------------
+GMRESSolver::~GMRESSolver()
+{
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* GMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// let the preconditioner decide first
+	m_pA = nullptr;
+	if (m_P)
+	{
+		m_P->SetPartitions(m_part);
+		m_pA = m_P->CreateSparseMatrix(ntype);
+	}
+
+	if (m_pA == nullptr)
+	{
+		if (m_bsr) m_pA = new BSRMatrix(ntype == REAL_SYMMETRIC, GetFEModel());
+		else if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix(1);
+		else m_pA = new CRSSparseMatrix(1);
+	}
+
+	if (m_P) m_P->SetSparseMatrix(m_pA);
+
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool GMRESSolver::SetSparseMatrix(SparseMatrix* A)
+{
+	m_pA = A;
+	if (m_P) m_P->SetSparseMatrix(A);
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void GMRESSolver::SetLeftPreconditioner(LinearSolver* P)
+{
+	m_P = dynamic_cast<Preconditioner*>(P);
+}
+
+//-----------------------------------------------------------------------------
+LinearSolver* GMRESSolver::GetLeftPreconditioner()
+{
+	return m_P;
+}
+
+//-----------------------------------------------------------------------------
+bool GMRESSolver::HasPreconditioner() const
+{
+	return (m_P != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool GMRESSolver::PreProcess()
+{
+	// the structure of the matrix is known at this point
+	if (m_K.Create(m_pA, true) == false) return false;
+
+	int N = m_K.Rows();
+	int M = (N < 150 ? N : 150);
+	if (m_nrestart > 0) M = m_nrestart;
+	else if (m_maxiter > 0) M = m_maxiter;
+	if (M > N) M = N;
+
+	m_V.resize((size_t)N*(M + 1));
+	m_w.resize(N);
+	m_z.resize(N);
+
+	if (m_P && (m_P->PreProcess() == false)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool GMRESSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+
+	// copy the new matrix values
+	m_K.Update();
+
+	if (m_P && (m_P->Factor() == false)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool GMRESSolver::BackSolve(double* x, double* b)
+{
+	int N = m_K.Rows();
+	if ((N == 0) || ((int)m_w.size() != N)) return false;
+
+	int M = (int)(m_V.size() / N) - 1;
+	int maxIter = (N < 150 ? N : 150);
+	if (m_maxiter > 0) maxIter = m_maxiter;
+
+	double* w = m_w.data();
+	double* z = m_z.data();
+
+	// Hessenberg matrix (column major), Givens rotations and rhs of the least-squares problem
+	vector<double> H((M + 1)*M), cs(M), sn(M), g(M + 1), y(M);
+
+	// initial guess is zero, so r0 = b
+	for (int i = 0; i < N; ++i) x[i] = 0.0;
+	double norm0 = norm2(N, b);
+	if (norm0 == 0.0) return true;
+	double tol = norm0*m_tol + m_abstol;
+
+	if (m_print_level > 0) feLog("GMRES:\n");
+
+	bool converged = false;
+	double beta = norm0;
+	double res = norm0;
+	copyVector(N, b, w);
+	int iter = 0;
+	while (true)
+	{
+		// start a new cycle with V[0] = r/|r|
+		double* V0 = &m_V[0];
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < N; ++i) V0[i] = w[i] / beta;
+		for (int i = 0; i <= M; ++i) g[i] = 0.0;
+		g[0] = beta;
+
+		int m = 0;
+		res = beta;
+		for (int j = 0; j < M; ++j)
+		{
+			double* Vj = &m_V[(size_t)j*N];
+			double* Vn = &m_V[(size_t)(j + 1)*N];
+
+			// w = A*M^-1*V[j]
+			if (m_P) { if (m_P->BackSolve(z, Vj) == false) return false; }
+			else copyVector(N, Vj, z);
+			m_K.Multiply(z, Vn);
+
+			// modified Gram-Schmidt
+			double* h = &H[(size_t)j*(M + 1)];
+			for (int i = 0; i <= j; ++i)
+			{
+				double* Vi = &m_V[(size_t)i*N];
+				h[i] = dotProduct(N, Vn, Vi);
+				axpy(N, -h[i], Vi, Vn);
+			}
+			h[j + 1] = norm2(N, Vn);
+			if (h[j + 1] != 0.0)
+			{
+				double s = 1.0 / h[j + 1];
+#pragma omp parallel for schedule(static)
+				for (int i = 0; i < N; ++i) Vn[i] *= s;
+			}
+
+			// apply the previous rotations to the new column
+			for (int i = 0; i < j; ++i)
+			{
+				double t = cs[i] * h[i] + sn[i] * h[i + 1];
+				h[i + 1] = -sn[i] * h[i] + cs[i] * h[i + 1];
+				h[i] = t;
+			}
+
+			// calculate the new rotation
+			double d = sqrt(h[j] * h[j] + h[j + 1] * h[j + 1]);
+			cs[j] = (d != 0.0 ? h[j] / d : 1.0);
+			sn[j] = (d != 0.0 ? h[j + 1] / d : 0.0);
+			h[j] = d;
+			h[j + 1] = 0.0;
+			g[j + 1] = -sn[j] * g[j];
+			g[j] = cs[j] * g[j];
+
+			res = fabs(g[j + 1]);
+			m = j + 1;
+			iter++;
+
+			if (m_print_level > 1) feLog("%3d = %lg (%lg)\n", iter, res, tol);
+
+			if ((res <= tol) || (iter >= maxIter) || (d == 0.0)) break;
+		}
+
+		// solve the upper triangular system H*y = g
+		for (int i = m - 1; i >= 0; --i)
+		{
+			double yi = g[i];
+			for (int k = i + 1; k < m; ++k) yi -= H[(size_t)k*(M + 1) + i] * y[k];
+			y[i] = (H[(size_t)i*(M + 1) + i] != 0.0 ? yi / H[(size_t)i*(M + 1) + i] : 0.0);
+		}
+
+		// update the solution x = x + M^-1*(V*y)
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < N; ++i)
+		{
+			double wi = 0.0;
+			for (int k = 0; k < m; ++k) wi += m_V[(size_t)k*N + i] * y[k];
+			w[i] = wi;
+		}
+		if (m_P) { if (m_P->BackSolve(z, w) == false) return false; }
+		else copyVector(N, w, z);
+		axpy(N, 1.0, z, x);
+
+		if (res <= tol) { converged = true; break; }
+		if ((iter >= maxIter) || (m == 0)) break;
+
+		// calculate the true residual for the next cycle
+		m_K.Residual(x, b, w);
+		beta = res = norm2(N, w);
+		if (beta <= tol) { converged = true; break; }
+	}
+
+	if (m_print_level == 1) feLog("%3d = %lg (%lg)\n", iter, res, norm0);
+
+	UpdateStats(iter);
+
+	return (m_fail_max_iters ? converged : true);
+}
+
+//-----------------------------------------------------------------------------
+void GMRESSolver::Destroy()
+{
+	m_K.Clear();
+	m_V.clear(); m_V.shrink_to_fit();
+	m_w.clear(); m_w.shrink_to_fit();
+	m_z.clear(); m_z.shrink_to_fit();
+}
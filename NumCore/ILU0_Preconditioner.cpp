@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "ILU0_Preconditioner.h"
 #include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/log.h>
 
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
 #ifdef MKL_ISS
@@ -65,6 +66,11 @@ SparseMatrix* ILU0_Preconditioner::CreateSparseMatrix(Matrix_Type ntype)
 }
 
 #ifdef MKL_ISS
+bool ILU0_Preconditioner::PreProcess()
+{
+	return true;
+}
+
 bool ILU0_Preconditioner::Factor()
 {
 
@@ -118,6 +124,114 @@ bool ILU0_Preconditioner::BackSolve(double* x, double* y)
 }
 
 #else
-bool ILU0_Preconditioner::Factor() { return false; }
-bool ILU0_Preconditioner::BackSolve(double* x, double* y) { return false; }
+//-----------------------------------------------------------------------------
+bool ILU0_Preconditioner::PreProcess()
+{
+	SparseMatrix* K = GetSparseMatrix();
+	if (K == nullptr) K = m_K;
+	if (K == nullptr) return false;
+
+	if (m_A.Create(K) == false) return false;
+
+	int N = m_A.Rows();
+	const int* ptr = m_A.m_ptr.data();
+	const int* col = m_A.m_col.data();
+	for (int i = 0; i < N; ++i)
+	{
+		if (m_A.m_diag[i] < 0)
+		{
+			feLogError("ILU0 preconditioner: missing diagonal element in row %d.", i);
+			return false;
+		}
+	}
+
+	m_lower.Create(N, ptr, col, 0, true);
+	m_upper.Create(N, ptr, col, 0, false);
+
+	m_Dinv.resize(N);
+	m_tmp.resize(N);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Native ILU(0) factorization. Rows of the same level of the lower triangle only 
+// depend on rows of previous levels, so they are factored in parallel.
+bool ILU0_Preconditioner::Factor()
+{
+	int N = m_A.Rows();
+	if (N == 0) return false;
+	const int* ptr = m_A.m_ptr.data();
+	const int* col = m_A.m_col.data();
+	const int* diag = m_A.m_diag.data();
+
+	// the factors overwrite the values of the view
+	m_A.Update();
+	double* LU = m_A.m_val.data();
+
+	int nlev = m_lower.Levels();
+	int failRow = -1;
+#pragma omp parallel
+	{
+		// position of each column in the current row
+		vector<int> pos(N, -1);
+		int myFailRow = -1;
+
+		for (int l = 0; l < nlev; ++l)
+		{
+#pragma omp for schedule(dynamic, 64)
+			for (int n = m_lower.m_lev[l]; n < m_lower.m_lev[l + 1]; ++n)
+			{
+				int i = m_lower.m_row[n];
+				for (int k = ptr[i]; k < ptr[i + 1]; ++k) pos[col[k]] = k;
+
+				for (int k = ptr[i]; k < diag[i]; ++k)
+				{
+					int c = col[k];
+					double lik = LU[k] / LU[diag[c]];
+					LU[k] = lik;
+					for (int m = diag[c] + 1; m < ptr[c + 1]; ++m)
+					{
+						int p = pos[col[m]];
+						if (p >= 0) LU[p] -= lik * LU[m];
+					}
+				}
+
+				double& uii = LU[diag[i]];
+				if (fabs(uii) <= m_zeroThreshold)
+				{
+					if (m_checkZeroDiagonal) uii = (uii < 0 ? -m_zeroReplace : m_zeroReplace);
+					else if (uii == 0.0) myFailRow = i;
+				}
+				m_Dinv[i] = (uii != 0.0 ? 1.0 / uii : 0.0);
+
+				for (int k = ptr[i]; k < ptr[i + 1]; ++k) pos[col[k]] = -1;
+			}
+		}
+
+		if (myFailRow >= 0)
+		{
+#pragma omp critical
+			failRow = myFailRow;
+		}
+	}
+
+	if (failRow >= 0)
+	{
+		feLogError("ILU0 preconditioner: zero pivot in row %d.", failRow);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool ILU0_Preconditioner::BackSolve(double* x, double* y)
+{
+	if (m_A.Rows() == 0) return false;
+	const double* LU = m_A.m_val.data();
+	NumCore::triangularSolve(m_A, LU, m_lower, nullptr, true, y, m_tmp.data());
+	NumCore::triangularSolve(m_A, LU, m_upper, m_Dinv.data(), false, m_tmp.data(), x);
+	return true;
+}
 #endif
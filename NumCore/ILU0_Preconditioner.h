@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "SparseKernels.h"
 
 //-----------------------------------------------------------------------------
 class ILU0_Preconditioner : public Preconditioner
@@ -35,6 +36,9 @@ class ILU0_Preconditioner : public Preconditioner
 public:
 	ILU0_Preconditioner(FEModel* fem);
 
+	// analyze the matrix structure
+	bool PreProcess() override;
+
 	// create a preconditioner for a sparse matrix
 	bool Factor() override;
 
@@ -54,5 +58,11 @@ private:
 	vector<double>		m_tmp;
 	CRSSparseMatrix*	m_K;
 
+	// data for the native implementation
+	NumCore::CSRView		m_A;		// matrix (and factor) structure
+	NumCore::LevelSchedule	m_lower;	// level schedule of L
+	NumCore::LevelSchedule	m_upper;	// level schedule of U
+	vector<double>			m_Dinv;		// inverse of diagonal of U
+
 	DECLARE_FECORE_CLASS();
 };
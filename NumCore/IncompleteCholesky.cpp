@@ -44,6 +44,9 @@ SOFTWARE.*/
 IncompleteCholesky::IncompleteCholesky(FEModel* fem) : Preconditioner(fem)
 {
 	m_L = nullptr;
+	m_pattern = nullptr;
+	m_patternRows = 0;
+	m_patternNNZ = 0;
 }
 
 CompactSymmMatrix* IncompleteCholesky::getMatrix()
@@ -51,6 +54,56 @@ CompactSymmMatrix* IncompleteCholesky::getMatrix()
 	return m_L;
 }
 
+// The factor has the structure of the matrix, so the level schedules of the 
+// triangular solves can be built once and reused as long as the structure does not change.
+bool IncompleteCholesky::PreProcess()
+{
+	CompactSymmMatrix* K = dynamic_cast<CompactSymmMatrix*>(GetSparseMatrix());
+	if (K == nullptr) return false;
+
+#ifndef MKL_ISS
+	BuildSchedules(K);
+#endif
+
+	return true;
+}
+
+void IncompleteCholesky::BuildSchedules(CompactSymmMatrix* K)
+{
+	int N = K->Rows();
+	int offset = K->Offset();
+	const int* row = K->Indices();
+	const int* col = K->Pointers();
+
+	// The factor is stored by columns, which is the row structure of L^T. 
+	// For the forward substitution we also need the rows of L.
+	m_Lptr.assign(N + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = col[j] - offset + 1; k < col[j + 1] - offset; ++k) m_Lptr[row[k] - offset + 1]++;
+	}
+	for (int i = 0; i < N; ++i) m_Lptr[i + 1] += m_Lptr[i];
+	m_Lcol.resize(m_Lptr[N]);
+	m_Lpos.resize(m_Lptr[N]);
+	vector<int> pos(m_Lptr.begin(), m_Lptr.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = col[j] - offset + 1; k < col[j + 1] - offset; ++k)
+		{
+			int n = pos[row[k] - offset]++;
+			m_Lcol[n] = j;
+			m_Lpos[n] = k;
+		}
+	}
+
+	m_lower.Create(N, m_Lptr.data(), m_Lcol.data(), 0, true);
+	m_upper.Create(N, col, row, offset, false);
+
+	m_pattern = K;
+	m_patternRows = N;
+	m_patternNNZ = K->NonZeroes();
+}
+
 // create a preconditioner for a sparse matrix
 bool IncompleteCholesky::Factor()
 {
@@ -58,7 +111,9 @@ bool IncompleteCholesky::Factor()
 	CompactSymmMatrix* K = dynamic_cast<CompactSymmMatrix*>(GetSparseMatrix());
 	if (K == nullptr) return false;
 
+#ifdef MKL_ISS
 	if (K->Offset() != 1) return false;
+#endif
 
 	int N = K->Rows();
 	int nnz = K->NonZeroes();
@@ -155,6 +210,11 @@ bool IncompleteCholesky::Factor()
 		assert(Lii != 0.0);
 	}
 
+#ifndef MKL_ISS
+	// the schedules are built in PreProcess, unless the structure changed since then
+	if ((m_pattern != K) || (m_patternRows != N) || (m_patternNNZ != nnz)) BuildSchedules(K);
+#endif
+
 	return true;
 }
 
@@ -177,6 +237,47 @@ bool IncompleteCholesky::BackSolve(double* x, double* y)
 
 	return true;
 #else 
+	if (m_L == nullptr) return false;
+	int N = m_L->Rows();
+	int offset = m_L->Offset();
+	const double* pv = m_L->Values();
+	const int* pi = m_L->Indices();
+	const int* pp = m_L->Pointers();
+	const int* Lptr = m_Lptr.data();
+	const int* Lcol = m_Lcol.data();
+	const int* Lpos = m_Lpos.data();
+	double* pz = z.data();
+
+	// solve L z = y, followed by L^T x = z, level by level
+	int nlevL = m_lower.Levels();
+	int nlevU = m_upper.Levels();
+#pragma omp parallel if (N >= 64*(nlevL < nlevU ? nlevL : nlevU))
+	{
+		for (int l = 0; l < nlevL; ++l)
+		{
+#pragma omp for schedule(static)
+			for (int n = m_lower.m_lev[l]; n < m_lower.m_lev[l + 1]; ++n)
+			{
+				int i = m_lower.m_row[n];
+				double zi = y[i];
+				for (int k = Lptr[i]; k < Lptr[i + 1]; ++k) zi -= pv[Lpos[k]] * pz[Lcol[k]];
+				pz[i] = zi / pv[pp[i] - offset];
+			}
+		}
+
+		for (int l = 0; l < nlevU; ++l)
+		{
+#pragma omp for schedule(static)
+			for (int n = m_upper.m_lev[l]; n < m_upper.m_lev[l + 1]; ++n)
+			{
+				int i = m_upper.m_row[n];
+				double xi = pz[i];
+				for (int k = pp[i] - offset + 1; k < pp[i + 1] - offset; ++k) xi -= pv[k] * x[pi[k] - offset];
+				x[i] = xi / pv[pp[i] - offset];
+			}
+		}
+	}
+
 	return true;
 #endif
 }
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "SparseKernels.h"
 
 class CompactSymmMatrix;
 
@@ -36,6 +37,9 @@ class IncompleteCholesky : public Preconditioner
 public:
 	IncompleteCholesky(FEModel* fem);
 
+	// build the level schedules of the triangular solves (only depends on the matrix structure)
+	bool PreProcess() override;
+
 	// create a preconditioner for a sparse matrix
 	bool Factor() override;
 
@@ -45,7 +49,23 @@ public:
 public:
 	CompactSymmMatrix* getMatrix();
 
+private:
+	// build the row structure of L and the level schedules from the structure of K
+	void BuildSchedules(CompactSymmMatrix* K);
+
 private:
 	CompactSymmMatrix*	m_L;
 	vector<double>		z;
+
+	// row structure of L (without the diagonal) for the native forward substitution
+	vector<int>				m_Lptr;
+	vector<int>				m_Lcol;
+	vector<int>				m_Lpos;		// position of each entry in the values of m_L
+	NumCore::LevelSchedule	m_lower;	// level schedule of L
+	NumCore::LevelSchedule	m_upper;	// level schedule of L^T
+
+	// the matrix (and its size) the schedules were built for
+	CompactSymmMatrix*	m_pattern;
+	int					m_patternRows;
+	int					m_patternNNZ;
 };
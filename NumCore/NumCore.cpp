@@ -49,6 +49,12 @@ SOFTWARE.*/
 #include "AccelerateSparseSolver.h"
 #include "SuperLU_MT.h"
 #include "MKLDSSolver.h"
+#include "SupernodalSolver.h"
+#include "PCGSolver.h"
+#include "GMRESSolver.h"
+#include "BlockJacobiPreconditioner.h"
+#include "SSORPreconditioner.h"
+#include "AMGPreconditioner.h"
 #include "numcore_api.h"
 
 //=============================================================================
@@ -73,11 +79,17 @@ NUMCORE_API void NumCore::InitModule()
     REGISTER_FECORE_CLASS(AccelerateSparseSolver, "accelerate");
     REGISTER_FECORE_CLASS(SuperLU_MT_Solver     , "superlu_mt");
     REGISTER_FECORE_CLASS(MKLDSSolver           , "mkl_dss");
+    REGISTER_FECORE_CLASS(SupernodalSolver      , "supernodal");
+    REGISTER_FECORE_CLASS(PCGSolver             , "pcg");
+    REGISTER_FECORE_CLASS(GMRESSolver           , "gmres");
 
 	// register preconditioners
 	REGISTER_FECORE_CLASS(ILU0_Preconditioner, "ilu0");
 	REGISTER_FECORE_CLASS(ILUT_Preconditioner, "ilut");
 	REGISTER_FECORE_CLASS(IncompleteCholesky , "ichol");
+	REGISTER_FECORE_CLASS(BlockJacobiPreconditioner, "block_jacobi");
+	REGISTER_FECORE_CLASS(SSORPreconditioner , "ssor");
+	REGISTER_FECORE_CLASS(AMGPreconditioner  , "amg");
 
 	// register eigen solvers
 	REGISTER_FECORE_CLASS(FEASTEigenSolver, "feast");
@@ -89,6 +101,6 @@ NUMCORE_API void NumCore::InitModule()
 #ifdef PARDISO
 	fecore.SetDefaultSolverType("pardiso");
 #else
-	fecore.SetDefaultSolverType("skyline");
+	fecore.SetDefaultSolverType("supernodal");
 #endif
 }
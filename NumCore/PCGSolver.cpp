@@ -0,0 +1,226 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "PCGSolver.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BSRMatrix.h>
+#include <FECore/log.h>
+using namespace NumCore;
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(PCGSolver, IterativeLinearSolver)
+	ADD_PARAMETER(m_print_level, "print_level");
+	ADD_PARAMETER(m_tol, "tol");
+	ADD_PARAMETER(m_abstol, "abs_tol");
+	ADD_PARAMETER(m_maxiter, "max_iter");
+	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_bsr, "bsr");
+	ADD_PROPERTY(m_P, "pc_left")->SetFlags(FEProperty::Optional);
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+PCGSolver::PCGSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(nullptr), m_P(nullptr)
+{
+	m_maxiter = 0; // use default min(N, 150)
+	m_tol = 1e-5;
+	m_abstol = 0.0;
+	m_print_level = 0;
+	m_fail_max_iters = true;
+	m_bsr = false;
+}
+
+//-----------------------------------------------------------------------------
+PCGSolver::~PCGSolver()
+{
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* PCGSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// let the preconditioner decide first
+	m_pA = nullptr;
+	if (m_P)
+	{
+		m_P->SetPartitions(m_part);
+		m_pA = m_P->CreateSparseMatrix(ntype);
+	}
+
+	if (m_pA == nullptr)
+	{
+		if (m_bsr) m_pA = new BSRMatrix(ntype == REAL_SYMMETRIC, GetFEModel());
+		else if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix(1);
+		else m_pA = new CRSSparseMatrix(1);
+	}
+
+	if (m_P) m_P->SetSparseMatrix(m_pA);
+
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool PCGSolver::SetSparseMatrix(SparseMatrix* A)
+{
+	m_pA = A;
+	if (m_P) m_P->SetSparseMatrix(A);
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+void PCGSolver::SetLeftPreconditioner(LinearSolver* P)
+{
+	m_P = dynamic_cast<Preconditioner*>(P);
+}
+
+//-----------------------------------------------------------------------------
+LinearSolver* PCGSolver::GetLeftPreconditioner()
+{
+	return m_P;
+}
+
+//-----------------------------------------------------------------------------
+bool PCGSolver::HasPreconditioner() const
+{
+	return (m_P != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool PCGSolver::PreProcess()
+{
+	// the structure of the matrix is known at this point
+	if (m_K.Create(m_pA, true) == false) return false;
+
+	int neq = m_K.Rows();
+	m_r.resize(neq);
+	m_z.resize(neq);
+	m_p.resize(neq);
+	m_q.resize(neq);
+
+	if (m_P && (m_P->PreProcess() == false)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool PCGSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+
+	// copy the new matrix values
+	m_K.Update();
+
+	if (m_P && (m_P->Factor() == false)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool PCGSolver::BackSolve(double* x, double* b)
+{
+	int neq = m_K.Rows();
+	if ((neq == 0) || ((int)m_r.size() != neq)) return false;
+
+	double* r = m_r.data();
+	double* z = m_z.data();
+	double* p = m_p.data();
+	double* q = m_q.data();
+
+	// initial guess is zero, so r0 = b
+	for (int i = 0; i < neq; ++i) x[i] = 0.0;
+	copyVector(neq, b, r);
+	double norm0 = norm2(neq, r);
+	if (norm0 == 0.0) return true;
+
+	// z0 = M^-1 r0, p0 = z0
+	if (m_P) { if (m_P->BackSolve(z, r) == false) return false; }
+	else copyVector(neq, r, z);
+	copyVector(neq, z, p);
+	double rz = dotProduct(neq, r, z);
+
+	int maxIter = m_maxiter;
+	if (maxIter <= 0) maxIter = (neq < 150 ? neq : 150);
+	double tol = norm0*m_tol + m_abstol;
+
+	if (m_print_level > 0) feLog("PCG:\n");
+
+	bool converged = false;
+	double normr = norm0;
+	int iter = 0;
+	while (iter < maxIter)
+	{
+		// q = A*p
+		m_K.Multiply(p, q);
+		double pq = dotProduct(neq, p, q);
+		if (pq == 0.0) break;
+		double alpha = rz / pq;
+
+		// update solution and residual
+		double rr = 0.0;
+#pragma omp parallel for reduction(+:rr) schedule(static)
+		for (int i = 0; i < neq; ++i)
+		{
+			x[i] += alpha*p[i];
+			r[i] -= alpha*q[i];
+			rr += r[i] * r[i];
+		}
+		normr = sqrt(rr);
+		iter++;
+
+		if (m_print_level > 1) feLog("%3d = %lg (%lg)\n", iter, normr, tol);
+
+		if (normr <= tol) { converged = true; break; }
+
+		// z = M^-1 r
+		if (m_P) { if (m_P->BackSolve(z, r) == false) break; }
+		else copyVector(neq, r, z);
+
+		double rz_new = dotProduct(neq, r, z);
+		double beta = rz_new / rz;
+		rz = rz_new;
+
+		// p = z + beta*p
+		xpay(neq, z, beta, p);
+	}
+
+	if (m_print_level == 1) feLog("%3d = %lg (%lg)\n", iter, normr, norm0);
+
+	UpdateStats(iter);
+
+	return (m_fail_max_iters ? converged : true);
+}
+
+//-----------------------------------------------------------------------------
+void PCGSolver::Destroy()
+{
+	m_K.Clear();
+	m_r.clear(); m_r.shrink_to_fit();
+	m_z.clear(); m_z.shrink_to_fit();
+	m_p.clear(); m_p.shrink_to_fit();
+	m_q.clear(); m_q.shrink_to_fit();
+}
@@ -100,7 +100,7 @@ bool RCICGSolver::HasPreconditioner() const
 //-----------------------------------------------------------------------------
 bool RCICGSolver::PreProcess()
 {
-	return true;
+	return (m_P ? m_P->PreProcess() : true);
 }
 
 //-----------------------------------------------------------------------------
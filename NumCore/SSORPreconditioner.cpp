@@ -0,0 +1,103 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SSORPreconditioner.h"
+#include <FECore/log.h>
+
+BEGIN_FECORE_CLASS(SSORPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_omega, FE_RANGE_OPEN(0.0, 2.0), "omega");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SSORPreconditioner::SSORPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_omega = 1.0;
+}
+
+//-----------------------------------------------------------------------------
+bool SSORPreconditioner::PreProcess()
+{
+	if (m_A.Create(GetSparseMatrix()) == false) return false;
+
+	int N = m_A.Rows();
+	m_Dinv.resize(N);
+	m_tmp.resize(N);
+
+	m_lower.Create(N, m_A.m_ptr.data(), m_A.m_col.data(), 0, true);
+	m_upper.Create(N, m_A.m_ptr.data(), m_A.m_col.data(), 0, false);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SSORPreconditioner::Factor()
+{
+	if ((m_omega <= 0.0) || (m_omega >= 2.0)) return false;
+
+	int N = m_A.Rows();
+	if (N == 0) return false;
+
+	// copy the new matrix values
+	m_A.Update();
+
+	for (int i = 0; i < N; ++i)
+	{
+		int k = m_A.m_diag[i];
+		double dii = (k >= 0 ? m_A.m_val[k] : 0.0);
+		if (dii == 0.0)
+		{
+			feLogError("SSOR preconditioner: zero diagonal element in row %d.", i);
+			return false;
+		}
+		m_Dinv[i] = m_omega / dii;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The SSOR preconditioner is M = w/(2-w) (D/w + L) (D/w)^-1 (D/w + U), 
+// so x = M^-1 y is found with a forward sweep, a diagonal scaling and a backward sweep.
+bool SSORPreconditioner::BackSolve(double* x, double* y)
+{
+	int N = m_A.Rows();
+	if (N == 0) return false;
+
+	double* z = m_tmp.data();
+	const double* val = m_A.m_val.data();
+	NumCore::triangularSolve(m_A, val, m_lower, m_Dinv.data(), true, y, z);
+
+	double s = (2.0 - m_omega) / m_omega;
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < N; ++i) z[i] *= s / m_Dinv[i];
+
+	NumCore::triangularSolve(m_A, val, m_upper, m_Dinv.data(), false, z, x);
+
+	return true;
+}
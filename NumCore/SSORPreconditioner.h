@@ -0,0 +1,64 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+#include "SparseKernels.h"
+
+//-----------------------------------------------------------------------------
+//! Symmetric successive over-relaxation (SSOR) preconditioner. 
+
+//! The forward and backward sweeps are level-scheduled so that they run in parallel.
+//! For symmetric matrices the preconditioner is symmetric as well, so it can be 
+//! used with the conjugate gradient solver.
+class SSORPreconditioner : public Preconditioner
+{
+public:
+	SSORPreconditioner(FEModel* fem);
+
+	// analyze the matrix structure
+	bool PreProcess() override;
+
+	// create the preconditioner
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+private:
+	double	m_omega;	//!< relaxation parameter (0 < omega < 2)
+
+private:
+	NumCore::CSRView		m_A;
+	NumCore::LevelSchedule	m_lower;
+	NumCore::LevelSchedule	m_upper;
+	vector<double>			m_Dinv;		//!< omega / diagonal
+	vector<double>			m_tmp;
+
+	DECLARE_FECORE_CLASS();
+};
@@ -0,0 +1,403 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SparseKernels.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/BSRMatrix.h>
+#include <algorithm>
+#include <math.h>
+using namespace NumCore;
+
+//=============================================================================
+CSRView::CSRView()
+{
+	m_A = nullptr;
+	m_bsr = nullptr;
+	m_nrows = 0;
+}
+
+//-----------------------------------------------------------------------------
+void CSRView::Clear()
+{
+	m_A = nullptr;
+	m_bsr = nullptr;
+	m_nrows = 0;
+	m_ptr.clear(); m_ptr.shrink_to_fit();
+	m_col.clear(); m_col.shrink_to_fit();
+	m_diag.clear(); m_diag.shrink_to_fit();
+	m_val.clear(); m_val.shrink_to_fit();
+	m_src.clear(); m_src.shrink_to_fit();
+}
+
+//-----------------------------------------------------------------------------
+bool CSRView::Create(SparseMatrix* A, bool productsOnly)
+{
+	Clear();
+	if ((A == nullptr) || (A->Rows() != A->Columns())) return false;
+
+	int N = A->Rows();
+
+	// the products of a block matrix don't need the scalar arrays
+	if (productsOnly && dynamic_cast<BSRMatrix*>(A))
+	{
+		m_bsr = dynamic_cast<BSRMatrix*>(A);
+		m_A = A;
+		m_nrows = N;
+		return true;
+	}
+
+	m_ptr.assign(N + 1, 0);
+
+	if (dynamic_cast<CompactSymmMatrix*>(A))
+	{
+		// lower triangular, column based storage. 
+		// Each off-diagonal entry appears in two rows of the expanded matrix.
+		CompactSymmMatrix& K = *dynamic_cast<CompactSymmMatrix*>(A);
+		int off = K.Offset();
+		const int* pp = K.Pointers();
+		const int* pi = K.Indices();
+		for (int j = 0; j < N; ++j)
+		{
+			for (int k = pp[j] - off; k < pp[j + 1] - off; ++k)
+			{
+				int r = pi[k] - off;
+				m_ptr[j + 1]++;
+				if (r != j) m_ptr[r + 1]++;
+			}
+		}
+		for (int i = 0; i < N; ++i) m_ptr[i + 1] += m_ptr[i];
+
+		int nnz = m_ptr[N];
+		m_col.resize(nnz);
+		m_src.resize(nnz);
+		std::vector<int> pos(m_ptr.begin(), m_ptr.end() - 1);
+
+		// Processing the columns in order keeps the column indices of each row sorted:
+		// row r receives its lower entries (j < r) before column r itself is processed.
+		for (int j = 0; j < N; ++j)
+		{
+			for (int k = pp[j] - off; k < pp[j + 1] - off; ++k)
+			{
+				int r = pi[k] - off;
+				int n = pos[j]++;
+				m_col[n] = r; m_src[n] = k;
+				if (r != j)
+				{
+					n = pos[r]++;
+					m_col[n] = j; m_src[n] = k;
+				}
+			}
+		}
+	}
+	else if (dynamic_cast<CRSSparseMatrix*>(A))
+	{
+		CRSSparseMatrix& K = *dynamic_cast<CRSSparseMatrix*>(A);
+		int off = K.Offset();
+		const int* pp = K.Pointers();
+		const int* pi = K.Indices();
+		for (int i = 0; i <= N; ++i) m_ptr[i] = pp[i] - off;
+
+		int nnz = m_ptr[N];
+		m_col.resize(nnz);
+		m_src.resize(nnz);
+		for (int k = 0; k < nnz; ++k)
+		{
+			m_col[k] = pi[k] - off;
+			m_src[k] = k;
+		}
+	}
+	else if (dynamic_cast<CCSSparseMatrix*>(A))
+	{
+		// transpose the column structure
+		CCSSparseMatrix& K = *dynamic_cast<CCSSparseMatrix*>(A);
+		int off = K.Offset();
+		const int* pp = K.Pointers();
+		const int* pi = K.Indices();
+		int nnz = pp[N] - off;
+		for (int k = 0; k < nnz; ++k) m_ptr[pi[k] - off + 1]++;
+		for (int i = 0; i < N; ++i) m_ptr[i + 1] += m_ptr[i];
+
+		m_col.resize(nnz);
+		m_src.resize(nnz);
+		std::vector<int> pos(m_ptr.begin(), m_ptr.end() - 1);
+		for (int j = 0; j < N; ++j)
+		{
+			for (int k = pp[j] - off; k < pp[j + 1] - off; ++k)
+			{
+				int n = pos[pi[k] - off]++;
+				m_col[n] = j;
+				m_src[n] = k;
+			}
+		}
+	}
+	else if (dynamic_cast<BSRMatrix*>(A))
+	{
+		// expand the blocks, skipping the padded slots
+		BSRMatrix& K = *dynamic_cast<BSRMatrix*>(A);
+		const int BS = BSRMatrix::BS;
+		const std::vector<int>& bp = K.BlockPointers();
+		const std::vector<int>& bc = K.BlockIndices();
+		const std::vector<int>& beq = K.BlockEquations();
+		const std::vector<int>& slot = K.EquationSlots();
+		for (int i = 0; i < N; ++i)
+		{
+			int bi = slot[i] / BS;
+			for (int k = bp[bi]; k < bp[bi + 1]; ++k)
+			{
+				for (int c = 0; c < BS; ++c) if (beq[bc[k] * BS + c] >= 0) m_ptr[i + 1]++;
+			}
+		}
+		for (int i = 0; i < N; ++i) m_ptr[i + 1] += m_ptr[i];
+
+		int nnz = m_ptr[N];
+		m_col.resize(nnz);
+		m_src.resize(nnz);
+		std::vector< std::pair<int, int> > row;
+		for (int i = 0; i < N; ++i)
+		{
+			int si = slot[i];
+			int bi = si / BS;
+			row.clear();
+			for (int k = bp[bi]; k < bp[bi + 1]; ++k)
+			{
+				for (int c = 0; c < BS; ++c)
+				{
+					int j = beq[bc[k] * BS + c];
+					if (j >= 0) row.push_back(std::make_pair(j, k*BS*BS + (si % BS)*BS + c));
+				}
+			}
+
+			// the slots need not follow the equation order, so sort the columns
+			std::sort(row.begin(), row.end());
+			int n = m_ptr[i];
+			for (int k = 0; k < (int)row.size(); ++k, ++n)
+			{
+				m_col[n] = row[k].first;
+				m_src[n] = row[k].second;
+			}
+		}
+
+		// the products are done with the block matrix
+		m_bsr = &K;
+	}
+	else return false;
+
+	// find the diagonals
+	m_diag.assign(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		for (int k = m_ptr[i]; k < m_ptr[i + 1]; ++k)
+		{
+			if (m_col[k] == i) { m_diag[i] = k; break; }
+		}
+	}
+
+	m_A = A;
+	m_nrows = N;
+	m_val.resize(m_col.size());
+	Update();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void CSRView::Assign(int nrows, std::vector<int>& ptr, std::vector<int>& col, std::vector<double>& val)
+{
+	Clear();
+	m_nrows = nrows;
+	m_ptr.swap(ptr);
+	m_col.swap(col);
+	m_val.swap(val);
+
+	m_diag.assign(nrows, -1);
+#pragma omp parallel for schedule(static, 512)
+	for (int i = 0; i < nrows; ++i)
+	{
+		for (int k = m_ptr[i]; k < m_ptr[i + 1]; ++k)
+		{
+			if (m_col[k] == i) { m_diag[i] = k; break; }
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void CSRView::Update()
+{
+	if (m_A == nullptr) return;
+	const double* pv = m_A->Values();
+	int nnz = (int)m_val.size();
+#pragma omp parallel for schedule(static)
+	for (int k = 0; k < nnz; ++k) m_val[k] = pv[m_src[k]];
+}
+
+//-----------------------------------------------------------------------------
+void CSRView::Multiply(const double* x, double* y) const
+{
+	if (m_bsr) { m_bsr->Multiply(x, y); return; }
+
+	const int* ptr = m_ptr.data();
+	const int* col = m_col.data();
+	const double* val = m_val.data();
+	int N = m_nrows;
+#pragma omp parallel for schedule(static, 512)
+	for (int i = 0; i < N; ++i)
+	{
+		double yi = 0.0;
+		for (int k = ptr[i]; k < ptr[i + 1]; ++k) yi += val[k] * x[col[k]];
+		y[i] = yi;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void CSRView::Residual(const double* x, const double* b, double* r) const
+{
+	if (m_bsr)
+	{
+		m_bsr->Multiply(x, r);
+		int N = m_nrows;
+#pragma omp parallel for schedule(static, 512)
+		for (int i = 0; i < N; ++i) r[i] = b[i] - r[i];
+		return;
+	}
+
+	const int* ptr = m_ptr.data();
+	const int* col = m_col.data();
+	const double* val = m_val.data();
+	int N = m_nrows;
+#pragma omp parallel for schedule(static, 512)
+	for (int i = 0; i < N; ++i)
+	{
+		double ri = b[i];
+		for (int k = ptr[i]; k < ptr[i + 1]; ++k) ri -= val[k] * x[col[k]];
+		r[i] = ri;
+	}
+}
+
+//=============================================================================
+void LevelSchedule::Create(int nrows, const int* ptr, const int* ind, int offset, bool lower)
+{
+	// the level of a row is one more than the highest level of the rows it depends on
+	std::vector<int> level(nrows, 0);
+	int maxLevel = -1;
+	for (int n = 0; n < nrows; ++n)
+	{
+		int i = (lower ? n : nrows - 1 - n);
+		int l = 0;
+		for (int k = ptr[i] - offset; k < ptr[i + 1] - offset; ++k)
+		{
+			int j = ind[k] - offset;
+			if ((lower && (j < i)) || (!lower && (j > i)))
+			{
+				if (level[j] + 1 > l) l = level[j] + 1;
+			}
+		}
+		level[i] = l;
+		if (l > maxLevel) maxLevel = l;
+	}
+
+	// sort the rows by level
+	m_lev.assign(maxLevel + 2, 0);
+	for (int i = 0; i < nrows; ++i) m_lev[level[i] + 1]++;
+	for (int l = 0; l <= maxLevel; ++l) m_lev[l + 1] += m_lev[l];
+
+	m_row.resize(nrows);
+	std::vector<int> pos(m_lev.begin(), m_lev.end() - 1);
+	for (int n = 0; n < nrows; ++n)
+	{
+		int i = (lower ? n : nrows - 1 - n);
+		m_row[pos[level[i]]++] = i;
+	}
+}
+
+//=============================================================================
+void NumCore::triangularSolve(const CSRView& A, const double* val, const LevelSchedule& S, const double* invDiag, bool lower, const double* b, double* x)
+{
+	const int* ptr = A.m_ptr.data();
+	const int* col = A.m_col.data();
+	const int* diag = A.m_diag.data();
+	const int* lev = S.m_lev.data();
+	const int* row = S.m_row.data();
+	int nlev = S.Levels();
+	int N = A.Rows();
+
+	// Only go parallel when the levels are wide enough to amortize the barriers.
+#pragma omp parallel if (N >= 64*nlev)
+	{
+		for (int l = 0; l < nlev; ++l)
+		{
+#pragma omp for schedule(static)
+			for (int n = lev[l]; n < lev[l + 1]; ++n)
+			{
+				int i = row[n];
+				double xi = b[i];
+				int k0 = (lower ? ptr[i] : diag[i] + 1);
+				int k1 = (lower ? diag[i] : ptr[i + 1]);
+				for (int k = k0; k < k1; ++k) xi -= val[k] * x[col[k]];
+				x[i] = (invDiag ? xi * invDiag[i] : xi);
+			}
+		}
+	}
+}
+
+//=============================================================================
+double NumCore::dotProduct(int n, const double* a, const double* b)
+{
+	double s = 0.0;
+#pragma omp parallel for reduction(+:s) schedule(static)
+	for (int i = 0; i < n; ++i) s += a[i] * b[i];
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+double NumCore::norm2(int n, const double* a)
+{
+	return sqrt(dotProduct(n, a, a));
+}
+
+//-----------------------------------------------------------------------------
+void NumCore::axpy(int n, double a, const double* x, double* y)
+{
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) y[i] += a * x[i];
+}
+
+//-----------------------------------------------------------------------------
+void NumCore::xpay(int n, const double* x, double a, double* y)
+{
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) y[i] = x[i] + a * y[i];
+}
+
+//-----------------------------------------------------------------------------
+void NumCore::copyVector(int n, const double* x, double* y)
+{
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) y[i] = x[i];
+}
@@ -0,0 +1,140 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include "numcore_api.h"
+
+class SparseMatrix;
+class BSRMatrix;
+
+namespace NumCore
+{
+	//-------------------------------------------------------------------------
+	//! Zero-based, row-oriented (CSR) view of a sparse matrix. 
+	
+	//! Symmetric matrices that only store their lower triangular part are expanded
+	//! so that each row holds the full set of nonzeroes. The view keeps a map to the
+	//! values of the original matrix, so after the structure was created the values 
+	//! can be refreshed with Update() without reprocessing the sparsity pattern.
+	//! This is the common format for the native Krylov solvers and preconditioners.
+	class NUMCORE_API CSRView
+	{
+	public:
+		CSRView();
+
+		//! build the view from a CompactSymmMatrix, CRSSparseMatrix, CCSSparseMatrix or BSRMatrix.
+		//! For a BSRMatrix, the products are done with the (faster) block format. If productsOnly
+		//! is true, the scalar arrays of a BSRMatrix are not created, since they are only needed 
+		//! by preconditioners that access the individual entries (e.g. ILU, IC, AMG).
+		bool Create(SparseMatrix* A, bool productsOnly = false);
+
+		//! Take over an existing CSR structure (e.g. a matrix created by a sparse matrix product).
+		//! The arrays are swapped into the view, which will not be linked to a SparseMatrix.
+		void Assign(int nrows, std::vector<int>& ptr, std::vector<int>& col, std::vector<double>& val);
+
+		//! copy the values from the matrix that was used to create the view
+		void Update();
+
+		//! release all data
+		void Clear();
+
+		//! nr of rows
+		int Rows() const { return m_nrows; }
+
+		//! nr of nonzeroes (of the expanded matrix)
+		int NonZeroes() const { return (int)m_col.size(); }
+
+		//! calculate y = A*x (parallel)
+		void Multiply(const double* x, double* y) const;
+
+		//! calculate the residual r = b - A*x (parallel)
+		void Residual(const double* x, const double* b, double* r) const;
+
+	public:
+		std::vector<int>	m_ptr;		//!< start of each row
+		std::vector<int>	m_col;		//!< column indices (sorted per row)
+		std::vector<int>	m_diag;		//!< position of diagonal in each row (-1 if not present)
+		std::vector<double>	m_val;		//!< values
+
+	private:
+		SparseMatrix*		m_A;
+		const BSRMatrix*	m_bsr;		//!< block matrix used for the products (if any)
+		int					m_nrows;
+		std::vector<int>	m_src;		//!< position of each value in the original matrix
+	};
+
+	//-------------------------------------------------------------------------
+	//! Level schedule of a sparse triangular matrix.
+
+	//! Rows are grouped in levels such that a row only depends on rows of previous
+	//! levels. All rows of one level can therefore be processed in parallel during
+	//! a triangular solve (or an incomplete factorization). 
+	class NUMCORE_API LevelSchedule
+	{
+	public:
+		LevelSchedule() {}
+
+		//! Build the schedule from a row structure. For lower == true, row i
+		//! depends on all rows j < i in its row, otherwise on all rows j > i. 
+		void Create(int nrows, const int* ptr, const int* ind, int offset, bool lower);
+
+		//! nr of levels
+		int Levels() const { return (m_lev.empty() ? 0 : (int)m_lev.size() - 1); }
+
+	public:
+		std::vector<int>	m_lev;		//!< start of each level in m_row
+		std::vector<int>	m_row;		//!< rows, ordered by level
+	};
+
+	//-------------------------------------------------------------------------
+	//! Solve a triangular system that is stored in the lower (or upper) part of the 
+	//! structure of A, with the values taken from val (which has the same layout as A.m_val).
+	//! The off-diagonal entries are used as is and the result is scaled by invDiag.
+	//! If invDiag is null, the diagonal is assumed to be one. The rows are processed
+	//! level by level using the schedule S, which must match the triangle. 
+	NUMCORE_API void triangularSolve(const CSRView& A, const double* val, const LevelSchedule& S, const double* invDiag, bool lower, const double* b, double* x);
+
+	//-------------------------------------------------------------------------
+	// parallel vector operations used by the native iterative solvers
+
+	//! returns a.b
+	NUMCORE_API double dotProduct(int n, const double* a, const double* b);
+
+	//! returns |a| (2-norm)
+	NUMCORE_API double norm2(int n, const double* a);
+
+	//! y = y + a*x
+	NUMCORE_API void axpy(int n, double a, const double* x, double* y);
+
+	//! y = x + a*y
+	NUMCORE_API void xpay(int n, const double* x, double a, double* y);
+
+	//! y = x
+	NUMCORE_API void copyVector(int n, const double* x, double* y);
+}
@@ -0,0 +1,573 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SparseOrdering.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <algorithm>
+using namespace std;
+
+namespace NumCore {
+
+//-----------------------------------------------------------------------------
+SparseGraph::SparseGraph()
+{
+	m_neq = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Build the graph of a symmetric matrix. Only the lower triangular part is stored
+// in the matrix, so both (i,j) and (j,i) are added to the adjacency lists.
+void SparseGraph::Create(CompactSymmMatrix& A, bool compress)
+{
+	int neq = A.Rows();
+	int offset = A.Offset();
+	const int* pointers = A.Pointers();
+	const int* indices = A.Indices();
+	m_neq = neq;
+
+	// the full (equation) adjacency, without the diagonal
+	vector<int> xadj(neq + 1, 0);
+	for (int j = 0; j < neq; ++j)
+	{
+		for (int k = pointers[j] - offset; k < pointers[j + 1] - offset; ++k)
+		{
+			int i = indices[k] - offset;
+			if (i != j) { xadj[i + 1]++; xadj[j + 1]++; }
+		}
+	}
+	for (int i = 0; i < neq; ++i) xadj[i + 1] += xadj[i];
+	vector<int> adj(xadj[neq]);
+	vector<int> pos(xadj.begin(), xadj.end() - 1);
+	for (int j = 0; j < neq; ++j)
+	{
+		for (int k = pointers[j] - offset; k < pointers[j + 1] - offset; ++k)
+		{
+			int i = indices[k] - offset;
+			if (i != j) { adj[pos[i]++] = j; adj[pos[j]++] = i; }
+		}
+	}
+
+	// Find the equations that have the same adjacency (including themselves).
+	// Since the lists are sorted, we first sort the equations by a hash key and
+	// then compare the lists of equations with the same key.
+	vector<int> rep(neq);
+	for (int i = 0; i < neq; ++i) rep[i] = i;
+	if (compress)
+	{
+		vector<unsigned long long> key(neq);
+		for (int i = 0; i < neq; ++i)
+		{
+			unsigned long long h = i;
+			for (int k = xadj[i]; k < xadj[i + 1]; ++k) h += adj[k];
+			key[i] = h;
+		}
+
+		vector<int> eq(neq);
+		for (int i = 0; i < neq; ++i) eq[i] = i;
+		sort(eq.begin(), eq.end(), [&](int a, int b) {
+			if (key[a] != key[b]) return key[a] < key[b];
+			return a < b;
+		});
+
+		vector<int> tag(neq, -1);
+		for (int n0 = 0; n0 < neq; )
+		{
+			int n1 = n0 + 1;
+			while ((n1 < neq) && (key[eq[n1]] == key[eq[n0]])) n1++;
+			for (int a = n0; a < n1; ++a)
+			{
+				int i = eq[a];
+				if (rep[i] != i) continue;
+				int di = xadj[i + 1] - xadj[i];
+				bool marked = false;
+				for (int b = a + 1; b < n1; ++b)
+				{
+					int j = eq[b];
+					if ((rep[j] != j) || (xadj[j + 1] - xadj[j] != di)) continue;
+
+					// mark the closed neighborhood of i
+					if (marked == false)
+					{
+						tag[i] = i;
+						for (int k = xadj[i]; k < xadj[i + 1]; ++k) tag[adj[k]] = i;
+						marked = true;
+					}
+
+					bool same = (tag[j] == i);
+					for (int k = xadj[j]; same && (k < xadj[j + 1]); ++k)
+					{
+						if (tag[adj[k]] != i) same = false;
+					}
+					if (same) rep[j] = i;
+				}
+			}
+			n0 = n1;
+		}
+	}
+
+	// number the vertices in the order of their first equation
+	vector<int> vert(neq, -1);
+	int nv = 0;
+	for (int i = 0; i < neq; ++i)
+	{
+		if (rep[i] == i) vert[i] = nv++;
+	}
+	for (int i = 0; i < neq; ++i) vert[i] = vert[rep[i]];
+
+	// equations of each vertex
+	m_wgt.assign(nv, 0);
+	for (int i = 0; i < neq; ++i) m_wgt[vert[i]]++;
+	m_peq.assign(nv + 1, 0);
+	for (int v = 0; v < nv; ++v) m_peq[v + 1] = m_peq[v] + m_wgt[v];
+	m_veq.resize(neq);
+	for (int v = 0; v < nv; ++v) pos[v] = m_peq[v];
+	for (int i = 0; i < neq; ++i) m_veq[pos[vert[i]]++] = i;
+
+	// the vertex adjacency follows from the adjacency of the first equation
+	vector<int> tag(nv, -1);
+	m_xadj.assign(nv + 1, 0);
+	m_adj.clear();
+	m_adj.reserve(nv == neq ? adj.size() : adj.size() / 4);
+	for (int v = 0; v < nv; ++v)
+	{
+		int i = m_veq[m_peq[v]];
+		tag[v] = v;
+		for (int k = xadj[i]; k < xadj[i + 1]; ++k)
+		{
+			int w = vert[adj[k]];
+			if (tag[w] != v)
+			{
+				tag[w] = v;
+				m_adj.push_back(w);
+			}
+		}
+		m_xadj[v + 1] = (int)m_adj.size();
+	}
+}
+
+//-----------------------------------------------------------------------------
+void SparseGraph::Create(int nverts, const vector<int>& xadj, const vector<int>& adj, const vector<int>& wgt)
+{
+	m_xadj = xadj;
+	m_adj = adj;
+	m_wgt = wgt;
+	if (m_wgt.empty()) m_wgt.assign(nverts, 1);
+
+	// equations are numbered consecutively
+	m_peq.assign(nverts + 1, 0);
+	for (int i = 0; i < nverts; ++i) m_peq[i + 1] = m_peq[i] + m_wgt[i];
+	m_neq = m_peq[nverts];
+	m_veq.resize(m_neq);
+	for (int i = 0; i < m_neq; ++i) m_veq[i] = i;
+}
+
+//-----------------------------------------------------------------------------
+void SparseGraph::ExpandOrdering(const vector<int>& vperm, vector<int>& perm) const
+{
+	perm.clear();
+	perm.reserve(m_neq);
+	for (size_t k = 0; k < vperm.size(); ++k)
+	{
+		int v = vperm[k];
+		for (int i = m_peq[v]; i < m_peq[v + 1]; ++i) perm.push_back(m_veq[i]);
+	}
+}
+
+//=============================================================================
+// Minimum degree
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// Doubly-linked lists of the variables with the same degree.
+class DegreeLists
+{
+public:
+	DegreeLists(int nverts, int maxdeg) : m_head(maxdeg + 1, -1), m_next(nverts, -1), m_prev(nverts, -1), m_deg(nverts, 0) { m_min = 0; }
+
+	void Insert(int i, int d)
+	{
+		m_deg[i] = d;
+		m_prev[i] = -1;
+		m_next[i] = m_head[d];
+		if (m_head[d] >= 0) m_prev[m_head[d]] = i;
+		m_head[d] = i;
+		if (d < m_min) m_min = d;
+	}
+
+	void Remove(int i)
+	{
+		if (m_prev[i] >= 0) m_next[m_prev[i]] = m_next[i]; else m_head[m_deg[i]] = m_next[i];
+		if (m_next[i] >= 0) m_prev[m_next[i]] = m_prev[i];
+	}
+
+	// remove and return a variable of minimum degree
+	int PopMin()
+	{
+		while (m_head[m_min] < 0) m_min++;
+		int i = m_head[m_min];
+		Remove(i);
+		return i;
+	}
+
+private:
+	vector<int>	m_head, m_next, m_prev, m_deg;
+	int			m_min;
+};
+
+//-----------------------------------------------------------------------------
+// This implements the minimum degree algorithm on the quotient graph. Eliminated
+// variables become elements, which represent the cliques that are created in the
+// factor. The degrees of the variables adjacent to the pivot are replaced by the 
+// approximate external degree of Amestoy, Davis and Duff, which is an upper bound
+// that is much cheaper to evaluate than the true degree.
+void MinimumDegreeOrdering(const SparseGraph& G, vector<int>& perm)
+{
+	enum { VARIABLE, ELEMENT, ABSORBED };
+
+	const int n = G.Vertices();
+	perm.clear();
+	if (n == 0) return;
+	perm.reserve(n);
+
+	// the quotient graph
+	vector< vector<int> > A(n);		// variables adjacent to a variable
+	vector< vector<int> > E(n);		// elements adjacent to a variable
+	vector< vector<int> > L(n);		// variables of an element
+	vector<int> nv(n), state(n, VARIABLE);
+	int wtot = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		A[i].assign(G.Neighbors(i), G.Neighbors(i) + G.Degree(i));
+		nv[i] = G.Weight(i);
+		wtot += nv[i];
+	}
+
+	DegreeLists Q(n, wtot);
+	for (int i = 0; i < n; ++i)
+	{
+		int d = 0;
+		for (int j : A[i]) d += nv[j];
+		Q.Insert(i, d);
+	}
+
+	vector<int> mark(n, -1), wtag(n, -1), we(n, 0);
+	vector<int> Lp;
+	int remaining = wtot;
+	for (int step = 0; step < n; ++step)
+	{
+		// pick the pivot
+		int p = Q.PopMin();
+		perm.push_back(p);
+		remaining -= nv[p];
+
+		// the new element is the union of the pivot's variables and the
+		// variables of its elements, which are absorbed
+		Lp.clear();
+		mark[p] = step;
+		for (int j : A[p])
+		{
+			if ((state[j] == VARIABLE) && (mark[j] != step)) { mark[j] = step; Lp.push_back(j); }
+		}
+		for (int e : E[p])
+		{
+			if (state[e] != ELEMENT) continue;
+			for (int j : L[e])
+			{
+				if ((state[j] == VARIABLE) && (mark[j] != step)) { mark[j] = step; Lp.push_back(j); }
+			}
+			state[e] = ABSORBED;
+			vector<int>().swap(L[e]);
+		}
+		state[p] = ELEMENT;
+		L[p] = Lp;
+		vector<int>().swap(A[p]);
+		vector<int>().swap(E[p]);
+
+		int wp = 0;
+		for (int j : Lp) wp += nv[j];
+
+		// calculate |Le \ Lp| for all elements adjacent to Lp
+		for (int i : Lp)
+		{
+			for (int e : E[i])
+			{
+				if (state[e] != ELEMENT) continue;
+				if (wtag[e] != step)
+				{
+					// prune the element's variable list while we're at it
+					vector<int>& Le = L[e];
+					int m = 0, w = 0;
+					for (int j : Le) if (state[j] == VARIABLE) { Le[m++] = j; w += nv[j]; }
+					Le.resize(m);
+					we[e] = w;
+					wtag[e] = step;
+				}
+				we[e] -= nv[i];
+			}
+		}
+
+		// update the variables of the new element
+		for (int i : Lp)
+		{
+			Q.Remove(i);
+
+			int d = wp - nv[i];
+
+			// Elements that are contained in Lp are absorbed by p
+			vector<int>& Ei = E[i];
+			int m = 0;
+			for (int e : Ei)
+			{
+				if (state[e] != ELEMENT) continue;
+				if (we[e] <= 0)
+				{
+					state[e] = ABSORBED;
+					vector<int>().swap(L[e]);
+				}
+				else
+				{
+					Ei[m++] = e;
+					d += we[e];
+				}
+			}
+			Ei.resize(m);
+			Ei.push_back(p);
+
+			// variables in Lp are now reached through p
+			vector<int>& Ai = A[i];
+			m = 0;
+			for (int j : Ai)
+			{
+				if ((state[j] == VARIABLE) && (mark[j] != step)) { Ai[m++] = j; d += nv[j]; }
+			}
+			Ai.resize(m);
+
+			int dmax = remaining - nv[i];
+			if (d > dmax) d = dmax;
+			Q.Insert(i, d);
+		}
+	}
+}
+
+//=============================================================================
+// Nested dissection
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// Breadth-first search from vertex v0 in the subgraph of vertices with label lbl.
+// On return, level[] holds the level of each visited vertex and order lists the
+// vertices in the order that they were visited. Returns the number of levels.
+static int level_structure(const SparseGraph& G, int v0, int lbl, const vector<int>& label, vector<int>& level, vector<int>& order)
+{
+	order.clear();
+	order.push_back(v0);
+	level[v0] = 0;
+	int nlevels = 1;
+	for (size_t k = 0; k < order.size(); ++k)
+	{
+		int v = order[k];
+		const int* nbr = G.Neighbors(v);
+		for (int j = 0; j < G.Degree(v); ++j)
+		{
+			int w = nbr[j];
+			if ((label[w] == lbl) && (level[w] < 0))
+			{
+				level[w] = level[v] + 1;
+				if (level[w] + 1 > nlevels) nlevels = level[w] + 1;
+				order.push_back(w);
+			}
+		}
+	}
+	return nlevels;
+}
+
+//-----------------------------------------------------------------------------
+// Split the subgraph V in two parts A, B and a separator S, such that no edges
+// connect A and B. The separator is a level of a rooted level structure, where the
+// root is a pseudo-peripheral vertex. Returns false if no good split exists.
+static bool bisect(const SparseGraph& G, const vector<int>& V, const vector<int>& label, vector<int>& level, vector<int>& A, vector<int>& B, vector<int>& S)
+{
+	int lbl = label[V[0]];
+	A.clear(); B.clear(); S.clear();
+
+	vector<int> order;
+	for (int v : V) level[v] = -1;
+	int nlev = level_structure(G, V[0], lbl, label, level, order);
+
+	// if the subgraph is not connected, we split off the first component
+	if (order.size() < V.size())
+	{
+		for (int v : V)
+		{
+			if (level[v] >= 0) A.push_back(v); else B.push_back(v);
+		}
+		return true;
+	}
+
+	// find a pseudo-peripheral vertex
+	for (int iter = 0; iter < 5; ++iter)
+	{
+		// the vertex of minimum degree in the last level
+		int vmin = order.back(), dmin = G.Degree(vmin);
+		for (int k = (int)order.size() - 1; (k >= 0) && (level[order[k]] == nlev - 1); --k)
+		{
+			int v = order[k];
+			if (G.Degree(v) < dmin) { dmin = G.Degree(v); vmin = v; }
+		}
+
+		for (int v : V) level[v] = -1;
+		int nl = level_structure(G, vmin, lbl, label, level, order);
+		if (nl <= nlev) { nlev = nl; break; }
+		nlev = nl;
+	}
+	if (nlev < 3) return false;
+
+	// weight of each level
+	vector<int> wl(nlev, 0);
+	int wtot = 0;
+	for (int v : V) { wl[level[v]] += G.Weight(v); wtot += G.Weight(v); }
+
+	// Among the levels that give a reasonably balanced split, pick the smallest one.
+	// If there are none, we take the level that contains the median vertex.
+	int sep = -1, wbelow = wl[0], smed = -1;
+	for (int l = 1; l < nlev - 1; ++l)
+	{
+		int wabove = wtot - wbelow - wl[l];
+		if ((smed < 0) && (wbelow + wl[l] >= wtot / 2)) smed = l;
+		if ((wbelow >= 0.3*(wbelow + wabove)) && (wabove >= 0.3*(wbelow + wabove)))
+		{
+			if ((sep < 0) || (wl[l] < wl[sep])) sep = l;
+		}
+		wbelow += wl[l];
+	}
+	if (sep < 0) sep = (smed < 0 ? nlev - 2 : smed);
+
+	// Separator vertices that are not connected to the level above can be moved down.
+	for (int v : V)
+	{
+		int l = level[v];
+		if (l < sep) A.push_back(v);
+		else if (l > sep) B.push_back(v);
+		else
+		{
+			bool bsep = false;
+			const int* nbr = G.Neighbors(v);
+			for (int j = 0; j < G.Degree(v); ++j)
+			{
+				int w = nbr[j];
+				if ((label[w] == lbl) && (level[w] == sep + 1)) { bsep = true; break; }
+			}
+			if (bsep) S.push_back(v); else A.push_back(v);
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// order the subgraph V with minimum degree and store the result in perm[start...]
+static void order_leaf(const SparseGraph& G, const vector<int>& V, const vector<int>& label, vector<int>& loc, vector<int>& perm, int start)
+{
+	int lbl = label[V[0]];
+	int nv = (int)V.size();
+	for (int i = 0; i < nv; ++i) loc[V[i]] = i;
+
+	vector<int> xadj(nv + 1, 0), adj, wgt(nv);
+	for (int i = 0; i < nv; ++i)
+	{
+		int v = V[i];
+		const int* nbr = G.Neighbors(v);
+		for (int j = 0; j < G.Degree(v); ++j)
+		{
+			if (label[nbr[j]] == lbl) adj.push_back(loc[nbr[j]]);
+		}
+		xadj[i + 1] = (int)adj.size();
+		wgt[i] = G.Weight(v);
+	}
+
+	SparseGraph Gl;
+	Gl.Create(nv, xadj, adj, wgt);
+	vector<int> lperm;
+	MinimumDegreeOrdering(Gl, lperm);
+	for (int i = 0; i < nv; ++i) perm[start + i] = V[lperm[i]];
+}
+
+//-----------------------------------------------------------------------------
+// In nested dissection, the graph is split recursively by small separators. The 
+// separator is numbered after the two parts, so no fill is created between them.
+void NestedDissectionOrdering(const SparseGraph& G, vector<int>& perm, int leafSize)
+{
+	int n = G.Vertices();
+	perm.assign(n, -1);
+	if (n == 0) return;
+
+	// Each subgraph has a unique label. Separator vertices are labeled -1.
+	vector<int> label(n, 0), level(n, -1), loc(n, -1);
+	int nextLabel = 1;
+
+	struct SUBGRAPH
+	{
+		vector<int>	verts;
+		int			start;	// position of the first vertex in the permutation
+	};
+	vector<SUBGRAPH> stack(1);
+	stack[0].verts.resize(n);
+	for (int i = 0; i < n; ++i) stack[0].verts[i] = i;
+	stack[0].start = 0;
+
+	vector<int> A, B, S;
+	while (stack.empty() == false)
+	{
+		SUBGRAPH sg;
+		sg.verts.swap(stack.back().verts);
+		sg.start = stack.back().start;
+		stack.pop_back();
+
+		if (((int)sg.verts.size() <= leafSize) || (bisect(G, sg.verts, label, level, A, B, S) == false))
+		{
+			order_leaf(G, sg.verts, label, loc, perm, sg.start);
+			continue;
+		}
+
+		// the separator is numbered last
+		int la = nextLabel++, lb = nextLabel++;
+		for (int v : A) label[v] = la;
+		for (int v : B) label[v] = lb;
+		int ns = sg.start + (int)(A.size() + B.size());
+		for (size_t i = 0; i < S.size(); ++i) { label[S[i]] = -1; perm[ns + i] = S[i]; }
+
+		SUBGRAPH sa, sb;
+		sb.start = sg.start + (int)A.size(); sb.verts = B;
+		sa.start = sg.start; sa.verts = A;
+		if (B.empty() == false) stack.push_back(sb);
+		if (A.empty() == false) stack.push_back(sa);
+	}
+}
+
+} // namespace NumCore
@@ -0,0 +1,91 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include "numcore_api.h"
+
+class CompactSymmMatrix;
+
+namespace NumCore
+{
+	//-------------------------------------------------------------------------
+	//! Adjacency graph of a symmetric sparse matrix. Equations with identical
+	//! sparsity patterns (e.g. the degrees of freedom of a node) are collapsed
+	//! into a single weighted vertex, which makes the orderings below a lot
+	//! cheaper without affecting their quality.
+	class NUMCORE_API SparseGraph
+	{
+	public:
+		SparseGraph();
+
+		//! build the graph from the lower triangular part of a symmetric matrix
+		void Create(CompactSymmMatrix& A, bool compress = true);
+
+		//! build the graph from a (symmetric) adjacency list without self-loops
+		void Create(int nverts, const std::vector<int>& xadj, const std::vector<int>& adj, const std::vector<int>& wgt);
+
+		//! number of vertices
+		int Vertices() const { return (int)m_xadj.size() - 1; }
+
+		//! number of equations
+		int Equations() const { return m_neq; }
+
+		//! nr of neighbors of vertex i
+		int Degree(int i) const { return m_xadj[i + 1] - m_xadj[i]; }
+
+		//! neighbors of vertex i
+		const int* Neighbors(int i) const { return &m_adj[0] + m_xadj[i]; }
+
+		//! weight (nr of equations) of vertex i
+		int Weight(int i) const { return m_wgt[i]; }
+
+		//! Convert a vertex permutation into an equation permutation.
+		//! The vertex permutation lists the vertices in elimination order.
+		void ExpandOrdering(const std::vector<int>& vperm, std::vector<int>& perm) const;
+
+	public:
+		std::vector<int>	m_xadj;	//!< start of adjacency list for each vertex
+		std::vector<int>	m_adj;	//!< adjacency lists
+		std::vector<int>	m_wgt;	//!< vertex weights
+
+	private:
+		int					m_neq;	//!< total nr of equations
+		std::vector<int>	m_veq;	//!< equations of each vertex (ordered by vertex)
+		std::vector<int>	m_peq;	//!< start of equation list for each vertex
+	};
+
+	//! Approximate minimum degree ordering. On return, perm[k] is the vertex
+	//! that is eliminated in step k.
+	NUMCORE_API void MinimumDegreeOrdering(const SparseGraph& G, std::vector<int>& perm);
+
+	//! Nested dissection ordering based on level-structure separators.
+	//! Subgraphs smaller than leafSize vertices are ordered with minimum degree.
+	NUMCORE_API void NestedDissectionOrdering(const SparseGraph& G, std::vector<int>& perm, int leafSize = 128);
+
+} // namespace NumCore
@@ -0,0 +1,822 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SupernodalSolver.h"
+#include "SparseOrdering.h"
+#include <FECore/log.h>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Build the pattern of the permuted matrix P*A*P^T. For each column, the upper
+// lists store the row indices above the diagonal and the lower lists the row 
+// indices below the diagonal.
+static void permuted_pattern(int n, int offset, const int* Ap, const int* Ai, const vector<int>& iperm, vector<int>& Up, vector<int>& Ui, vector<int>& Lp, vector<int>& Li)
+{
+	Up.assign(n + 1, 0);
+	Lp.assign(n + 1, 0);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = Ap[j] - offset; k < Ap[j + 1] - offset; ++k)
+		{
+			int i = Ai[k] - offset;
+			if (i == j) continue;
+			int a = iperm[i], b = iperm[j];
+			Up[max(a, b) + 1]++;
+			Lp[min(a, b) + 1]++;
+		}
+	}
+	for (int i = 0; i < n; ++i) { Up[i + 1] += Up[i]; Lp[i + 1] += Lp[i]; }
+	Ui.resize(Up[n]);
+	Li.resize(Lp[n]);
+
+	vector<int> pu(Up.begin(), Up.end() - 1), pl(Lp.begin(), Lp.end() - 1);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = Ap[j] - offset; k < Ap[j + 1] - offset; ++k)
+		{
+			int i = Ai[k] - offset;
+			if (i == j) continue;
+			int a = iperm[i], b = iperm[j];
+			int lo = min(a, b), hi = max(a, b);
+			Ui[pu[hi]++] = lo;
+			Li[pl[lo]++] = hi;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Elimination tree (Liu's algorithm with path compression)
+static void elimination_tree(int n, const vector<int>& Up, const vector<int>& Ui, vector<int>& parent)
+{
+	parent.assign(n, -1);
+	vector<int> ancestor(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		for (int p = Up[k]; p < Up[k + 1]; ++p)
+		{
+			int i = Ui[p];
+			while ((i != -1) && (i < k))
+			{
+				int next = ancestor[i];
+				ancestor[i] = k;
+				if (next == -1) parent[i] = k;
+				i = next;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Postorder of a forest. On return, post[k] is the k-th node in postorder.
+static void postorder(int n, const vector<int>& parent, vector<int>& post)
+{
+	// child lists, in increasing order
+	vector<int> head(n, -1), next(n, -1);
+	for (int j = n - 1; j >= 0; --j)
+	{
+		if (parent[j] >= 0)
+		{
+			next[j] = head[parent[j]];
+			head[parent[j]] = j;
+		}
+	}
+
+	post.clear();
+	post.reserve(n);
+	vector<int> stack;
+	for (int r = 0; r < n; ++r)
+	{
+		if (parent[r] != -1) continue;
+		stack.push_back(r);
+		while (stack.empty() == false)
+		{
+			int j = stack.back();
+			int c = head[j];
+			if (c == -1)
+			{
+				post.push_back(j);
+				stack.pop_back();
+			}
+			else
+			{
+				head[j] = next[c];
+				stack.push_back(c);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(SupernodalSolver, LinearSolver)
+	ADD_PARAMETER(m_ordering  , "ordering")->setEnums("natural\0minimum degree\0nested dissection\0");
+	ADD_PARAMETER(m_printLevel, "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::SupernodalSolver(FEModel* fem) : LinearSolver(fem), m_pA(nullptr)
+{
+	m_ordering = 2;
+	m_printLevel = 0;
+	m_isFactored = false;
+	m_bsymbolic = false;
+	m_neq = 0;
+	m_maxRows = 0;
+}
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::~SupernodalSolver()
+{
+	Destroy();
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SupernodalSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// this solver only works with symmetric matrices
+	if (ntype != REAL_SYMMETRIC) return nullptr;
+	m_pA = new CompactSymmMatrix(0);
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	m_pA = dynamic_cast<CompactSymmMatrix*>(pA);
+	m_isFactored = false;
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::PreProcess()
+{
+	if (m_pA == nullptr) return false;
+
+	// The symbolic factorization is only redone when the profile changed,
+	// which is often not the case when the stiffness matrix is reformed.
+	if (SameProfile() == false)
+	{
+		if (Analyze() == false) return false;
+	}
+
+	return LinearSolver::PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SameProfile()
+{
+	if (m_bsymbolic == false) return false;
+
+	int n = m_pA->Rows();
+	if (n != m_neq) return false;
+	if (n == 0) return true;
+
+	int nnz = m_pA->NonZeroes();
+	if (nnz != (int)m_Ai.size()) return false;
+
+	if (memcmp(m_pA->Pointers(), &m_Ap[0], (n + 1) * sizeof(int)) != 0) return false;
+	if ((nnz > 0) && (memcmp(m_pA->Indices(), &m_Ai[0], nnz * sizeof(int)) != 0)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Analyze()
+{
+	CompactSymmMatrix& A = *m_pA;
+	int n = A.Rows();
+	int nnz = A.NonZeroes();
+	int offset = A.Offset();
+	const int* Ap = A.Pointers();
+	const int* Ai = A.Indices();
+
+	// store the profile, so we can check if it changed
+	m_bsymbolic = false;
+	m_isFactored = false;
+	m_neq = n;
+	m_Ap.assign(Ap, Ap + n + 1);
+	m_Ai.assign(Ai, Ai + nnz);
+	if (n == 0) { m_bsymbolic = true; return true; }
+
+	// fill-reducing ordering
+	vector<int> perm(n);
+	if (m_ordering == 0)
+	{
+		for (int i = 0; i < n; ++i) perm[i] = i;
+	}
+	else
+	{
+		NumCore::SparseGraph G;
+		G.Create(A);
+		vector<int> vperm;
+		if (m_ordering == 1) NumCore::MinimumDegreeOrdering(G, vperm);
+		else NumCore::NestedDissectionOrdering(G, vperm);
+		G.ExpandOrdering(vperm, perm);
+	}
+
+	// The elimination tree is postordered, so that each subtree (and in particular
+	// each supernode) is numbered consecutively.
+	vector<int> iperm(n), parent, post;
+	vector<int> Up, Ui, Lp, Li;
+	for (int k = 0; k < n; ++k) iperm[perm[k]] = k;
+	permuted_pattern(n, offset, Ap, Ai, iperm, Up, Ui, Lp, Li);
+	elimination_tree(n, Up, Ui, parent);
+	postorder(n, parent, post);
+
+	vector<int> tmp(n);
+	for (int k = 0; k < n; ++k) iperm[post[k]] = k;
+	for (int k = 0; k < n; ++k) tmp[k] = (parent[post[k]] < 0 ? -1 : iperm[parent[post[k]]]);
+	parent.swap(tmp);
+	for (int k = 0; k < n; ++k) tmp[k] = perm[post[k]];
+	perm.swap(tmp);
+	for (int k = 0; k < n; ++k) iperm[perm[k]] = k;
+	permuted_pattern(n, offset, Ap, Ai, iperm, Up, Ui, Lp, Li);
+	m_perm = perm;
+
+	// nr of off-diagonal entries in each column of L, by traversing the row subtrees
+	vector<int> cc(n, 0), mark(n, -1), nchild(n, 0);
+	for (int k = 0; k < n; ++k)
+	{
+		mark[k] = k;
+		for (int p = Up[k]; p < Up[k + 1]; ++p)
+		{
+			for (int i = Ui[p]; mark[i] != k; i = parent[i])
+			{
+				cc[i]++;
+				mark[i] = k;
+			}
+		}
+		if (parent[k] >= 0) nchild[parent[k]]++;
+	}
+
+	// fundamental supernodes: chains of columns with nested patterns
+	vector<int> fsn;
+	fsn.push_back(0);
+	for (int j = 1; j < n; ++j)
+	{
+		if ((parent[j - 1] != j) || (cc[j - 1] != cc[j] + 1) || (nchild[j] != 1)) fsn.push_back(j);
+	}
+	fsn.push_back(n);
+
+	// Relaxed amalgamation: a supernode is merged with its parent if that does 
+	// not introduce too many explicit zeroes. Larger supernodes are more efficient.
+	m_snFirst.clear();
+	{
+		int f = fsn[0], l = fsn[1] - 1;
+		double nc = l - f + 1, nz = 0;
+		for (int j = f; j <= l; ++j) nz += cc[j] + 1;
+		for (int t = 1; t < (int)fsn.size() - 1; ++t)
+		{
+			int tf = fsn[t], tl = fsn[t + 1] - 1;
+			double tnc = tl - tf + 1, tnr = cc[tf] + 1, tnz = 0;
+			for (int j = tf; j <= tl; ++j) tnz += cc[j] + 1;
+
+			bool bmerge = false;
+			if (parent[l] == tf)
+			{
+				double mnc = nc + tnc, mnr = nc + tnr, mnz = nz + tnz;
+				double z = 1.0 - mnz / (mnc*mnr - 0.5*mnc*(mnc - 1));
+				if ((mnc <= 4) || ((mnc <= 16) && (z < 0.8)) || ((mnc <= 48) && (z < 0.1)) || (z < 0.05))
+				{
+					bmerge = true;
+					l = tl; nc = mnc; nz = mnz;
+				}
+			}
+
+			if (bmerge == false)
+			{
+				m_snFirst.push_back(f);
+				f = tf; l = tl; nc = tnc; nz = tnz;
+			}
+		}
+		m_snFirst.push_back(f);
+		m_snFirst.push_back(n);
+	}
+	int nsn = (int)m_snFirst.size() - 1;
+
+	vector<int> col2sn(n);
+	for (int s = 0; s < nsn; ++s)
+	{
+		for (int j = m_snFirst[s]; j < m_snFirst[s + 1]; ++j) col2sn[j] = s;
+	}
+
+	// The row structure of a supernode is the union of the structure of its 
+	// columns in A and the structures of its children.
+	vector<int> snParent(nsn, -1), headChild(nsn, -1), nextChild(nsn, -1);
+	m_snRowPtr.assign(nsn + 1, 0);
+	m_snRows.clear();
+	m_snRows.reserve(2 * n);
+	for (int i = 0; i < n; ++i) mark[i] = -1;
+	m_maxRows = 0;
+	for (int s = 0; s < nsn; ++s)
+	{
+		int f = m_snFirst[s], l = m_snFirst[s + 1] - 1;
+		int n0 = (int)m_snRows.size();
+		for (int j = f; j <= l; ++j) { m_snRows.push_back(j); mark[j] = s; }
+
+		for (int j = f; j <= l; ++j)
+		{
+			for (int p = Lp[j]; p < Lp[j + 1]; ++p)
+			{
+				int i = Li[p];
+				if (mark[i] != s) { mark[i] = s; m_snRows.push_back(i); }
+			}
+		}
+
+		for (int c = headChild[s]; c >= 0; c = nextChild[c])
+		{
+			int nc = m_snFirst[c + 1] - m_snFirst[c];
+			for (int p = m_snRowPtr[c] + nc; p < m_snRowPtr[c + 1]; ++p)
+			{
+				int i = m_snRows[p];
+				if ((i > l) && (mark[i] != s)) { mark[i] = s; m_snRows.push_back(i); }
+			}
+		}
+
+		sort(m_snRows.begin() + n0 + (l - f + 1), m_snRows.end());
+		m_snRowPtr[s + 1] = (int)m_snRows.size();
+		int nr = m_snRowPtr[s + 1] - n0;
+		if (nr > m_maxRows) m_maxRows = nr;
+
+		if (nr > l - f + 1)
+		{
+			int ps = col2sn[m_snRows[n0 + (l - f + 1)]];
+			snParent[s] = ps;
+			nextChild[s] = headChild[ps];
+			headChild[ps] = s;
+		}
+	}
+
+	// storage of the supernodal blocks
+	m_snVal.assign(nsn + 1, 0);
+	double flops = 0.0;
+	for (int s = 0; s < nsn; ++s)
+	{
+		size_t nc = m_snFirst[s + 1] - m_snFirst[s];
+		size_t nr = m_snRowPtr[s + 1] - m_snRowPtr[s];
+		m_snVal[s + 1] = m_snVal[s] + nc*nr;
+		for (size_t j = 0; j < nc; ++j) flops += (double)(nr - j)*(double)(nr - j);
+	}
+
+	// Each supernode stores the list of descendants that update it, and which
+	// rows of the descendant are involved. This is what allows the supernodes to be
+	// factored independently, once all their descendants are done.
+	m_updPtr.assign(nsn + 1, 0);
+	for (int d = 0; d < nsn; ++d)
+	{
+		int nc = m_snFirst[d + 1] - m_snFirst[d];
+		int t = -1;
+		for (int p = m_snRowPtr[d] + nc; p < m_snRowPtr[d + 1]; ++p)
+		{
+			int ts = col2sn[m_snRows[p]];
+			if (ts != t) { m_updPtr[ts + 1]++; t = ts; }
+		}
+	}
+	for (int s = 0; s < nsn; ++s) m_updPtr[s + 1] += m_updPtr[s];
+	int nupd = m_updPtr[nsn];
+	m_updSn.resize(nupd);
+	m_updRow.resize(nupd);
+	m_updCnt.resize(nupd);
+	vector<int> pos(m_updPtr.begin(), m_updPtr.end() - 1);
+	for (int d = 0; d < nsn; ++d)
+	{
+		int nc = m_snFirst[d + 1] - m_snFirst[d];
+		int t = -1;
+		for (int p = m_snRowPtr[d] + nc; p < m_snRowPtr[d + 1]; ++p)
+		{
+			int ts = col2sn[m_snRows[p]];
+			if (ts != t)
+			{
+				int u = pos[ts]++;
+				m_updSn[u] = d;
+				m_updRow[u] = p - m_snRowPtr[d];
+				m_updCnt[u] = 0;
+				t = ts;
+			}
+			m_updCnt[pos[ts] - 1]++;
+		}
+	}
+
+	// Group the supernodes by their level in the tree. Supernodes on the same level
+	// are independent and can be processed in parallel.
+	vector<int> level(nsn, 0);
+	int nlev = 0;
+	for (int s = 0; s < nsn; ++s)
+	{
+		if (snParent[s] >= 0) level[snParent[s]] = max(level[snParent[s]], level[s] + 1);
+		nlev = max(nlev, level[s] + 1);
+	}
+	m_levPtr.assign(nlev + 1, 0);
+	for (int s = 0; s < nsn; ++s) m_levPtr[level[s] + 1]++;
+	for (int l = 0; l < nlev; ++l) m_levPtr[l + 1] += m_levPtr[l];
+	m_levSn.resize(nsn);
+	pos.assign(m_levPtr.begin(), m_levPtr.end() - 1);
+	for (int s = 0; s < nsn; ++s) m_levSn[pos[level[s]]++] = s;
+
+	// position of each matrix entry in the factor
+	m_map.resize(nnz);
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = Ap[j] - offset; k < Ap[j + 1] - offset; ++k)
+		{
+			int a = iperm[Ai[k] - offset], b = iperm[j];
+			int lo = min(a, b), hi = max(a, b);
+			int s = col2sn[lo];
+			int f = m_snFirst[s], nc = m_snFirst[s + 1] - f;
+			const int* rows = &m_snRows[m_snRowPtr[s]];
+			int nr = m_snRowPtr[s + 1] - m_snRowPtr[s];
+			int i = (hi < f + nc ? hi - f : (int)(lower_bound(rows + nc, rows + nr, hi) - rows));
+			m_map[k] = m_snVal[s] + (size_t)(lo - f)*nr + i;
+		}
+	}
+
+	m_L.resize(m_snVal[nsn]);
+	m_D.resize(n);
+	m_y.resize(n);
+	m_bsymbolic = true;
+
+	if (m_printLevel > 0)
+	{
+		feLog("\tSupernodal factorization:\n");
+		feLog("\t\tNr of supernodes .......................... : %d\n", nsn);
+		feLog("\t\tNr of levels .............................. : %d\n", nlev);
+		feLog("\t\tNr of nonzeroes in factor ................. : %.0lf\n", (double)m_snVal[nsn]);
+		feLog("\t\tFlop count (est.) ......................... : %lg\n", flops);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Apply the updates of all descendants to the columns [j0, j1) of supernode s.
+// An update from descendant d is L_d*D_d*L_d^T, restricted to the rows of d 
+// that are columns of s and the rows below. 
+void SupernodalSolver::UpdateSupernode(int s, int j0, int j1, double* tmp, int* rel)
+{
+	int f = m_snFirst[s];
+	int nc = m_snFirst[s + 1] - f;
+	int nr = m_snRowPtr[s + 1] - m_snRowPtr[s];
+	const int* rows = &m_snRows[m_snRowPtr[s]];
+	double* L = &m_L[m_snVal[s]];
+
+	for (int u = m_updPtr[s]; u < m_updPtr[s + 1]; ++u)
+	{
+		int d = m_updSn[u];
+		int fd = m_snFirst[d];
+		int ncd = m_snFirst[d + 1] - fd;
+		int nrd = m_snRowPtr[d + 1] - m_snRowPtr[d];
+		const int* rowd = &m_snRows[m_snRowPtr[d]];
+		const double* Ld = &m_L[m_snVal[d]];
+		const double* Dd = &m_D[fd];
+
+		// the rows of d that map to the columns [j0, j1) of s
+		int b0 = m_updRow[u], b1 = b0 + m_updCnt[u];
+		while ((b0 < b1) && (rowd[b0] - f < j0)) b0++;
+		while ((b1 > b0) && (rowd[b1 - 1] - f >= j1)) b1--;
+		if (b0 == b1) continue;
+
+		// relative position of the rows of d in s
+		for (int a = b0, q = nc; a < nrd; ++a)
+		{
+			int r = rowd[a];
+			if (r < f + nc) rel[a - b0] = r - f;
+			else
+			{
+				while (rows[q] < r) q++;
+				rel[a - b0] = q;
+			}
+		}
+
+		for (int b = b0; b < b1; ++b)
+		{
+			int m = nrd - b;
+			for (int a = 0; a < m; ++a) tmp[a] = 0.0;
+
+			// the columns of d are processed four at a time
+			int t = 0;
+			for (; t + 3 < ncd; t += 4)
+			{
+				const double* L0 = Ld + (size_t)t*nrd + b;
+				const double* L1 = L0 + nrd;
+				const double* L2 = L1 + nrd;
+				const double* L3 = L2 + nrd;
+				double c0 = L0[0] * Dd[t], c1 = L1[0] * Dd[t + 1], c2 = L2[0] * Dd[t + 2], c3 = L3[0] * Dd[t + 3];
+				for (int a = 0; a < m; ++a) tmp[a] += L0[a] * c0 + L1[a] * c1 + L2[a] * c2 + L3[a] * c3;
+			}
+			for (; t < ncd; ++t)
+			{
+				const double* Lt = Ld + (size_t)t*nrd + b;
+				double c = Lt[0] * Dd[t];
+				for (int a = 0; a < m; ++a) tmp[a] += Lt[a] * c;
+			}
+
+			double* Ls = L + (size_t)(rowd[b] - f)*nr;
+			const int* rb = rel + (b - b0);
+			for (int a = 0; a < m; ++a) Ls[rb[a]] -= tmp[a];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::FactorSupernode(int s, bool bpar, double* tmp, int* rel)
+{
+	int f = m_snFirst[s];
+	int nc = m_snFirst[s + 1] - f;
+	int nr = m_snRowPtr[s + 1] - m_snRowPtr[s];
+	double* L = &m_L[m_snVal[s]];
+	double* D = &m_D[f];
+
+	// updates from the descendants
+	if (bpar)
+	{
+		// the columns are divided in chunks that are processed in parallel
+		const int NCHUNK = 8;
+		int nchunks = (nc + NCHUNK - 1) / NCHUNK;
+#pragma omp parallel
+		{
+			vector<double> tmp(m_maxRows);
+			vector<int> rel(m_maxRows);
+#pragma omp for schedule(dynamic)
+			for (int c = 0; c < nchunks; ++c)
+			{
+				int j0 = c*NCHUNK;
+				int j1 = min(nc, j0 + NCHUNK);
+				UpdateSupernode(s, j0, j1, &tmp[0], &rel[0]);
+			}
+		}
+	}
+	else UpdateSupernode(s, 0, nc, tmp, rel);
+
+	// Factor the supernode's columns. This is a blocked left-looking LDL^T 
+	// factorization of the dense trapezoidal block.
+	const int NB = 64;		// panel width
+	const int RB = 256;		// rows per task in parallel mode
+	for (int p0 = 0; p0 < nc; p0 += NB)
+	{
+		int p1 = min(nc, p0 + NB);
+
+		// update the panel with the previous columns
+		if (p0 > 0)
+		{
+			int nchunks = (bpar ? (nr - p0 + RB - 1) / RB : 1);
+#pragma omp parallel for if (nchunks > 1) schedule(dynamic)
+			for (int c = 0; c < nchunks; ++c)
+			{
+				int i0 = p0 + c*RB;
+				int i1 = (nchunks > 1 ? min(nr, i0 + RB) : nr);
+				for (int k = p0; k < p1; ++k)
+				{
+					double* Lk = L + (size_t)k*nr;
+					int ilo = max(i0, k);
+					int t = 0;
+					for (; t + 3 < p0; t += 4)
+					{
+						const double* L0 = L + (size_t)t*nr;
+						const double* L1 = L0 + nr;
+						const double* L2 = L1 + nr;
+						const double* L3 = L2 + nr;
+						double w0 = D[t] * L0[k], w1 = D[t + 1] * L1[k], w2 = D[t + 2] * L2[k], w3 = D[t + 3] * L3[k];
+						for (int i = ilo; i < i1; ++i) Lk[i] -= L0[i] * w0 + L1[i] * w1 + L2[i] * w2 + L3[i] * w3;
+					}
+					for (; t < p0; ++t)
+					{
+						const double* Lt = L + (size_t)t*nr;
+						double w = D[t] * Lt[k];
+						for (int i = ilo; i < i1; ++i) Lk[i] -= Lt[i] * w;
+					}
+				}
+			}
+		}
+
+		// factor the panel
+		for (int k = p0; k < p1; ++k)
+		{
+			double* Lk = L + (size_t)k*nr;
+			for (int t = p0; t < k; ++t)
+			{
+				const double* Lt = L + (size_t)t*nr;
+				double w = D[t] * Lt[k];
+				if (w == 0.0) continue;
+				for (int i = k; i < nr; ++i) Lk[i] -= Lt[i] * w;
+			}
+
+			double dk = Lk[k];
+			if ((dk == 0.0) || (dk != dk)) return false;
+
+			D[k] = dk;
+			Lk[k] = 1.0;
+			double r = 1.0 / dk;
+			for (int i = k + 1; i < nr; ++i) Lk[i] *= r;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+	int n = m_pA->Rows();
+	if (n == 0) return true;
+	if (m_bsymbolic == false) return false;
+
+	// copy the matrix into the factor
+	int nsn = (int)m_snFirst.size() - 1;
+#pragma omp parallel for schedule(dynamic, 16)
+	for (int s = 0; s < nsn; ++s)
+	{
+		double* L = &m_L[m_snVal[s]];
+		size_t nv = m_snVal[s + 1] - m_snVal[s];
+		for (size_t i = 0; i < nv; ++i) L[i] = 0.0;
+	}
+
+	const double* values = m_pA->Values();
+	int offset = m_pA->Offset();
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = m_Ap[j] - offset; k < m_Ap[j + 1] - offset; ++k) m_L[m_map[k]] = values[k];
+	}
+
+	// Factor the supernodes, level by level. If a level has enough supernodes
+	// they are factored in parallel. Otherwise, the work within the supernodes
+	// is divided over the threads.
+	int nthreads = omp_get_max_threads();
+	int nlev = (int)m_levPtr.size() - 1;
+	int nfail = 0;
+	for (int l = 0; (l < nlev) && (nfail == 0); ++l)
+	{
+		int n0 = m_levPtr[l];
+		int n1 = m_levPtr[l + 1];
+		if ((nthreads == 1) || (n1 - n0 >= nthreads))
+		{
+#pragma omp parallel reduction(+:nfail)
+			{
+				vector<double> tmp(m_maxRows);
+				vector<int> rel(m_maxRows);
+#pragma omp for schedule(dynamic)
+				for (int i = n0; i < n1; ++i)
+				{
+					if (FactorSupernode(m_levSn[i], false, &tmp[0], &rel[0]) == false) nfail++;
+				}
+			}
+		}
+		else
+		{
+			for (int i = n0; (i < n1) && (nfail == 0); ++i)
+			{
+				if (FactorSupernode(m_levSn[i], true, nullptr, nullptr) == false) nfail++;
+			}
+		}
+	}
+
+	if (nfail > 0)
+	{
+		feLogError("Zero pivot encountered during supernodal factorization.");
+		return false;
+	}
+
+	m_isFactored = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Solve L y = b for the columns of supernode s. The contributions of the 
+// descendants are gathered, so that supernodes on the same level can be done 
+// in parallel.
+void SupernodalSolver::ForwardSupernode(int s, double* y)
+{
+	int f = m_snFirst[s];
+	int nc = m_snFirst[s + 1] - f;
+	int nr = m_snRowPtr[s + 1] - m_snRowPtr[s];
+	const double* L = &m_L[m_snVal[s]];
+
+	for (int u = m_updPtr[s]; u < m_updPtr[s + 1]; ++u)
+	{
+		int d = m_updSn[u];
+		int fd = m_snFirst[d];
+		int ncd = m_snFirst[d + 1] - fd;
+		int nrd = m_snRowPtr[d + 1] - m_snRowPtr[d];
+		const int* rowd = &m_snRows[m_snRowPtr[d]];
+		const double* Ld = &m_L[m_snVal[d]];
+		int b0 = m_updRow[u], b1 = b0 + m_updCnt[u];
+		for (int t = 0; t < ncd; ++t)
+		{
+			double yt = y[fd + t];
+			if (yt == 0.0) continue;
+			const double* Lt = Ld + (size_t)t*nrd;
+			for (int b = b0; b < b1; ++b) y[rowd[b]] -= Lt[b] * yt;
+		}
+	}
+
+	for (int k = 0; k < nc; ++k)
+	{
+		double yk = y[f + k];
+		if (yk == 0.0) continue;
+		const double* Lk = L + (size_t)k*nr;
+		for (int i = k + 1; i < nc; ++i) y[f + i] -= Lk[i] * yk;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Solve L^T x = y for the columns of supernode s. The ancestors must be done.
+void SupernodalSolver::BackwardSupernode(int s, double* y)
+{
+	int f = m_snFirst[s];
+	int nc = m_snFirst[s + 1] - f;
+	int nr = m_snRowPtr[s + 1] - m_snRowPtr[s];
+	const int* rows = &m_snRows[m_snRowPtr[s]];
+	const double* L = &m_L[m_snVal[s]];
+
+	for (int k = 0; k < nc; ++k)
+	{
+		const double* Lk = L + (size_t)k*nr;
+		double sum = 0.0;
+		for (int i = nc; i < nr; ++i) sum += Lk[i] * y[rows[i]];
+		y[f + k] -= sum;
+	}
+
+	for (int k = nc - 1; k >= 0; --k)
+	{
+		const double* Lk = L + (size_t)k*nr;
+		double sum = 0.0;
+		for (int i = k + 1; i < nc; ++i) sum += Lk[i] * y[f + i];
+		y[f + k] -= sum;
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::BackSolve(double* x, double* b)
+{
+	if (m_pA == nullptr) return false;
+	int n = m_pA->Rows();
+	if (n == 0) return true;
+	if (m_isFactored == false) return false;
+
+	double* y = &m_y[0];
+	for (int k = 0; k < n; ++k) y[k] = b[m_perm[k]];
+
+	int nlev = (int)m_levPtr.size() - 1;
+	for (int l = 0; l < nlev; ++l)
+	{
+		int n0 = m_levPtr[l];
+		int n1 = m_levPtr[l + 1];
+#pragma omp parallel for if (n1 - n0 > 1) schedule(dynamic)
+		for (int i = n0; i < n1; ++i) ForwardSupernode(m_levSn[i], y);
+	}
+
+	for (int k = 0; k < n; ++k) y[k] /= m_D[k];
+
+	for (int l = nlev - 1; l >= 0; --l)
+	{
+		int n0 = m_levPtr[l];
+		int n1 = m_levPtr[l + 1];
+#pragma omp parallel for if (n1 - n0 > 1) schedule(dynamic)
+		for (int i = n0; i < n1; ++i) BackwardSupernode(m_levSn[i], y);
+	}
+
+	for (int k = 0; k < n; ++k) x[m_perm[k]] = y[k];
+
+	UpdateStats(1);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The symbolic factorization is kept, since the next matrix often has the 
+// same profile.
+void SupernodalSolver::Destroy()
+{
+	m_isFactored = false;
+}
@@ -0,0 +1,106 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/LinearSolver.h>
+#include <FECore/CompactSymmMatrix.h>
+
+//-----------------------------------------------------------------------------
+//! Supernodal sparse LDL^T solver for symmetric matrices.
+
+//! This is a native direct solver that does not depend on any external libraries.
+//! The matrix is reordered (nested dissection or minimum degree) and the columns
+//! of the factor with the same sparsity pattern are grouped into supernodes, 
+//! which are stored as dense blocks. The supernodes are factored in parallel, 
+//! level by level of the supernodal elimination tree. 
+//! The symbolic factorization only depends on the sparsity pattern of the matrix
+//! and is reused as long as the pattern does not change. 
+class SupernodalSolver : public LinearSolver
+{
+public:
+	SupernodalSolver(FEModel* fem);
+	~SupernodalSolver();
+
+	bool PreProcess() override;
+	bool Factor() override;
+	bool BackSolve(double* x, double* y) override;
+	void Destroy() override;
+
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+	bool SetSparseMatrix(SparseMatrix* pA) override;
+
+protected:
+	// symbolic factorization
+	bool Analyze();
+
+	// see if the matrix has the same profile as the one we analyzed
+	bool SameProfile();
+
+	// apply the updates of the descendants of supernode s to its columns j0 to j1
+	void UpdateSupernode(int s, int j0, int j1, double* tmp, int* rel);
+
+	// factor the columns of supernode s. The work arrays are only used in serial mode.
+	bool FactorSupernode(int s, bool bpar, double* tmp, int* rel);
+
+	// forward and backward substitution of supernode s
+	void ForwardSupernode(int s, double* y);
+	void BackwardSupernode(int s, double* y);
+
+protected:
+	CompactSymmMatrix*	m_pA;
+	int		m_ordering;		//!< 0 = natural, 1 = minimum degree, 2 = nested dissection
+	int		m_printLevel;	//!< print level
+	bool	m_isFactored;
+
+	// the profile that was analyzed
+	bool				m_bsymbolic;
+	int					m_neq;
+	std::vector<int>	m_Ap, m_Ai;
+
+	// symbolic factorization
+	std::vector<int>	m_perm;		//!< fill-reducing permutation (new to old)
+	std::vector<int>	m_snFirst;	//!< first column of each supernode
+	std::vector<int>	m_snRowPtr;	//!< start of the row list of each supernode
+	std::vector<int>	m_snRows;	//!< row indices of the supernodes
+	std::vector<size_t>	m_snVal;	//!< start of the values of each supernode
+	std::vector<int>	m_updPtr;	//!< start of the update list of each supernode
+	std::vector<int>	m_updSn;	//!< descendant supernode that updates
+	std::vector<int>	m_updRow;	//!< first row of the update in the descendant
+	std::vector<int>	m_updCnt;	//!< nr of columns that are updated
+	std::vector<int>	m_levPtr;	//!< start of each level of the supernodal tree
+	std::vector<int>	m_levSn;	//!< supernodes sorted by level
+	std::vector<size_t>	m_map;		//!< position of each matrix entry in the factor
+	int					m_maxRows;	//!< largest nr of rows in a supernode
+
+	// numerical factorization
+	std::vector<double>	m_L;		//!< supernodal blocks of the factor (column major)
+	std::vector<double>	m_D;		//!< diagonal
+	std::vector<double>	m_y;		//!< work vector for back solves
+
+	DECLARE_FECORE_CLASS();
+};
@@ -28,8 +28,147 @@ SOFTWARE.*/
 #include <stdarg.h>
 #include <fstream>
 #include <sstream>
+#include <stdint.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
+//=============================================================================
+// Number parsing
+//
+// These functions parse numbers directly from a range of characters, which 
+// need not be null-terminated. They follow the semantics of atoi and atof: 
+// leading whitespace is skipped and parsing stops at the first invalid character.
+// Each returns a pointer past the parsed number, or sz if no number was found.
+//=============================================================================
+
+static inline bool is_digit(char c) { return ((c >= '0') && (c <= '9')); }
+
+static inline const char* skip_space(const char* sz, const char* se)
+{
+	while ((sz < se) && isspace((unsigned char)*sz)) ++sz;
+	return sz;
+}
+
+static const char* parse_int(const char* sz, const char* se, int& v)
+{
+	const char* ch = skip_space(sz, se);
+	bool neg = false;
+	if ((ch < se) && ((*ch == '-') || (*ch == '+'))) { neg = (*ch == '-'); ++ch; }
+	if ((ch >= se) || !is_digit(*ch)) { v = 0; return sz; }
+
+	int n = 0;
+	while ((ch < se) && is_digit(*ch)) n = 10 * n + (*ch++ - '0');
+	v = (neg ? -n : n);
+	return ch;
+}
+
+// Fall back to strtod for numbers that cannot be parsed exactly by parse_double.
+// Since strtod needs a null-terminated string, the number is copied first. The copy
+// covers the whole token (up to the next separator), so long numbers are not truncated.
+static const char* parse_double_slow(const char* sz, const char* se, double& v)
+{
+	const char* te = sz;
+	while ((te < se) && (*te != ',') && !isspace((unsigned char)*te)) ++te;
+	size_t n = (size_t)(te - sz);
+
+	char buf[64];
+	string tmp;
+	char* pc = buf;
+	if (n >= sizeof(buf))
+	{
+		tmp.assign(sz, n);
+		pc = &tmp[0];
+	}
+	else { memcpy(buf, sz, n); buf[n] = 0; }
+
+	char* end = nullptr;
+	v = strtod(pc, &end);
+	return sz + (end - pc);
+}
+
+static const char* parse_double(const char* sz, const char* se, double& v)
+{
+	// powers of ten that can be represented exactly
+	static const double p10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char* s0 = skip_space(sz, se);
+	const char* ch = s0;
+	bool neg = false;
+	if ((ch < se) && ((*ch == '-') || (*ch == '+'))) { neg = (*ch == '-'); ++ch; }
+
+	// read the mantissa
+	uint64_t m = 0;
+	int ndig = 0, e10 = 0;
+	while ((ch < se) && is_digit(*ch)) { m = 10 * m + (*ch++ - '0'); ndig++; }
+	if ((ch < se) && (*ch == '.'))
+	{
+		++ch;
+		while ((ch < se) && is_digit(*ch)) { m = 10 * m + (*ch++ - '0'); ndig++; e10--; }
+	}
+
+	// no digits (e.g. inf, nan) or too many digits to be exact
+	if ((ndig == 0) || (ndig > 19)) return parse_double_slow(s0, se, v);
+
+	// read the exponent
+	if ((ch < se) && ((*ch == 'e') || (*ch == 'E')))
+	{
+		++ch;
+		bool eneg = false;
+		if ((ch < se) && ((*ch == '-') || (*ch == '+'))) { eneg = (*ch == '-'); ++ch; }
+		if ((ch >= se) || !is_digit(*ch)) return parse_double_slow(s0, se, v);
+		int e = 0;
+		while ((ch < se) && is_digit(*ch)) { if (e < 10000) e = 10 * e + (*ch - '0'); ++ch; }
+		e10 += (eneg ? -e : e);
+	}
+
+	// things like hexadecimal numbers are left to strtod
+	if ((ch < se) && (isalpha((unsigned char)*ch) || (*ch == '.'))) return parse_double_slow(s0, se, v);
+
+	// The result is exact (and thus identical to strtod) if the mantissa
+	// and the power of ten are both exactly representable.
+	if (m == 0) v = 0.0;
+	else if ((m <= (uint64_t(1) << 53)) && (e10 >= -22) && (e10 <= 22))
+	{
+		v = (double)m;
+		if (e10 < 0) v /= p10[-e10]; else v *= p10[e10];
+	}
+	else return parse_double_slow(s0, se, v);
+
+	if (neg) v = -v;
+	return ch;
+}
+
+// find the next comma, or return null
+static inline const char* next_comma(const char* sz, const char* se)
+{
+	return (const char*) memchr(sz, ',', se - sz);
+}
+
+// parse a range of the form n0[:n1[:nn]], returning the number of fields read
+// (like sscanf(sz, "%d:%d:%d", ...)).
+static int parse_range(const char* sz, const char* se, int& n0, int& n1, int& nn)
+{
+	const char* ch = parse_int(sz, se, n0);
+	if (ch == sz) return 0;
+	if ((ch >= se) || (*ch != ':')) return 1;
+
+	const char* c1 = parse_int(ch + 1, se, n1);
+	if (c1 == ch + 1) return 1;
+	if ((c1 >= se) || (*c1 != ':')) return 2;
+
+	const char* c2 = parse_int(c1 + 1, se, nn);
+	return (c2 == c1 + 1 ? 2 : 3);
+}
+
 //=============================================================================
 // XMLAtt
 //=============================================================================
@@ -57,12 +196,14 @@ bool XMLAtt::operator != (const char* szval)
 int XMLAtt::value(int* v, int n)
 {
 	const char* sz = m_val.c_str();
+	const char* se = sz + m_val.size();
 	int nr = 0;
 	for (int i = 0; i < n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
-		v[i] = atoi(sz);
+		sz = parse_int(sz, se, v[i]);
 		nr++;
+
+		const char* sze = next_comma(sz, se);
 		if (sze) sz = sze + 1;
 		else break;
 	}
@@ -72,14 +213,14 @@ int XMLAtt::value(int* v, int n)
 int XMLAtt::value(double* pf, int n)
 {
 	const char* sz = m_val.c_str();
+	const char* se = sz + m_val.size();
 	int nr = 0;
 	for (int i = 0; i < n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
-
-		pf[i] = atof(sz);
+		sz = parse_double(sz, se, pf[i]);
 		nr++;
 
+		const char* sze = next_comma(sz, se);
 		if (sze) sz = sze + 1;
 		else break;
 	}
@@ -94,6 +235,7 @@ int XMLAtt::value(double* pf, int n)
 XMLTag::XMLTag()
 {
 	m_preader = 0;
+	m_bview = false;
 	m_bend = false;
 	m_bleaf = true;
 	m_bempty = false;
@@ -105,6 +247,7 @@ void XMLTag::clear()
 {
 	m_sztag.clear();
 	m_szval.clear();
+	m_bview = false;
 	m_att.clear();
 //	m_path.clear(); // NOTE: Do not clear the path!
 	m_bend = false;
@@ -112,6 +255,37 @@ void XMLTag::clear()
 	m_bempty = false;
 }
 
+//-----------------------------------------------------------------------------
+//! Returns the value of the tag. If the value is still referenced in the input
+//! buffer, it is copied first. Line breaks and tabs are replaced by spaces.
+const std::string& XMLTag::str()
+{
+	if (m_bview)
+	{
+		m_szval.clear();
+		m_szval.reserve(m_view.size());
+		for (const char* ch = m_view.begin(); ch != m_view.end(); ++ch)
+		{
+			if (*ch != '\r')
+			{
+				if ((*ch != '\n') && (*ch != '\t'))
+					m_szval.push_back(*ch);
+				else
+					m_szval.push_back(' ');
+			}
+		}
+		m_bview = false;
+	}
+	return m_szval;
+}
+
+//-----------------------------------------------------------------------------
+XMLStringView XMLTag::view() const
+{
+	if (m_bview) return m_view;
+	else return XMLStringView(m_szval.c_str(), m_szval.size());
+}
+
 //-----------------------------------------------------------------------------
 std::string XMLTag::relpath(const char* szroot) const
 {
@@ -150,36 +324,59 @@ std::string XMLTag::relpath(const char* szroot) const
 //!
 int XMLTag::value(double* pf, int n)
 {
-	const char* sz = m_szval.c_str();
+	XMLStringView v = view();
+	const char* sz = v.begin();
+	const char* se = v.end();
 	int nr = 0;
 	for (int i=0; i<n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
-
-		pf[i] = atof(sz);
+		sz = parse_double(sz, se, pf[i]);
 		nr++;
 
+		const char* sze = next_comma(sz, se);
 		if (sze) sz = sze+1;
 		else break;
 	}
 	return nr;
 }
 
+//-----------------------------------------------------------------------------
+int XMLTag::scan(double* pf, int n)
+{
+	XMLStringView v = view();
+	const char* sz = v.begin();
+	const char* se = v.end();
+	int nr = 0;
+	for (int i = 0; i<n; ++i)
+	{
+		const char* ch = parse_double(sz, se, pf[i]);
+		if (ch == sz) break;
+		nr++;
+
+		if ((ch < se) && (*ch == ',')) sz = ch + 1;
+		else break;
+	}
+	return nr;
+}
+
 //-----------------------------------------------------------------------------
 //! This function reads in a comma delimited list of floats. The function reads
 //! in a maximum of n values. The actual number of values that are read is returned.
 //!
 int XMLTag::value(float* pf, int n)
 {
-	const char* sz = m_szval.c_str();
+	XMLStringView v = view();
+	const char* sz = v.begin();
+	const char* se = v.end();
 	int nr = 0;
 	for (int i=0; i<n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
-
-		pf[i] = (float) atof(sz);
+		double d;
+		sz = parse_double(sz, se, d);
+		pf[i] = (float) d;
 		nr++;
 
+		const char* sze = next_comma(sz, se);
 		if (sze) sz = sze+1;
 		else break;
 	}
@@ -192,15 +389,16 @@ int XMLTag::value(float* pf, int n)
 //!
 int XMLTag::value(int* pi, int n)
 {
-	const char* sz = m_szval.c_str();
+	XMLStringView v = view();
+	const char* sz = v.begin();
+	const char* se = v.end();
 	int nr = 0;
 	for (int i=0; i<n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
-
-		pi[i] = atoi(sz);
+		sz = parse_int(sz, se, pi[i]);
 		nr++;
 
+		const char* sze = next_comma(sz, se);
 		if (sze) sz = sze+1;
 		else break;
 	}
@@ -214,7 +412,7 @@ int XMLTag::value(std::vector<string>& stringList, int n)
 
 	char tmp[256] = { 0 };
 
-	const char* sz = m_szval.c_str();
+	const char* sz = szvalue();
 	int nr = 0;
 	for (int i = 0; i<n; ++i)
 	{
@@ -243,7 +441,7 @@ void XMLTag::value(std::vector<string>& stringList)
 
 	char tmp[256] = { 0 };
 
-	const char* sz = m_szval.c_str();
+	const char* sz = szvalue();
 	while (sz && *sz)
 	{
 		const char* sze = strchr(sz, ',');
@@ -266,36 +464,37 @@ void XMLTag::value(std::vector<string>& stringList)
 void XMLTag::value(bool& val)
 { 
 	int n=0; 
-	sscanf(m_szval.c_str(), "%d", &n); 
+	sscanf(szvalue(), "%d", &n); 
 	val = (n != 0); 
 }
 
 //-----------------------------------------------------------------------------
 void XMLTag::value(char* szstr)
 {
-	strcpy(szstr, m_szval.c_str()); 
+	strcpy(szstr, szvalue()); 
 }
 
 //-----------------------------------------------------------------------------
 void XMLTag::value(std::string& val)
 {
-	val = m_szval;
+	val = str();
 }
 
 //-----------------------------------------------------------------------------
 void XMLTag::value(vector<int>& l)
 {
-	int i, n = 0, n0, n1, nn;
-	char* szval = strdup(m_szval.c_str());
-	char* ch;
-	char* sz = szval;
-	int nread;
-	do
+	// NOTE: l is only modified if the list is not empty
+	XMLStringView v = view();
+	const char* sz = v.begin();
+	const char* se = v.end();
+	int n = 0;
+	while (true)
 	{
-		ch = strchr(sz, ',');
-		if (ch) *ch = 0;
-		nread = sscanf(sz, "%d:%d:%d", &n0, &n1, &nn);
-		switch (nread)
+		const char* ch = next_comma(sz, se);
+		const char* te = (ch ? ch : se);
+
+		int n0, n1, nn;
+		switch (parse_range(sz, te, n0, n1, nn))
 		{
 		case 1:
 			n1 = n0;
@@ -312,72 +511,40 @@ void XMLTag::value(vector<int>& l)
 			nn = 1;
 		}
 
-		for (i=n0; i<=n1; i += nn) ++n;
-
-		if (ch) *ch = ',';
-		sz = ch+1;
-	}
-	while (ch != 0);
-
-	if (n != 0)
-	{
-		l.resize(n);
-
-		sz = szval;
-		n = 0;
-		do
+		for (int i=n0; i<=n1; i += nn)
 		{
-			ch = strchr(sz, ',');
-			if (ch) *ch = 0;
-			nread = sscanf(sz, "%d:%d:%d", &n0, &n1, &nn);
-			switch (nread)
-			{
-			case 1:
-				n1 = n0;
-				nn = 1;
-				break;
-			case 2:
-				nn = 1;
-				break;
-			case 3:
-				break;
-			default:
-				n0 = 0;
-				n1 = -1;
-				nn = 1;
-			}
-
-			for (i=n0; i<=n1; i += nn) l[n++] = i;
-			assert(n <= (int) l.size());
-
-			if (ch) *ch = ',';
-			sz = ch+1;
+			if (n == 0) l.clear();
+			l.push_back(i);
+			++n;
 		}
-		while (ch != 0);
-	}
 
-	free(szval);
+		if (ch == nullptr) break;
+		sz = ch + 1;
+	}
 }
 
 //-----------------------------------------------------------------------------
 void XMLTag::value(vector<double>& l)
 {
 	l.clear();
-	const char *sz = m_szval.c_str();
-	while (sz && *sz)
+	XMLStringView vs = view();
+	const char* sz = vs.begin();
+	const char* se = vs.end();
+	while (sz < se)
 	{
 		// skip space
-		while (isspace(*sz)) ++sz;
+		sz = skip_space(sz, se);
 
 		// read the value
-		if (sz && *sz)
+		if (sz < se)
 		{
-			double v = atof(sz);
+			double v;
+			sz = parse_double(sz, se, v);
 			l.push_back(v);
 
 			// find next space or comma
-			while (*sz && (*sz != ' ') && (*sz != ',')) sz++;
-			if (*sz == ',') sz++;
+			while ((sz < se) && !isspace((unsigned char)*sz) && (*sz != ',')) sz++;
+			if ((sz < se) && (*sz == ',')) sz++;
 		}
 	}
 }
@@ -385,21 +552,24 @@ void XMLTag::value(vector<double>& l)
 void XMLTag::value2(std::vector<int>& l)
 {
 	l.clear();
-	const char* sz = m_szval.c_str();
-	while (sz && *sz)
+	XMLStringView vs = view();
+	const char* sz = vs.begin();
+	const char* se = vs.end();
+	while (sz < se)
 	{
 		// skip space
-		while (isspace(*sz)) ++sz;
+		sz = skip_space(sz, se);
 
 		// read the value
-		if (sz && *sz)
+		if (sz < se)
 		{
-			int v = (int)atoi(sz);
+			int v;
+			sz = parse_int(sz, se, v);
 			l.push_back(v);
 
 			// find next space or comma
-			while (*sz && (*sz != ' ') && (*sz != ',')) sz++;
-			if (*sz == ',') sz++;
+			while ((sz < se) && !isspace((unsigned char)*sz) && (*sz != ',')) sz++;
+			if ((sz < se) && (*sz == ',')) sz++;
 		}
 	}
 }
@@ -560,6 +730,91 @@ XMLReader::Error(tag, format_string("missing attribute \"%s\"", sza)) {}
 XMLReader::MissingTag::MissingTag(XMLTag& tag, const char* sza) : \
 XMLReader::Error(tag, format_string("missing tag \"%s\"", sza)) {}
 
+//=============================================================================
+// XMLFileMap
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+//! Maps a file (read-only) into memory.
+class XMLFileMap
+{
+public:
+	XMLFileMap() : m_data(nullptr), m_size(0)
+	{
+#ifdef WIN32
+		m_file = INVALID_HANDLE_VALUE;
+		m_mapping = NULL;
+#else
+		m_fd = -1;
+#endif
+	}
+
+	~XMLFileMap() { Close(); }
+
+	bool Open(const char* szfile)
+	{
+#ifdef WIN32
+		m_file = CreateFileA(szfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (m_file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_file, &size) || (size.QuadPart == 0)) { Close(); return false; }
+		m_size = (int64_t)size.QuadPart;
+
+		m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (m_mapping == NULL) { Close(); return false; }
+
+		m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+		if (m_data == nullptr) { Close(); return false; }
+#else
+		m_fd = open(szfile, O_RDONLY);
+		if (m_fd < 0) return false;
+
+		struct stat st;
+		if ((fstat(m_fd, &st) != 0) || (st.st_size == 0)) { Close(); return false; }
+		m_size = (int64_t)st.st_size;
+
+		void* p = mmap(nullptr, (size_t)m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+		if (p == MAP_FAILED) { Close(); return false; }
+		m_data = (const char*)p;
+
+		// we read the file front to back
+		madvise(p, (size_t)m_size, MADV_SEQUENTIAL);
+#endif
+		return true;
+	}
+
+	void Close()
+	{
+#ifdef WIN32
+		if (m_data) UnmapViewOfFile(m_data);
+		if (m_mapping != NULL) CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+		m_mapping = NULL;
+		m_file = INVALID_HANDLE_VALUE;
+#else
+		if (m_data) munmap((void*)m_data, (size_t)m_size);
+		if (m_fd >= 0) close(m_fd);
+		m_fd = -1;
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	const char* Data() const { return m_data; }
+	int64_t Size() const { return m_size; }
+
+private:
+	const char*	m_data;
+	int64_t		m_size;
+#ifdef WIN32
+	HANDLE	m_file;
+	HANDLE	m_mapping;
+#else
+	int		m_fd;
+#endif
+};
+
 //=============================================================================
 // XMLReader
 //=============================================================================
@@ -574,6 +829,9 @@ XMLReader::XMLReader()
 	m_eof = false;
 	m_currentPos = 0;
 	m_buf = new char[BUF_SIZE];
+	m_data = m_buf;
+	m_map = nullptr;
+	m_buseMap = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -598,6 +856,13 @@ void XMLReader::Close()
         m_stream = nullptr;
     }
 
+	if (m_map)
+	{
+		delete m_map;
+		m_map = nullptr;
+	}
+	m_data = m_buf;
+
 	m_nline = 0;
 	m_bufIndex = 0;
 	m_bufSize = 0;
@@ -609,28 +874,39 @@ void XMLReader::Close()
 bool XMLReader::Open(const char* szfile, bool checkForXMLTag)
 {
 	// make sure this reader has not been attached to a file yet
-    if(m_stream) return false;
+    if(m_stream || m_map) return false;
+
+	// try to map the file into memory first
+	if (m_buseMap)
+	{
+		m_map = new XMLFileMap;
+		if (m_map->Open(szfile))
+		{
+			// the whole file is now the buffer
+			m_data = m_map->Data();
+			m_bufSize = m_map->Size();
+			m_bufIndex = 0;
+			m_eof = true;
+			m_currentPos = 0;
+
+			// make sure this is an xml file
+			if (checkForXMLTag && !checkXMLTag()) return false;
+
+			return true;
+		}
+
+		// if this failed, we'll read the file as a stream
+		delete m_map;
+		m_map = nullptr;
+	}
 
 	// open the file
     m_stream = new ifstream;
     static_cast<ifstream*>(m_stream)->open(szfile, ifstream::in|ifstream::binary);
     if(m_stream->fail()) return false;
 
-
 	// read the first line
-	if (checkForXMLTag)
-	{
-		char szline[256] = { 0 };
-		// fgets(szline, 255, m_fp);
-        m_stream->get(szline, 255);
-
-		// make sure it is correct
-		if (strncmp(szline, "<?xml", 5) != 0)
-		{
-			// This file is not an XML file
-			return false;
-		}
-	}
+	if (checkForXMLTag && !checkXMLTag()) return false;
 
 	m_currentPos = 0;
 
@@ -638,29 +914,35 @@ bool XMLReader::Open(const char* szfile, bool checkForXMLTag)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! make sure the input starts with the xml header
+bool XMLReader::checkXMLTag()
+{
+	if (m_map)
+	{
+		return ((m_bufSize >= 5) && (strncmp(m_data, "<?xml", 5) == 0));
+	}
+	else
+	{
+		char szline[256] = { 0 };
+		m_stream->get(szline, 255);
+
+		// make sure it is correct
+		return (strncmp(szline, "<?xml", 5) == 0);
+	}
+}
+
 bool XMLReader::OpenString(std::string& xml, bool checkForXMLTag)
 {
     // make sure this we don't already have a stream
-    if(m_stream) return false;
+    if(m_stream || m_map) return false;
 
     // create string stream
     m_stream = new std::istringstream(xml);
     if(m_stream->fail()) return false;
 
     // read the first line
-	if (checkForXMLTag)
-	{
-		char szline[256] = { 0 };
-		// fgets(szline, 255, m_fp);
-        m_stream->get(szline, 255);
-
-		// make sure it is correct
-		if (strncmp(szline, "<?xml", 5) != 0)
-		{
-			// This file is not an XML file
-			return false;
-		}
-	}
+	if (checkForXMLTag && !checkXMLTag()) return false;
 
 	m_currentPos = 0;
 
@@ -782,10 +1064,7 @@ private:
 bool XMLReader::FindTag(const char* xpath, XMLTag& tag)
 {
 	// go to the beginning of the file
-    m_stream->seekg(0, ios_base::beg);
-	m_bufIndex = m_bufSize = 0;
-	m_currentPos = 0;
-	m_eof = false;
+	seek(0);
 
 	// set the first tag
 	tag.m_preader = this;
@@ -836,13 +1115,7 @@ void XMLReader::NextTag(XMLTag& tag)
 	m_nline = tag.m_ncurrent_line;
 
 	// set the current file position
-	if (m_currentPos != tag.m_fpos)
-	{
-        m_stream->seekg(tag.m_fpos, ios_base::beg);
-		m_currentPos = tag.m_fpos;
-		m_bufSize = m_bufIndex = 0;
-		m_eof = false;
-	}
+	if (m_currentPos != tag.m_fpos) seek(tag.m_fpos);
 
 	// update the path
 	if (!tag.isend() && !tag.isempty() && !tag.isleaf())
@@ -974,7 +1247,7 @@ void XMLReader::ReadTag(XMLTag& tag)
 		att.m_bvisited = false;
 
 		++n;
-		tag.m_att.push_back(att);
+		tag.m_att.push_back(std::move(att));
 	}
 }
 
@@ -982,6 +1255,35 @@ void XMLReader::ReadTag(XMLTag& tag)
 void XMLReader::ReadValue(XMLTag& tag)
 {
 	char ch;
+
+	// When the file is mapped, the value can be referenced directly in the buffer, 
+	// unless it contains comments or entity references.
+	if (m_map && !tag.isend())
+	{
+		const char* sz = m_data + m_bufIndex;
+		const char* se = m_data + m_bufSize;
+		const char* c = sz;
+		int nl = 0;
+		while ((c < se) && (*c != '<') && (*c != '&'))
+		{
+			if (*c == '\n') nl++;
+			++c;
+		}
+
+		if ((c + 1 < se) && (*c == '<') && (c[1] != '!'))
+		{
+			tag.m_view = XMLStringView(sz, c - sz);
+			tag.m_bview = true;
+
+			// skip past the '<' of the next tag
+			int64_t n = (c - sz) + 1;
+			m_bufIndex += n;
+			m_currentPos += n;
+			m_nline += nl;
+			return;
+		}
+	}
+
 	if (!tag.isend())
 	{
 		tag.m_szval.clear();
@@ -1073,7 +1375,7 @@ char XMLReader::readNextChar()
         m_eof = (m_bufSize != BUF_SIZE);
 	}
 	m_currentPos++;
-	char ch = m_buf[m_bufIndex++];
+	char ch = m_data[m_bufIndex++];
 	if (ch == '\n') m_nline++;
 	return ch;
 }
@@ -1100,6 +1402,24 @@ void XMLReader::rewind(int64_t nstep)
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! set the file position
+void XMLReader::seek(int64_t pos)
+{
+	if (m_map)
+	{
+		// the entire file is in the buffer
+		m_bufIndex = pos;
+	}
+	else
+	{
+		m_stream->seekg(pos, ios_base::beg);
+		m_bufSize = m_bufIndex = 0;
+		m_eof = false;
+	}
+	m_currentPos = pos;
+}
+
 // clean the string by removing whitespace at the front and back
 void clean_string(string& s)
 {
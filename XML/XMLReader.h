@@ -39,6 +39,27 @@ SOFTWARE.*/
 //-------------------------------------------------------------------------
 // forward declaration
 class XMLReader;
+class XMLFileMap;
+
+//-------------------------------------------------------------------------
+//! A non-owning view of a range of characters. This is used to refer to the
+//! value of a tag directly in the (memory-mapped) input buffer, without copying it.
+//! (std::string_view requires C++17, hence this minimal replacement.)
+class XMLStringView
+{
+public:
+	XMLStringView() : m_sz(nullptr), m_n(0) {}
+	XMLStringView(const char* sz, size_t n) : m_sz(sz), m_n(n) {}
+
+	const char* begin() const { return m_sz; }
+	const char* end() const { return m_sz + m_n; }
+	size_t size() const { return m_n; }
+	bool empty() const { return (m_n == 0); }
+
+private:
+	const char*	m_sz;
+	size_t		m_n;
+};
 
 //-------------------------------------------------------------------------
 //! This class represents a xml-attribute
@@ -84,7 +105,9 @@ class XMLTag
 {
 public:
 	std::string	m_sztag;			// tag name
-	std::string m_szval;				// tag value
+	std::string m_szval;				// tag value (see str())
+	XMLStringView	m_view;				// tag value as a slice of the input buffer (only valid if m_bview is set)
+	bool			m_bview;			// the value has not been copied to m_szval yet
 
 	std::vector<XMLAtt>	m_att;				// attribute list
 
@@ -131,11 +154,11 @@ public:
 		
 	const char* Name() { return m_sztag.c_str(); }
 
-	void value(double& val) { val = atof(m_szval.c_str()); } 
-	void value(float& val)  { val = (float) atof(m_szval.c_str()); }
-	void value(int& val) { val = atoi(m_szval.c_str()); }
-	void value(long& val) { val = (long) atoi(m_szval.c_str()); }
-	void value(short& val) { val = (short) atoi(m_szval.c_str()); }
+	void value(double& val) { val = atof(szvalue()); } 
+	void value(float& val)  { val = (float) atof(szvalue()); }
+	void value(int& val) { val = atoi(szvalue()); }
+	void value(long& val) { val = (long) atoi(szvalue()); }
+	void value(short& val) { val = (short) atoi(szvalue()); }
 	int value(double* pf, int n);
 	int value(float* pf, int n);
 	int value(int* pi, int n);
@@ -148,9 +171,21 @@ public:
 	void value2(std::vector<int>& l);
 	void value(std::vector<double>& l);
 
+	//! Reads up to n comma-separated numbers, stopping at the first entry that
+	//! is not a number (i.e. like sscanf with "%lg,%lg,..."). Returns the number of values read.
+	int scan(double* pf, int n);
+
 	template <class T> void value(T& v);
 
-	const char* szvalue() { return m_szval.c_str(); }
+	//! The tag's value as a null-terminated string
+	const char* szvalue() { return str().c_str(); }
+
+	//! The tag's value as a string. 
+	const std::string& str();
+
+	//! The tag's (unprocessed) value. This does not copy the value, but note 
+	//! that it may contain tabs and line breaks.
+	XMLStringView view() const;
 
 	std::string relpath(const char* szroot) const;
 
@@ -269,6 +304,10 @@ public:
 	//! Open the xml file
 	bool Open(const char* szfile, bool checkForXMLTag = true);
 
+	//! Read files through a memory map instead of a file stream (default is on).
+	//! This must be set before the file is opened.
+	void SetMemoryMapped(bool b) { m_buseMap = b; }
+
     //! Pass xml formatted string to reader
     bool OpenString(std::string& xml, bool checkForXMLTag = true);
 
@@ -312,6 +351,12 @@ protected: // helper functions
 	//! move the file pointer
     void rewind(int64_t nstep);
 
+	//! set the file position
+	void seek(int64_t pos);
+
+	//! check the xml header
+	bool checkXMLTag();
+
 	// only used for processing comments
 	char GetNextChar();
 	
@@ -326,6 +371,10 @@ protected:
 	char*		m_buf;
     int64_t    m_bufIndex, m_bufSize;
 	bool		m_eof;
+
+	const char*	m_data;		//!< data that is being parsed (either m_buf or the memory-mapped file)
+	XMLFileMap*	m_map;		//!< file mapping (or null if the file is read through m_stream)
+	bool		m_buseMap;	//!< try to use a memory map when opening files
 };
 
 //-----------------------------------------------------------------------------
@@ -339,4 +388,4 @@ inline const std::string& XMLTag::comment() { return m_preader->GetLastComment()
 //-----------------------------------------------------------------------------
 // mechanism for using custom types with XMLReader. 
 template <class T> void string_to_type(const std::string& s, T& v) { assert(false); }
-template <class T> void XMLTag::value(T& v) { string_to_type(m_szval, v); }
+template <class T> void XMLTag::value(T& v) { string_to_type(str(), v); }